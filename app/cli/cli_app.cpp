@@ -1,6 +1,8 @@
 #include "cli_app.hpp"
 #include "vertex/application/exchange.hpp"
 #include <cassert>
+#include <string>
+#include <utility>
 
 namespace vertex::cli
 {
@@ -12,6 +14,22 @@ namespace vertex::cli
     template <class... Ts>
     Overloaded(Ts...) -> Overloaded<Ts...>;
 
+    namespace
+    {
+        std::pair<std::string, std::string> split_market(std::string_view market)
+        {
+            auto slash_it = market.find('/');
+            auto second_slash = market.find('/', slash_it == std::string_view::npos ? 0 : slash_it + 1);
+
+            assert(slash_it != std::string_view::npos && "Invariant violated: parser must provide market as <base>/<quote>");
+            assert(slash_it > 0 && "Invariant violated: market base asset must be non-empty");
+            assert(slash_it + 1 < market.size() && "Invariant violated: market quote asset must be non-empty");
+            assert(second_slash == std::string_view::npos && "Invariant violated: market must contain exactly one slash");
+
+            return {std::string(market.substr(0, slash_it)), std::string(market.substr(slash_it + 1))};
+        }
+    } // namespace
+
     DispatchResult CliApp::create_user(const CreateUser &cmd)
     {
         auto result = exchange_.create_user(cmd.name);
@@ -24,10 +42,6 @@ namespace vertex::cli
                 return AppError{.code = AppErrorCode::EmptyName,
                                 .message = "Empty user name"};
 
-            case UserError::UserAlreadyExists:
-                return AppError{.code = AppErrorCode::UserAlreadyExists,
-                                .message = "User already exists"};
-
             default:
                 return AppError{.code = AppErrorCode::InternalError,
                                 .message = "Internal error"};
@@ -67,9 +81,12 @@ namespace vertex::cli
     {
 
         UserId user_id{cmd.user_id};
-        Asset asset{cmd.asset};
+        auto asset = Asset::intern(cmd.asset);
+        if (!asset)
+            return AppError{.code = AppErrorCode::AssetRegistryFull,
+                            .message = "Asset registry is full"};
 
-        auto result = exchange_.deposit(user_id, asset, cmd.quantity);
+        auto result = exchange_.deposit(user_id, *asset, cmd.quantity);
 
         if (!result)
         {
@@ -84,6 +101,10 @@ namespace vertex::cli
                 return AppError{.code = AppErrorCode::InvalidQuantity,
                                 .message = "Invalid quantity"};
 
+            case WalletOperationError::BalanceOverflow:
+                return AppError{.code = AppErrorCode::AmountOverflow,
+                                .message = "Balance would overflow"};
+
             default:
                 return AppError{.code = AppErrorCode::InternalError,
                                 .message = "Internal error"};
@@ -99,9 +120,18 @@ namespace vertex::cli
     {
 
         UserId user_id{cmd.user_id};
-        Asset asset{cmd.asset};
+        // An asset nobody ever deposited has no balance to withdraw.
+        const auto asset = Asset::find(cmd.asset);
+        if (!asset)
+        {
+            if (!exchange_.user_exists(user_id))
+                return AppError{.code = AppErrorCode::UserNotFound,
+                                .message = "User not found"};
+            return AppError{.code = AppErrorCode::InsufficientFunds,
+                            .message = "Insufficient funds"};
+        }
 
-        auto result = exchange_.withdraw(user_id, asset, cmd.quantity);
+        auto result = exchange_.withdraw(user_id, *asset, cmd.quantity);
 
         if (!result)
         {
@@ -135,9 +165,12 @@ namespace vertex::cli
     {
 
         UserId user_id{cmd.user_id};
-        Asset asset{cmd.asset};
+        const auto asset = Asset::find(cmd.asset);
 
-        auto result = exchange_.free_balance(user_id, asset);
+        auto result = asset ? exchange_.free_balance(user_id, *asset)
+                            : (exchange_.user_exists(user_id)
+                                   ? std::expected<vertex::core::Quantity, WalletOperationError>{0}
+                                   : std::unexpected(WalletOperationError::UserNotFound));
 
         if (!result)
         {
@@ -163,9 +196,12 @@ namespace vertex::cli
     {
 
         UserId user_id{cmd.user_id};
-        Asset asset{cmd.asset};
+        const auto asset = Asset::find(cmd.asset);
 
-        auto result = exchange_.reserved_balance(user_id, asset);
+        auto result = asset ? exchange_.reserved_balance(user_id, *asset)
+                            : (exchange_.user_exists(user_id)
+                                   ? std::expected<vertex::core::Quantity, WalletOperationError>{0}
+                                   : std::unexpected(WalletOperationError::UserNotFound));
 
         if (!result)
         {
@@ -190,10 +226,13 @@ namespace vertex::cli
     DispatchResult CliApp::place_limit_order(const PlaceLimitOrder &cmd)
     {
         UserId user_id{cmd.user_id};
-        Market market = parse_market(cmd.market);
+        const auto market = find_market(cmd.market);
+        if (!market)
+            return AppError{.code = AppErrorCode::MarketNotListed,
+                            .message = "Market not listed"};
         Side side = parse_side(cmd.side);
 
-        auto result = exchange_.place_limit_order(user_id, market, side, cmd.price, cmd.quantity);
+        auto result = exchange_.place_limit_order(user_id, *market, side, cmd.price, cmd.quantity);
 
         if (!result)
         {
@@ -216,6 +255,26 @@ namespace vertex::cli
                 return AppError{.code = AppErrorCode::InvalidAmount,
                                 .message = "Invalid amount"};
 
+            case PlaceOrderError::NotionalOverflow:
+                return AppError{.code = AppErrorCode::AmountOverflow,
+                                .message = "Order notional overflows"};
+
+            case PlaceOrderError::PriceOutOfBand:
+                return AppError{.code = AppErrorCode::InvalidAmount,
+                                .message = "Price outside market band"};
+
+            case PlaceOrderError::PriceNotOnTick:
+                return AppError{.code = AppErrorCode::InvalidAmount,
+                                .message = "Price not on market tick"};
+
+            case PlaceOrderError::QuantityNotOnLot:
+                return AppError{.code = AppErrorCode::InvalidQuantity,
+                                .message = "Quantity not on market lot"};
+
+            case PlaceOrderError::Overloaded:
+                return AppError{.code = AppErrorCode::MarketBusy,
+                                .message = "Market busy, retry later"};
+
             case PlaceOrderError::InsufficientFunds:
                 return AppError{.code = AppErrorCode::InsufficientFunds,
                                 .message = "Insufficient funds"};
@@ -234,10 +293,13 @@ namespace vertex::cli
     DispatchResult CliApp::execute_market_order(const ExecuteMarketOrder &cmd)
     {
         UserId user_id{cmd.user_id};
-        Market market = parse_market(cmd.market);
+        const auto market = find_market(cmd.market);
+        if (!market)
+            return AppError{.code = AppErrorCode::MarketNotListed,
+                            .message = "Market not listed"};
         Side side = parse_side(cmd.side);
 
-        auto result = exchange_.execute_market_order(user_id, market, side, cmd.quantity);
+        auto result = exchange_.execute_market_order(user_id, *market, side, cmd.quantity);
 
         if (!result)
         {
@@ -256,10 +318,30 @@ namespace vertex::cli
                 return AppError{.code = AppErrorCode::InvalidQuantity,
                                 .message = "Invalid quantity"};
 
+            case PlaceOrderError::InvalidAmount:
+                return AppError{.code = AppErrorCode::InvalidAmount,
+                                .message = "Invalid amount"};
+
+            case PlaceOrderError::NotionalOverflow:
+                return AppError{.code = AppErrorCode::AmountOverflow,
+                                .message = "Order notional overflows"};
+
             case PlaceOrderError::InsufficientFunds:
                 return AppError{.code = AppErrorCode::InsufficientFunds,
                                 .message = "Insufficient funds"};
 
+            case PlaceOrderError::PriceNotOnTick:
+                return AppError{.code = AppErrorCode::InvalidAmount,
+                                .message = "Price not on market tick"};
+
+            case PlaceOrderError::QuantityNotOnLot:
+                return AppError{.code = AppErrorCode::InvalidQuantity,
+                                .message = "Quantity not on market lot"};
+
+            case PlaceOrderError::Overloaded:
+                return AppError{.code = AppErrorCode::MarketBusy,
+                                .message = "Market busy, retry later"};
+
             default:
                 return AppError{.code = AppErrorCode::InternalError,
                                 .message = "Internal error"};
@@ -309,9 +391,11 @@ namespace vertex::cli
     DispatchResult CliApp::register_market(const RegisterMarket &cmd)
     {
 
-        Market market = parse_market(cmd.market);
+        const auto market = intern_market(cmd.market);
+        if (!market)
+            return market.error();
 
-        auto result = exchange_.register_market(market);
+        auto result = exchange_.register_market(*market);
 
         if (!result)
         {
@@ -387,20 +471,27 @@ namespace vertex::cli
             command);
     }
 
-    Market CliApp::parse_market(std::string_view market)
+    std::optional<Market> CliApp::find_market(std::string_view market)
     {
-        auto slash_it = market.find('/');
-        auto second_slash = market.find('/', slash_it == std::string_view::npos ? 0 : slash_it + 1);
-
-        assert(slash_it != std::string_view::npos && "Invariant violated: parser must provide market as <base>/<quote>");
-        assert(slash_it > 0 && "Invariant violated: market base asset must be non-empty");
-        assert(slash_it + 1 < market.size() && "Invariant violated: market quote asset must be non-empty");
-        assert(second_slash == std::string_view::npos && "Invariant violated: market must contain exactly one slash");
+        auto [base_name, quote_name] = split_market(market);
+        auto base = Asset::find(std::move(base_name));
+        auto quote = Asset::find(std::move(quote_name));
+        if (!base || !quote)
+            return std::nullopt;
 
-        auto base = market.substr(0, slash_it);
-        auto quote = market.substr(slash_it + 1);
+        return Market{*base, *quote};
+    }
 
-        return Market{Asset{std::string(base)}, Asset{std::string(quote)}};
+    std::expected<Market, AppError> CliApp::intern_market(std::string_view market)
+    {
+        auto [base_name, quote_name] = split_market(market);
+        auto base = Asset::intern(std::move(base_name));
+        auto quote = Asset::intern(std::move(quote_name));
+        if (!base || !quote)
+            return std::unexpected(AppError{.code = AppErrorCode::AssetRegistryFull,
+                                            .message = "Asset registry is full"});
+
+        return Market{*base, *quote};
     }
 
     Side CliApp::parse_side(std::string_view side)
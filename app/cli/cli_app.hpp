@@ -1,4 +1,7 @@
 #pragma once
+#include <expected>
+#include <optional>
+#include <string_view>
 #include <variant>
 #include "vertex/application/exchange.hpp"
 #include "vertex/core/types.hpp"
@@ -24,7 +27,6 @@ namespace vertex::cli
     {
         InvalidInput,
         UserNotFound,
-        UserAlreadyExists,
         EmptyName,
         MarketNotListed,
         MarketAlreadyListed,
@@ -32,8 +34,13 @@ namespace vertex::cli
         InsufficientReserved,
         InvalidAmount,
         InvalidQuantity,
+        AmountOverflow,
         OrderNotFound,
         NotOrderOwner,
+        // The process-wide asset registry cannot take another name.
+        AssetRegistryFull,
+        // The market's queue is full; the order was not taken and can be retried.
+        MarketBusy,
         InternalError
     };
 
@@ -147,7 +154,10 @@ namespace vertex::cli
         DispatchResult cancel_order(const CancelOrder &cmd);
         DispatchResult register_market(const RegisterMarket &cmd);
 
-        Market parse_market(std::string_view market);
+        // Order entry only looks the assets up, so unknown names are not
+        // interned; register_market interns them.
+        std::optional<Market> find_market(std::string_view market);
+        std::expected<Market, AppError> intern_market(std::string_view market);
         Side parse_side(std::string_view side);
         std::string to_string(Side side);
 
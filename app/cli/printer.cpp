@@ -185,8 +185,6 @@ namespace vertex::cli
             return "InvalidInput";
         case AppErrorCode::UserNotFound:
             return "UserNotFound";
-        case AppErrorCode::UserAlreadyExists:
-            return "UserAlreadyExists";
         case AppErrorCode::EmptyName:
             return "EmptyName";
         case AppErrorCode::MarketNotListed:
@@ -201,10 +199,16 @@ namespace vertex::cli
             return "InvalidAmount";
         case AppErrorCode::InvalidQuantity:
             return "InvalidQuantity";
+        case AppErrorCode::AmountOverflow:
+            return "AmountOverflow";
         case AppErrorCode::OrderNotFound:
             return "OrderNotFound";
         case AppErrorCode::NotOrderOwner:
             return "NotOrderOwner";
+        case AppErrorCode::AssetRegistryFull:
+            return "AssetRegistryFull";
+        case AppErrorCode::MarketBusy:
+            return "MarketBusy";
         case AppErrorCode::InternalError:
             return "InternalError";
         default:
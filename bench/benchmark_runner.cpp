@@ -1,6 +1,12 @@
 #include "benchmark_runner.hpp"
 
+#include "vertex/application/io_thread_pool.hpp"
+#include "vertex/domain/wallet.hpp"
+#include "vertex/engine/market_dispatcher.hpp"
+#include "vertex/engine/order_book.hpp"
+
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cmath>
@@ -11,11 +17,78 @@
 #include <random>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 using SteadyClock = std::chrono::steady_clock;
+using IoThreadPool = vertex::application::IoThreadPool;
+using DetachedTask = vertex::application::DetachedTask;
+using MarketDispatcherConfig = vertex::application::MarketDispatcherConfig;
+using ExchangeConfig = vertex::application::ExchangeConfig;
 namespace
 {
+    // Coroutine sessions multiplexed onto each I/O thread in CoroutineSingleMarket.
+    constexpr int kSessionsPerIoThread = 16;
+    // PooledManyMarkets lists kPooledBaseAssets x kPooledQuoteAssets markets.
+    constexpr int kPooledBaseAssets = 100;
+    constexpr int kPooledQuoteAssets = 100;
+    // RoutingLookup always runs this many client threads, independent of --threads.
+    constexpr int kRoutingLookupThreads = 32;
+    // Lookups timed together; one latency sample per batch.
+    constexpr int kRoutingLookupBatch = 64;
+    // Wallet*Layout: wallets settled against each other, and assets each one holds.
+    constexpr int kWalletCount = 1024;
+    constexpr int kWalletAssets = 4;
+    // Settlements timed together; one latency sample per batch.
+    constexpr int kWalletBatch = 64;
+    // DeepBook: resting orders kept in the book, spread over this many
+    // price levels per side; one taker every kDeepBookTakerEvery ops.
+    constexpr int kDeepBookOrders = 1'000'000;
+    constexpr int kDeepBookLevels = 1'000;
+    constexpr int kDeepBookTakerEvery = 16;
+    // Book operations timed together; one latency sample per batch.
+    constexpr int kDeepBookBatch = 64;
+
+    using Balance = vertex::domain::Balance;
+    using Quantity = vertex::core::Quantity;
+    using Price = vertex::core::Price;
+    using OrderId = vertex::core::OrderId;
+
+    // The Wallet layout before inline slots and interned asset keys (one
+    // hash-map node per asset, keyed by the asset name), kept only as the
+    // WalletMapLayout baseline. Same checks as vertex::domain::Wallet.
+    class MapWallet
+    {
+    public:
+        bool deposit(const Asset &asset, Quantity amount)
+        {
+            balances_[asset.value()].free += amount;
+            return true;
+        }
+
+        bool reserve(const Asset &asset, Quantity amount)
+        {
+            auto it = balances_.find(asset.value());
+            if (it == balances_.end() || it->second.free < amount)
+                return false;
+            it->second.free -= amount;
+            it->second.reserved += amount;
+            return true;
+        }
+
+        bool consume_reserved(const Asset &asset, Quantity amount)
+        {
+            auto it = balances_.find(asset.value());
+            if (it == balances_.end() || it->second.reserved < amount)
+                return false;
+            it->second.reserved -= amount;
+            return true;
+        }
+
+    private:
+        std::unordered_map<std::string, Balance> balances_{};
+    };
+
     double median(std::vector<double> values)
     {
         if (values.empty())
@@ -73,6 +146,48 @@ std::vector<ScenarioMetrics> BenchmarkRunner::run_scenario(ScenarioKind kind)
         }
         return result;
 
+    case ScenarioKind::CoroutineSingleMarket:
+        for (int i = 0; i < cfg_.repeats; ++i)
+        {
+            result.push_back(run_coroutine_single_market(i));
+        }
+        return result;
+
+    case ScenarioKind::PooledManyMarkets:
+        for (int i = 0; i < cfg_.repeats; ++i)
+        {
+            result.push_back(run_pooled_many_markets(i));
+        }
+        return result;
+
+    case ScenarioKind::RoutingLookup:
+        for (int i = 0; i < cfg_.repeats; ++i)
+        {
+            result.push_back(run_routing_lookup(i));
+        }
+        return result;
+
+    case ScenarioKind::WalletFlatLayout:
+        for (int i = 0; i < cfg_.repeats; ++i)
+        {
+            result.push_back(run_wallet_layout<vertex::domain::Wallet>(kind, i));
+        }
+        return result;
+
+    case ScenarioKind::WalletMapLayout:
+        for (int i = 0; i < cfg_.repeats; ++i)
+        {
+            result.push_back(run_wallet_layout<MapWallet>(kind, i));
+        }
+        return result;
+
+    case ScenarioKind::DeepBook:
+        for (int i = 0; i < cfg_.repeats; ++i)
+        {
+            result.push_back(run_deep_book(i));
+        }
+        return result;
+
     default:
         assert(false);
         return result;
@@ -109,12 +224,12 @@ AggregateMetrics BenchmarkRunner::aggregate(ScenarioKind kind, const std::vector
 
 ScenarioMetrics BenchmarkRunner::run_single_market(int repeat_index)
 {
-    Exchange exchange;
+    Exchange exchange{ExchangeConfig{.wallet_mode = cfg_.wallet_mode, .ledger_partitions = cfg_.ledger_partitions}};
     Asset btc{"BTC"};
     Asset usdt{"USDT"};
 
     Market market(btc, usdt);
-    exchange.register_market(market);
+    const MarketId market_id = exchange.register_market(market).value();
 
     std::vector<UserId> buyers;
     buyers.reserve(cfg_.thread_count / 2);
@@ -158,7 +273,7 @@ ScenarioMetrics BenchmarkRunner::run_single_market(int repeat_index)
                 UserId buyer = pick_random_user(rng, buyers);
                 UserId seller = pick_random_user(rng, sellers);
                 auto t0 = SteadyClock::now();
-                bool ok = execute_one_op(rng, exchange, market, buyer, seller, op);
+                bool ok = execute_one_op(rng, exchange, market_id, buyer, seller, op);
                 auto t1 = SteadyClock::now();
 
                 if(ok && measuring.load(std::memory_order_relaxed)){
@@ -229,7 +344,7 @@ ScenarioMetrics BenchmarkRunner::run_multi_market(int repeat_index)
 
 ScenarioMetrics BenchmarkRunner::run_disjoint_users(int repeat_index)
 {
-    Exchange exchange;
+    Exchange exchange{ExchangeConfig{.wallet_mode = cfg_.wallet_mode, .ledger_partitions = cfg_.ledger_partitions}};
     Asset btc{"BTC"};
     Asset usdt{"USDT"};
     Asset eth{"ETH"};
@@ -239,9 +354,10 @@ ScenarioMetrics BenchmarkRunner::run_disjoint_users(int repeat_index)
     const std::vector<Market> markets{{usdt, btc}, {eth, btc}, {pln, btc}, {sol, btc}};
     const std::size_t users_per_market = std::max<std::size_t>(4, 2 * static_cast<std::size_t>(cfg_.thread_count) / markets.size());
 
+    std::vector<MarketId> market_ids;
     for (auto &m : markets)
     {
-        exchange.register_market(m);
+        market_ids.push_back(exchange.register_market(m).value());
     }
 
     std::vector<std::vector<UserId>> buyers(markets.size());
@@ -279,7 +395,7 @@ ScenarioMetrics BenchmarkRunner::run_disjoint_users(int repeat_index)
             auto& local_lat = lat_us_per_thread[tid];
             local_lat.reserve(10000);
             size_t market_index = tid%markets.size();
-            Market market = markets[market_index];
+            const MarketId market_id = market_ids[market_index];
             const std::vector<UserId> &market_buyers = buyers[market_index];
             const std::vector<UserId> &market_sellers = sellers[market_index];
             start_latch.count_down();
@@ -290,7 +406,7 @@ ScenarioMetrics BenchmarkRunner::run_disjoint_users(int repeat_index)
                 UserId buyer = pick_random_user(rng,market_buyers);
                 UserId seller = pick_random_user(rng,market_sellers);
                 auto t0 = SteadyClock::now();
-                bool ok = execute_one_op(rng, exchange, market, buyer, seller, op);
+                bool ok = execute_one_op(rng, exchange, market_id, buyer, seller, op);
                 auto t1 = SteadyClock::now();
 
                 if(ok && measuring.load(std::memory_order_relaxed)){
@@ -354,7 +470,7 @@ ScenarioMetrics BenchmarkRunner::run_disjoint_users(int repeat_index)
 
 ScenarioMetrics BenchmarkRunner::run_shared_users(int repeat_index)
 {
-    Exchange exchange;
+    Exchange exchange{ExchangeConfig{.wallet_mode = cfg_.wallet_mode, .ledger_partitions = cfg_.ledger_partitions}};
     Asset btc{"BTC"};
     Asset usdt{"USDT"};
     Asset eth{"ETH"};
@@ -364,9 +480,10 @@ ScenarioMetrics BenchmarkRunner::run_shared_users(int repeat_index)
     const std::vector<Market> markets{{usdt, btc}, {eth, btc}, {pln, btc}, {sol, btc}};
     const std::size_t users_per_market = std::max<std::size_t>(4, 2 * static_cast<std::size_t>(cfg_.thread_count) / markets.size());
 
+    std::vector<MarketId> market_ids;
     for (auto &m : markets)
     {
-        exchange.register_market(m);
+        market_ids.push_back(exchange.register_market(m).value());
     }
 
     std::vector<UserId> buyers;
@@ -407,7 +524,7 @@ ScenarioMetrics BenchmarkRunner::run_shared_users(int repeat_index)
             auto& local_lat = lat_us_per_thread[tid];
             local_lat.reserve(10000);
             size_t market_index = tid%markets.size();
-            Market market = markets[market_index];
+            const MarketId market_id = market_ids[market_index];
             start_latch.count_down();
             start_latch.wait();
 
@@ -416,7 +533,7 @@ ScenarioMetrics BenchmarkRunner::run_shared_users(int repeat_index)
                 UserId buyer = pick_random_user(rng,buyers);
                 UserId seller = pick_random_user(rng,sellers);
                 auto t0 = SteadyClock::now();
-                bool ok = execute_one_op(rng, exchange, market, buyer, seller, op);
+                bool ok = execute_one_op(rng, exchange, market_id, buyer, seller, op);
                 auto t1 = SteadyClock::now();
 
                 if(ok && measuring.load(std::memory_order_relaxed)){
@@ -478,6 +595,639 @@ ScenarioMetrics BenchmarkRunner::run_shared_users(int repeat_index)
         .latency = LatencyStats{.p50_us = pct(50), .p95_us = pct(95), .p99_us = pct(99)}};
 }
 
+ScenarioMetrics BenchmarkRunner::run_coroutine_single_market(int repeat_index)
+{
+    Exchange exchange{ExchangeConfig{.wallet_mode = cfg_.wallet_mode, .ledger_partitions = cfg_.ledger_partitions}};
+    Asset btc{"BTC"};
+    Asset usdt{"USDT"};
+
+    Market market(btc, usdt);
+    const MarketId market_id = exchange.register_market(market).value();
+
+    std::vector<UserId> buyers;
+    buyers.reserve(cfg_.thread_count / 2);
+    std::vector<UserId> sellers;
+    sellers.reserve(cfg_.thread_count / 2);
+
+    for (int i = 0; i < std::max(1, cfg_.thread_count / 2); ++i)
+    {
+        UserId buyer_user = exchange.create_user(std::string(std::format("Buyer_U{}", i))).value();
+        exchange.deposit(buyer_user, usdt, 1'000'000);
+        buyers.push_back(buyer_user);
+
+        UserId seller_user = exchange.create_user(std::string(std::format("Seller_U{}", i))).value();
+        exchange.deposit(seller_user, btc, 1'000'000);
+        sellers.push_back(seller_user);
+    }
+
+    // Same thread count as SingleMarketHighLoad, but each I/O thread multiplexes
+    // many sessions instead of blocking on one in-flight order.
+    IoThreadPool pool{static_cast<std::size_t>(cfg_.thread_count)};
+    const int session_count = cfg_.thread_count * kSessionsPerIoThread;
+
+    std::latch finished(session_count);
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> measured_ops{0};
+
+    std::vector<std::vector<double>> lat_us_per_session(session_count);
+
+    auto session = [&](int sid) -> DetachedTask
+    {
+        co_await pool.schedule();
+
+        std::mt19937 rng = make_thread_rng(repeat_index, sid);
+        std::uniform_int_distribution<int> side_dist(0, 1);
+        auto &local_lat = lat_us_per_session[sid];
+        local_lat.reserve(1000);
+
+        while (!stop.load(std::memory_order_acquire))
+        {
+            OpKind op = pick_random_op(rng);
+            UserId buyer = pick_random_user(rng, buyers);
+            UserId seller = pick_random_user(rng, sellers);
+            auto t0 = SteadyClock::now();
+
+            bool ok = false;
+            switch (op)
+            {
+            case OpKind::PlaceLimitBuy:
+                ok = (co_await exchange.place_limit_order_async(pool, buyer, market_id, Side::Buy, 1, 1)).has_value();
+                break;
+            case OpKind::PlaceLimitSell:
+                ok = (co_await exchange.place_limit_order_async(pool, seller, market_id, Side::Sell, 1, 1)).has_value();
+                break;
+            case OpKind::MarketBuy:
+                ok = (co_await exchange.execute_market_order_async(pool, buyer, market_id, Side::Buy, 1)).has_value();
+                break;
+            case OpKind::MarketSell:
+                ok = (co_await exchange.execute_market_order_async(pool, seller, market_id, Side::Sell, 1)).has_value();
+                break;
+            case OpKind::Cancel:
+            {
+                const bool buy_side = side_dist(rng) == 0;
+                const UserId owner = buy_side ? buyer : seller;
+                auto placed = co_await exchange.place_limit_order_async(pool, owner, market_id, buy_side ? Side::Buy : Side::Sell, 1, 1);
+                ok = placed.has_value() && (co_await exchange.cancel_order_async(pool, owner, placed->order_id)).has_value();
+                break;
+            }
+            }
+
+            auto t1 = SteadyClock::now();
+
+            if (ok && measuring.load(std::memory_order_relaxed))
+            {
+                measured_ops.fetch_add(1, std::memory_order_relaxed);
+                double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+                local_lat.push_back(us);
+            }
+        }
+
+        finished.count_down();
+    };
+
+    for (int sid = 0; sid < session_count; ++sid)
+    {
+        session(sid);
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg_.warmup_seconds));
+
+    measuring.store(true, std::memory_order_release);
+    auto measure_start = SteadyClock::now();
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg_.measure_seconds));
+
+    auto measure_stop = SteadyClock::now();
+    measuring.store(false, std::memory_order_release);
+
+    stop.store(true, std::memory_order_release);
+    finished.wait();
+
+    std::vector<double> all_lat_us;
+    for (const auto &session_lat : lat_us_per_session)
+    {
+        for (double lat : session_lat)
+        {
+            all_lat_us.push_back(lat);
+        }
+    }
+
+    std::sort(all_lat_us.begin(), all_lat_us.end());
+
+    auto pct = [&](double p) -> double
+    {
+        if (all_lat_us.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t idx = static_cast<std::size_t>(std::floor((p / 100.0) * (all_lat_us.size() - 1)));
+        return all_lat_us[idx];
+    };
+
+    double measured_s = std::chrono::duration<double>(measure_stop - measure_start).count();
+    std::uint64_t ops = measured_ops.load(std::memory_order_relaxed);
+    double ops_per_sec = measured_s > 0 ? static_cast<double>(ops) / measured_s : 0.0;
+
+    return ScenarioMetrics{
+        .scenario = ScenarioKind::CoroutineSingleMarket,
+        .repeat_index = repeat_index,
+        .throughput = ThroughputStats{
+            .ops_per_sec = ops_per_sec,
+            .total_ops = ops},
+        .latency = LatencyStats{.p50_us = pct(50), .p95_us = pct(95), .p99_us = pct(99)}};
+}
+
+ScenarioMetrics BenchmarkRunner::run_pooled_many_markets(int repeat_index)
+{
+    // Thousands of long-tail markets multiplexed onto a fixed pool of worker threads.
+    const std::size_t pool_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency() / 2);
+    Exchange exchange{ExchangeConfig{
+        .dispatcher = MarketDispatcherConfig{.pool_threads = pool_threads},
+        .wallet_mode = cfg_.wallet_mode,
+        .ledger_partitions = cfg_.ledger_partitions}};
+
+    std::vector<Asset> bases;
+    std::vector<Asset> quotes;
+    for (int i = 0; i < kPooledBaseAssets; ++i)
+    {
+        bases.emplace_back(std::format("B{}", i));
+    }
+    for (int i = 0; i < kPooledQuoteAssets; ++i)
+    {
+        quotes.emplace_back(std::format("Q{}", i));
+    }
+
+    std::vector<MarketId> market_ids;
+    market_ids.reserve(bases.size() * quotes.size());
+    for (const auto &base : bases)
+    {
+        for (const auto &quote : quotes)
+        {
+            market_ids.push_back(exchange.register_market(Market{base, quote}).value());
+        }
+    }
+
+    std::vector<UserId> buyers;
+    std::vector<UserId> sellers;
+    for (int i = 0; i < std::max(2, cfg_.thread_count); ++i)
+    {
+        UserId buyer = exchange.create_user(std::format("Buyer_U{}", i)).value();
+        UserId seller = exchange.create_user(std::format("Seller_U{}", i)).value();
+        for (const auto &quote : quotes)
+        {
+            exchange.deposit(buyer, quote, 1'000'000);
+        }
+        for (const auto &base : bases)
+        {
+            exchange.deposit(seller, base, 1'000'000);
+        }
+        buyers.push_back(buyer);
+        sellers.push_back(seller);
+    }
+
+    std::latch start_latch(cfg_.thread_count);
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> measured_ops{0};
+
+    std::vector<std::vector<double>> lat_us_per_thread(cfg_.thread_count);
+
+    std::vector<std::thread> workers;
+    workers.reserve(cfg_.thread_count);
+
+    for (int tid = 0; tid < cfg_.thread_count; ++tid)
+    {
+        workers.emplace_back([&, tid]
+                             {
+            std::mt19937 rng = make_thread_rng(repeat_index, tid);
+            std::uniform_int_distribution<std::size_t> market_dist(0, market_ids.size() - 1);
+            auto& local_lat = lat_us_per_thread[tid];
+            local_lat.reserve(10000);
+            start_latch.count_down();
+            start_latch.wait();
+
+            while(!stop.load(std::memory_order_acquire)){
+                OpKind op = pick_random_op(rng);
+                const MarketId market_id = market_ids[market_dist(rng)];
+                UserId buyer = pick_random_user(rng,buyers);
+                UserId seller = pick_random_user(rng,sellers);
+                auto t0 = SteadyClock::now();
+                bool ok = execute_one_op(rng, exchange, market_id, buyer, seller, op);
+                auto t1 = SteadyClock::now();
+
+                if(ok && measuring.load(std::memory_order_relaxed)){
+                    measured_ops.fetch_add(1, std::memory_order_relaxed);
+                    double us = std::chrono::duration<double,std::micro>(t1 - t0).count();
+                    local_lat.push_back(us);
+                }
+            } });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg_.warmup_seconds));
+
+    measuring.store(true, std::memory_order_release);
+    auto measure_start = SteadyClock::now();
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg_.measure_seconds));
+
+    auto measure_stop = SteadyClock::now();
+    measuring.store(false, std::memory_order_release);
+
+    stop.store(true, std::memory_order_release);
+
+    for (auto &th : workers)
+    {
+        th.join();
+    }
+
+    if (cfg_.verbose)
+    {
+        const auto pool_stats = exchange.market_pool_stats().value();
+        std::cout << std::format("[PooledManyMarkets][Index={}][Pool threads={}, Migrations={}]\n",
+                                 repeat_index, pool_stats.threads.size(), pool_stats.migrations);
+        for (std::size_t i = 0; i < pool_stats.threads.size(); ++i)
+        {
+            const auto &thread = pool_stats.threads[i];
+            const double utilisation = pool_stats.elapsed_ns > 0
+                                           ? 100.0 * static_cast<double>(thread.busy_ns) / static_cast<double>(pool_stats.elapsed_ns)
+                                           : 0.0;
+            std::cout << std::format("  [Pool thread {}][Tasks={}, Batches={}, Busy={:.1f}%]\n",
+                                     i, thread.tasks_run, thread.batches_run, utilisation);
+        }
+    }
+
+    std::vector<double> all_lat_us;
+    for (const auto &th_lat : lat_us_per_thread)
+    {
+        for (double lat : th_lat)
+        {
+            all_lat_us.push_back(lat);
+        }
+    }
+
+    std::sort(all_lat_us.begin(), all_lat_us.end());
+
+    auto pct = [&](double p) -> double
+    {
+        if (all_lat_us.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t idx = static_cast<std::size_t>(std::floor((p / 100.0) * (all_lat_us.size() - 1)));
+        return all_lat_us[idx];
+    };
+
+    double measured_s = std::chrono::duration<double>(measure_stop - measure_start).count();
+    std::uint64_t ops = measured_ops.load(std::memory_order_relaxed);
+    double ops_per_sec = measured_s > 0 ? static_cast<double>(ops) / measured_s : 0.0;
+
+    return ScenarioMetrics{
+        .scenario = ScenarioKind::PooledManyMarkets,
+        .repeat_index = repeat_index,
+        .throughput = ThroughputStats{
+            .ops_per_sec = ops_per_sec,
+            .total_ops = ops},
+        .latency = LatencyStats{.p50_us = pct(50), .p95_us = pct(95), .p99_us = pct(99)}};
+}
+
+ScenarioMetrics BenchmarkRunner::run_routing_lookup(int repeat_index)
+{
+    // Pure dispatcher routing: client threads only resolve Market -> worker, no task is enqueued.
+    vertex::engine::MarketDispatcher dispatcher{MarketDispatcherConfig{.pool_threads = 1}};
+
+    std::vector<Market> markets;
+    markets.reserve(static_cast<std::size_t>(kPooledBaseAssets) * kPooledQuoteAssets);
+    for (int i = 0; i < kPooledBaseAssets; ++i)
+    {
+        for (int j = 0; j < kPooledQuoteAssets; ++j)
+        {
+            markets.emplace_back(Asset{std::format("B{}", i)}, Asset{std::format("Q{}", j)});
+            (void)dispatcher.register_market(markets.back());
+        }
+    }
+
+    std::latch start_latch(kRoutingLookupThreads);
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> measured_ops{0};
+    std::atomic<std::uint64_t> misses{0};
+
+    std::vector<std::vector<double>> lat_us_per_thread(kRoutingLookupThreads);
+
+    std::vector<std::thread> workers;
+    workers.reserve(kRoutingLookupThreads);
+
+    for (int tid = 0; tid < kRoutingLookupThreads; ++tid)
+    {
+        workers.emplace_back([&, tid]
+                             {
+            std::mt19937 rng = make_thread_rng(repeat_index, tid);
+            std::uniform_int_distribution<std::size_t> market_dist(0, markets.size() - 1);
+            std::array<const Market *, kRoutingLookupBatch> batch{};
+            auto& local_lat = lat_us_per_thread[tid];
+            local_lat.reserve(100000);
+            start_latch.count_down();
+            start_latch.wait();
+
+            while(!stop.load(std::memory_order_acquire)){
+                for (auto &market : batch)
+                {
+                    market = &markets[market_dist(rng)];
+                }
+
+                std::uint64_t found = 0;
+                auto t0 = SteadyClock::now();
+                for (const Market *market : batch)
+                {
+                    found += dispatcher.has_market(*market) ? 1 : 0;
+                }
+                auto t1 = SteadyClock::now();
+
+                if (found != batch.size())
+                    misses.fetch_add(batch.size() - found, std::memory_order_relaxed);
+
+                if(measuring.load(std::memory_order_relaxed)){
+                    measured_ops.fetch_add(batch.size(), std::memory_order_relaxed);
+                    double us = std::chrono::duration<double,std::micro>(t1 - t0).count();
+                    local_lat.push_back(us);
+                }
+            } });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg_.warmup_seconds));
+
+    measuring.store(true, std::memory_order_release);
+    auto measure_start = SteadyClock::now();
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg_.measure_seconds));
+
+    auto measure_stop = SteadyClock::now();
+    measuring.store(false, std::memory_order_release);
+
+    stop.store(true, std::memory_order_release);
+
+    for (auto &th : workers)
+    {
+        th.join();
+    }
+
+    if (cfg_.verbose)
+    {
+        std::cout << std::format("[RoutingLookup][Index={}][Markets={}, Client threads={}, Batch={}, Misses={}]\n",
+                                 repeat_index, markets.size(), kRoutingLookupThreads, kRoutingLookupBatch, misses.load());
+    }
+
+    std::vector<double> all_lat_us;
+    for (const auto &th_lat : lat_us_per_thread)
+    {
+        for (double lat : th_lat)
+        {
+            all_lat_us.push_back(lat);
+        }
+    }
+
+    std::sort(all_lat_us.begin(), all_lat_us.end());
+
+    auto pct = [&](double p) -> double
+    {
+        if (all_lat_us.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t idx = static_cast<std::size_t>(std::floor((p / 100.0) * (all_lat_us.size() - 1)));
+        return all_lat_us[idx];
+    };
+
+    double measured_s = std::chrono::duration<double>(measure_stop - measure_start).count();
+    std::uint64_t ops = measured_ops.load(std::memory_order_relaxed);
+    double ops_per_sec = measured_s > 0 ? static_cast<double>(ops) / measured_s : 0.0;
+
+    return ScenarioMetrics{
+        .scenario = ScenarioKind::RoutingLookup,
+        .repeat_index = repeat_index,
+        .throughput = ThroughputStats{
+            .ops_per_sec = ops_per_sec,
+            .total_ops = ops},
+        .latency = LatencyStats{.p50_us = pct(50), .p95_us = pct(95), .p99_us = pct(99)}};
+}
+
+template <typename WalletT>
+ScenarioMetrics BenchmarkRunner::run_wallet_layout(ScenarioKind kind, int repeat_index)
+{
+    // Same op sequence as Exchange settlement of one execution: both sides reserve,
+    // then consume_reserved + deposit on each side.
+    const std::vector<Asset> assets{Asset{"BTC"}, Asset{"USDT"}, Asset{"ETH"}, Asset{"SOL"}};
+    static_assert(kWalletAssets == 4);
+
+    std::vector<WalletT> wallets(kWalletCount);
+    for (auto &wallet : wallets)
+    {
+        for (const auto &asset : assets)
+        {
+            wallet.deposit(asset, 1'000'000'000'000);
+        }
+    }
+
+    std::mt19937 rng = make_thread_rng(repeat_index, 0);
+    std::uniform_int_distribution<std::size_t> wallet_dist(0, wallets.size() - 1);
+    std::uniform_int_distribution<std::size_t> asset_dist(0, assets.size() - 1);
+
+    std::vector<double> all_lat_us;
+    all_lat_us.reserve(1'000'000);
+    std::uint64_t ops = 0;
+    std::uint64_t failed = 0;
+
+    const auto warmup_end = SteadyClock::now() + std::chrono::seconds(cfg_.warmup_seconds);
+    bool measuring = false;
+    SteadyClock::time_point measure_start{};
+    SteadyClock::time_point measure_end{};
+
+    while (true)
+    {
+        const auto now = SteadyClock::now();
+        if (!measuring && now >= warmup_end)
+        {
+            measuring = true;
+            measure_start = now;
+            measure_end = now + std::chrono::seconds(cfg_.measure_seconds);
+        }
+        if (measuring && now >= measure_end)
+        {
+            break;
+        }
+
+        auto t0 = SteadyClock::now();
+        for (int i = 0; i < kWalletBatch; ++i)
+        {
+            WalletT &buyer = wallets[wallet_dist(rng)];
+            WalletT &seller = wallets[wallet_dist(rng)];
+            const std::size_t base_index = asset_dist(rng);
+            const Asset &base = assets[base_index];
+            const Asset &quote = assets[(base_index + 1) % assets.size()];
+
+            bool ok = static_cast<bool>(buyer.reserve(quote, 100)) && static_cast<bool>(seller.reserve(base, 1));
+            ok = static_cast<bool>(buyer.consume_reserved(quote, 100)) && ok;
+            ok = static_cast<bool>(buyer.deposit(base, 1)) && ok;
+            ok = static_cast<bool>(seller.consume_reserved(base, 1)) && ok;
+            ok = static_cast<bool>(seller.deposit(quote, 100)) && ok;
+            failed += ok ? 0 : 1;
+        }
+        auto t1 = SteadyClock::now();
+
+        if (measuring)
+        {
+            ops += kWalletBatch;
+            all_lat_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+    }
+
+    if (cfg_.verbose)
+    {
+        const std::size_t inline_assets =
+            kind == ScenarioKind::WalletFlatLayout ? std::min(assets.size(), vertex::domain::Wallet::kInlineAssets) : 0;
+        std::cout << std::format("[{}][Index={}][Wallets={}, Assets={} ({} inline), Batch={}, Failed={}]\n",
+                                 kind == ScenarioKind::WalletFlatLayout ? "WalletFlatLayout" : "WalletMapLayout",
+                                 repeat_index, kWalletCount, assets.size(), inline_assets, kWalletBatch, failed);
+    }
+
+    std::sort(all_lat_us.begin(), all_lat_us.end());
+
+    auto pct = [&](double p) -> double
+    {
+        if (all_lat_us.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t idx = static_cast<std::size_t>(std::floor((p / 100.0) * (all_lat_us.size() - 1)));
+        return all_lat_us[idx];
+    };
+
+    double measured_s = std::chrono::duration<double>(measure_end - measure_start).count();
+    double ops_per_sec = measured_s > 0 ? static_cast<double>(ops) / measured_s : 0.0;
+
+    return ScenarioMetrics{
+        .scenario = kind,
+        .repeat_index = repeat_index,
+        .throughput = ThroughputStats{
+            .ops_per_sec = ops_per_sec,
+            .total_ops = ops},
+        .latency = LatencyStats{.p50_us = pct(50), .p95_us = pct(95), .p99_us = pct(99)}};
+}
+
+ScenarioMetrics BenchmarkRunner::run_deep_book(int repeat_index)
+{
+    // Bids rest on ticks [1, kDeepBookLevels], asks above them, so only the
+    // takers cross. Each op cancels a random resting slot and books a
+    // replacement; a taker market-sells a few orders off the best bid.
+    vertex::engine::OrderBook book{Market{Asset{"DEEP"}, Asset{"USDT"}}};
+    vertex::engine::ExecutionBuffer executions;
+
+    std::mt19937 rng = make_thread_rng(repeat_index, 0);
+    std::uniform_int_distribution<std::size_t> slot_dist(0, kDeepBookOrders - 1);
+    std::uniform_int_distribution<Price> level_dist(1, kDeepBookLevels);
+
+    std::uint64_t next_order_id = 1;
+    std::vector<OrderId> live(kDeepBookOrders);
+    auto book_order = [&](std::size_t slot)
+    {
+        const Side side = slot % 2 == 0 ? Side::Buy : Side::Sell;
+        const Price price = side == Side::Buy ? level_dist(rng) : kDeepBookLevels + level_dist(rng);
+        const vertex::engine::LimitOrderRequest request{
+            .id = OrderId{next_order_id++},
+            .user_id = UserId{slot % 1024 + 1},
+            .market = MarketId{1},
+            .side = side,
+            .limit_price = price,
+            .base_quantity = 10,
+        };
+        book.insert_resting(request, request.base_quantity);
+        live[slot] = request.id;
+    };
+
+    for (std::size_t slot = 0; slot < live.size(); ++slot)
+    {
+        book_order(slot);
+    }
+
+    std::vector<double> all_lat_us;
+    all_lat_us.reserve(1'000'000);
+    std::uint64_t ops = 0;
+    std::uint64_t fills = 0;
+
+    const auto warmup_end = SteadyClock::now() + std::chrono::seconds(cfg_.warmup_seconds);
+    bool measuring = false;
+    SteadyClock::time_point measure_start{};
+    SteadyClock::time_point measure_end{};
+
+    while (true)
+    {
+        const auto now = SteadyClock::now();
+        if (!measuring && now >= warmup_end)
+        {
+            measuring = true;
+            measure_start = now;
+            measure_end = now + std::chrono::seconds(cfg_.measure_seconds);
+        }
+        if (measuring && now >= measure_end)
+        {
+            break;
+        }
+
+        auto t0 = SteadyClock::now();
+        for (int i = 0; i < kDeepBookBatch; ++i)
+        {
+            const std::size_t slot = slot_dist(rng);
+            // Already gone if a taker filled it; the replacement is booked either way.
+            (void)book.cancel(live[slot]);
+            book_order(slot);
+
+            if (i % kDeepBookTakerEvery == 0)
+            {
+                executions.clear();
+                book.match_market_sell_by_base_against_bids(OrderId{next_order_id++}, UserId{2}, 25, executions);
+                fills += executions.size();
+            }
+        }
+        auto t1 = SteadyClock::now();
+
+        if (measuring)
+        {
+            ops += kDeepBookBatch;
+            all_lat_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+    }
+
+    if (cfg_.verbose)
+    {
+        std::cout << std::format("[DeepBook][Index={}][Resting={}, Levels={}x2, Batch={}, Fills={}]\n",
+                                 repeat_index, book.resting_count(), kDeepBookLevels, kDeepBookBatch, fills);
+    }
+
+    std::sort(all_lat_us.begin(), all_lat_us.end());
+
+    auto pct = [&](double p) -> double
+    {
+        if (all_lat_us.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t idx = static_cast<std::size_t>(std::floor((p / 100.0) * (all_lat_us.size() - 1)));
+        return all_lat_us[idx];
+    };
+
+    double measured_s = std::chrono::duration<double>(measure_end - measure_start).count();
+    double ops_per_sec = measured_s > 0 ? static_cast<double>(ops) / measured_s : 0.0;
+
+    return ScenarioMetrics{
+        .scenario = ScenarioKind::DeepBook,
+        .repeat_index = repeat_index,
+        .throughput = ThroughputStats{
+            .ops_per_sec = ops_per_sec,
+            .total_ops = ops},
+        .latency = LatencyStats{.p50_us = pct(50), .p95_us = pct(95), .p99_us = pct(99)}};
+}
+
 std::mt19937 BenchmarkRunner::make_thread_rng(int repeat_index, int thread_index) const
 {
     const auto stream = static_cast<std::uint32_t>(repeat_index * 1000 + thread_index);
@@ -510,7 +1260,7 @@ UserId BenchmarkRunner::pick_random_user(std::mt19937 &rng, const std::vector<Us
     return users[users_dist(rng)];
 }
 
-bool BenchmarkRunner::execute_one_op(std::mt19937 &rng, Exchange &ex, const Market &market, const UserId buyer, const UserId seller, OpKind op)
+bool BenchmarkRunner::execute_one_op(std::mt19937 &rng, Exchange &ex, const MarketId market, const UserId buyer, const UserId seller, OpKind op)
 {
     std::uniform_int_distribution<int> side_dist(0, 1);
 
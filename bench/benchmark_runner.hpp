@@ -11,9 +11,11 @@
 
 using Exchange = vertex::application::Exchange;
 using Market = vertex::application::Market;
+using MarketId = vertex::application::MarketId;
 using Asset = vertex::application::Asset;
 using UserId = vertex::core::UserId;
 using Side = vertex::core::Side;
+using WalletMode = vertex::application::WalletMode;
 
 struct BenchConfig
 {
@@ -23,6 +25,10 @@ struct BenchConfig
     int thread_count;
     std::uint32_t seed;
     bool verbose;
+    // Wallet implementation used by every Exchange-backed scenario.
+    WalletMode wallet_mode;
+    // Ledger threads when wallet_mode is Partitioned.
+    std::size_t ledger_partitions;
 };
 
 enum class ScenarioKind
@@ -30,7 +36,13 @@ enum class ScenarioKind
     SingleMarketHighLoad,
     MultiMarketParallelLoad,
     SharedUsersContention,
-    DisjointUsersContention
+    DisjointUsersContention,
+    CoroutineSingleMarket,
+    PooledManyMarkets,
+    RoutingLookup,
+    WalletFlatLayout,
+    WalletMapLayout,
+    DeepBook
 };
 
 struct LatencyStats
@@ -83,6 +95,14 @@ public:
     ScenarioMetrics run_multi_market(int repeat_index);
     ScenarioMetrics run_disjoint_users(int repeat_index);
     ScenarioMetrics run_shared_users(int repeat_index);
+    ScenarioMetrics run_coroutine_single_market(int repeat_index);
+    ScenarioMetrics run_pooled_many_markets(int repeat_index);
+    ScenarioMetrics run_routing_lookup(int repeat_index);
+    // Single-thread settlement loop over WalletT; no Exchange involved.
+    template <typename WalletT>
+    ScenarioMetrics run_wallet_layout(ScenarioKind kind, int repeat_index);
+    // Single-thread cancel/replace and takers on one deep OrderBook; no worker involved.
+    ScenarioMetrics run_deep_book(int repeat_index);
 
 private:
     BenchConfig cfg_;
@@ -91,6 +111,6 @@ private:
     std::mt19937 make_thread_rng(int repeat_index, int thread_index) const;
     OpKind pick_random_op(std::mt19937 &rng) const;
     UserId pick_random_user(std::mt19937 &rng, const std::vector<UserId> &users) const;
-    bool execute_one_op(std::mt19937 &rng, Exchange &ex, const Market &market, const UserId buyer, const UserId seller, OpKind op);
+    bool execute_one_op(std::mt19937 &rng, Exchange &ex, const MarketId market, const UserId buyer, const UserId seller, OpKind op);
 };
 
@@ -37,6 +37,8 @@ namespace
         cfg.thread_count = 24;
         cfg.seed = 0xC0FFEEu;
         cfg.verbose = true;
+        cfg.wallet_mode = WalletMode::Locked;
+        cfg.ledger_partitions = 4;
         return cfg;
     }
 
@@ -46,7 +48,13 @@ namespace
             ScenarioKind::SingleMarketHighLoad,
             ScenarioKind::MultiMarketParallelLoad,
             ScenarioKind::DisjointUsersContention,
-            ScenarioKind::SharedUsersContention};
+            ScenarioKind::SharedUsersContention,
+            ScenarioKind::CoroutineSingleMarket,
+            ScenarioKind::PooledManyMarkets,
+            ScenarioKind::RoutingLookup,
+            ScenarioKind::WalletFlatLayout,
+            ScenarioKind::WalletMapLayout,
+            ScenarioKind::DeepBook};
     }
 
     std::string_view scenario_name(ScenarioKind scenario)
@@ -61,6 +69,18 @@ namespace
             return "SharedUsersContention";
         case ScenarioKind::DisjointUsersContention:
             return "DisjointUsersContention";
+        case ScenarioKind::CoroutineSingleMarket:
+            return "CoroutineSingleMarket";
+        case ScenarioKind::PooledManyMarkets:
+            return "PooledManyMarkets";
+        case ScenarioKind::RoutingLookup:
+            return "RoutingLookup";
+        case ScenarioKind::WalletFlatLayout:
+            return "WalletFlatLayout";
+        case ScenarioKind::WalletMapLayout:
+            return "WalletMapLayout";
+        case ScenarioKind::DeepBook:
+            return "DeepBook";
         default:
             return "InvalidScenario";
         }
@@ -126,6 +146,30 @@ namespace
         {
             return ScenarioKind::SharedUsersContention;
         }
+        if (value == "coro" || value == "coroutine" || value == "coroutine-single")
+        {
+            return ScenarioKind::CoroutineSingleMarket;
+        }
+        if (value == "pooled" || value == "many-markets" || value == "pooled-many-markets")
+        {
+            return ScenarioKind::PooledManyMarkets;
+        }
+        if (value == "routing" || value == "lookup" || value == "routing-lookup")
+        {
+            return ScenarioKind::RoutingLookup;
+        }
+        if (value == "wallet-flat" || value == "flat-wallet" || value == "wallet_flat")
+        {
+            return ScenarioKind::WalletFlatLayout;
+        }
+        if (value == "wallet-map" || value == "map-wallet" || value == "wallet_map")
+        {
+            return ScenarioKind::WalletMapLayout;
+        }
+        if (value == "book" || value == "deep-book" || value == "deep_book")
+        {
+            return ScenarioKind::DeepBook;
+        }
         return std::nullopt;
     }
 
@@ -146,12 +190,14 @@ namespace
     void print_help(std::ostream &out)
     {
         out << "vertex_bench options:\n";
-        out << "  --scenario <name|list>   single|multi|disjoint|shared|all (comma-separated)\n";
+        out << "  --scenario <name|list>   single|multi|disjoint|shared|coro|pooled|routing|wallet-flat|wallet-map|book|all (comma-separated)\n";
         out << "  --threads <int>          worker thread count (>0)\n";
         out << "  --warmup <int>           warmup seconds (>=0)\n";
         out << "  --measure <int>          measure seconds (>0)\n";
         out << "  --repeats <int>          repeats per scenario (>0)\n";
         out << "  --seed <uint32>          random seed\n";
+        out << "  --wallet-mode <mode>     locked|atomic|partitioned wallet for Exchange scenarios (default locked)\n";
+        out << "  --ledger-partitions <int> ledger threads for --wallet-mode partitioned (>0, default 4)\n";
         out << "  --json-out <path>        write raw run metrics to JSON file\n";
         out << "  --verbose                print every run + aggregate\n";
         out << "  --quiet                  print aggregate only\n";
@@ -455,6 +501,54 @@ namespace
                 continue;
             }
 
+            if (arg == "--wallet-mode")
+            {
+                const auto value = need_value(arg);
+                if (!value.has_value())
+                {
+                    return result;
+                }
+
+                const std::string lowered = to_lower(*value);
+                if (lowered == "locked")
+                {
+                    result.args.config.wallet_mode = WalletMode::Locked;
+                }
+                else if (lowered == "atomic")
+                {
+                    result.args.config.wallet_mode = WalletMode::Atomic;
+                }
+                else if (lowered == "partitioned")
+                {
+                    result.args.config.wallet_mode = WalletMode::Partitioned;
+                }
+                else
+                {
+                    result.ok = false;
+                    result.error = std::format("Invalid --wallet-mode value '{}'.", *value);
+                    return result;
+                }
+                continue;
+            }
+
+            if (arg == "--ledger-partitions")
+            {
+                const auto value = need_value(arg);
+                if (!value.has_value())
+                {
+                    return result;
+                }
+                int parsed = 0;
+                if (!parse_int(*value, parsed) || parsed <= 0)
+                {
+                    result.ok = false;
+                    result.error = std::format("Invalid --ledger-partitions value '{}'.", *value);
+                    return result;
+                }
+                result.args.config.ledger_partitions = static_cast<std::size_t>(parsed);
+                continue;
+            }
+
             if (arg == "--json-out")
             {
                 const auto value = need_value(arg);
@@ -586,6 +680,18 @@ std::string to_string(ScenarioKind s)
         return "SharedUsersContention";
     case ScenarioKind::DisjointUsersContention:
         return "DisjointUsersContention";
+    case ScenarioKind::CoroutineSingleMarket:
+        return "CoroutineSingleMarket";
+    case ScenarioKind::PooledManyMarkets:
+        return "PooledManyMarkets";
+    case ScenarioKind::RoutingLookup:
+        return "RoutingLookup";
+    case ScenarioKind::WalletFlatLayout:
+        return "WalletFlatLayout";
+    case ScenarioKind::WalletMapLayout:
+        return "WalletMapLayout";
+    case ScenarioKind::DeepBook:
+        return "DeepBook";
     default:
         return "Invalid scenario kind";
     }
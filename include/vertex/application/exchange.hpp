@@ -4,17 +4,26 @@
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <shared_mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <variant>
+#include <vector>
 
+#include "vertex/application/exchange_awaitable.hpp"
+#include "vertex/application/io_thread_pool.hpp"
+#include "vertex/application/ledger_partitions.hpp"
 #include "vertex/application/order_history.hpp"
 #include "vertex/application/order_meta_store.hpp"
 #include "vertex/application/trade_history.hpp"
+#include "vertex/core/cache_line.hpp"
 #include "vertex/core/id_generator.hpp"
+#include "vertex/core/market_spec.hpp"
+#include "vertex/core/segmented_table.hpp"
 #include "vertex/core/types.hpp"
 #include "vertex/domain/trade.hpp"
+#include "vertex/domain/atomic_wallet.hpp"
 #include "vertex/domain/user.hpp"
 #include "vertex/domain/wallet.hpp"
 #include "vertex/engine/engine_async_error.hpp"
@@ -24,25 +33,34 @@
 namespace vertex::application
 {
     using UserId = vertex::core::UserId;
-    using UserIdGenerator = vertex::core::IdGenerator<UserId>;
     using User = vertex::domain::User;
     using OrderId = vertex::core::OrderId;
     using OrderIdGenerator = vertex::core::IdGenerator<OrderId>;
     using TradeId = vertex::core::TradeId;
-    using TradeIdGenerator = vertex::core::IdGenerator<TradeId>;
     using Wallet = vertex::domain::Wallet;
+    using AtomicWallet = vertex::domain::AtomicWallet;
     using Quantity = vertex::core::Quantity;
     using Asset = vertex::core::Asset;
     using Price = vertex::core::Price;
     using Side = vertex::core::Side;
     using MarketDispatcher = vertex::engine::MarketDispatcher;
     using Market = vertex::core::Market;
+    using MarketId = vertex::core::MarketId;
+    using MarketSpec = vertex::core::MarketSpec;
     using Execution = vertex::engine::Execution;
     using Trade = vertex::domain::Trade;
     using LimitOrderRequest = vertex::engine::LimitOrderRequest;
     using MarketBuyByQuoteRequest = vertex::engine::MarketBuyByQuoteRequest;
     using MarketSellByBaseRequest = vertex::engine::MarketSellByBaseRequest;
+    using OrderRequest = vertex::engine::OrderRequest;
+    using SubmitResult = vertex::engine::SubmitResult;
+    using SubmitBatchResult = vertex::engine::SubmitBatchResult;
+    using CancelResultEx = vertex::engine::CancelResultEx;
     using EngineAsyncError = vertex::engine::EngineAsyncError;
+    using MarketWorkerConfig = vertex::engine::MarketWorkerConfig;
+    using MarketDispatcherConfig = vertex::engine::MarketDispatcherConfig;
+    using MarketWorkerPoolStats = vertex::engine::MarketWorkerPoolStats;
+    using SubLedgerBalance = vertex::engine::SubLedgerBalance;
     using WalletError = vertex::domain::WalletError;
 
     enum class WalletOperationError
@@ -50,14 +68,20 @@ namespace vertex::application
         UserNotFound,
         InsufficientFunds,
         InsufficientReserved,
-        InvalidQuantity
+        InvalidQuantity,
+        BalanceOverflow,
+        // Sub-ledger calls: unknown market or one without a sub-ledger.
+        MarketNotFound,
+        AssetNotInMarket,
+        WorkerStopped
     };
 
     enum class UserError
     {
         UserNotFound,
-        UserAlreadyExists,
-        EmptyName
+        EmptyName,
+        // The account table is full (Exchange::kMaxAccounts).
+        UserCapacityExhausted
     };
 
     enum class PlaceOrderError
@@ -68,7 +92,14 @@ namespace vertex::application
         InvalidQuantity,
         InvalidAmount,
         WorkerStopped,
-        OrderIdCollision
+        OrderIdCollision,
+        Overloaded,
+        // price * quantity does not fit in a Quantity
+        NotionalOverflow,
+        // Rejected by the market's MarketSpec
+        PriceNotOnTick,
+        PriceOutOfBand,
+        QuantityNotOnLot
     };
 
     enum class CancelOrderError
@@ -83,7 +114,10 @@ namespace vertex::application
     enum class RegisterMarketError
     {
         AlreadyListed,
-        WorkerStopped
+        WorkerStopped,
+        InvalidSpec,
+        // The dispatcher cannot list another market.
+        CapacityExhausted
     };
 
     enum class AnalyticsError
@@ -100,6 +134,16 @@ namespace vertex::application
         Quantity remaining_quantity;
     };
 
+    // One order of a place_limit_orders batch.
+    struct LimitOrderEntry
+    {
+        UserId user_id;
+        MarketId market_id;
+        Side side;
+        Price price;
+        Quantity quantity;
+    };
+
     struct CancelOrderResult
     {
         OrderId id;
@@ -107,19 +151,65 @@ namespace vertex::application
         Quantity remaining_quantity;
     };
 
-    struct Account
+    using PlaceOrderAwaitable = ExchangeAwaitable<SubmitResult, std::expected<OrderPlacementResult, PlaceOrderError>>;
+    using CancelOrderAwaitable = ExchangeAwaitable<CancelResultEx, std::expected<CancelOrderResult, CancelOrderError>>;
+
+    enum class WalletMode
+    {
+        // Wallet guarded by Account::mu; settlement locks both accounts in UserId order.
+        Locked,
+        // AtomicWallet updated with CAS; no account lock is taken.
+        Atomic,
+        // Wallet owned by one ledger thread (LedgerPartitions); every wallet
+        // access is a message to it and no account lock is taken.
+        Partitioned
+    };
+
+    struct ExchangeConfig
+    {
+        MarketDispatcherConfig dispatcher{};
+        WalletMode wallet_mode{WalletMode::Locked};
+        // Ledger threads for WalletMode::Partitioned; ignored otherwise.
+        std::size_t ledger_partitions{4};
+    };
+
+    // Hot per-user state: the lock, the id used to order locks and the
+    // wallet it guards. Each account starts on its own cache line and pads
+    // to a whole number of lines, so neighbours in the account table never
+    // share one. The User (name) lives in a separate cold table.
+    struct alignas(vertex::core::kCacheLineSize) Account
     {
-        User user;
-        Wallet wallet;
+        // Unused in WalletMode::Partitioned, where the ledger thread owns the wallet.
         std::mutex mu{};
+        UserId id;
+        std::variant<Wallet, AtomicWallet> wallet;
 
-        Account(User u, Wallet w)
-            : user(std::move(u)),
-              wallet(std::move(w))
+        Account(UserId user_id, WalletMode mode)
+            : id(user_id)
         {
+            if (mode == WalletMode::Atomic)
+                wallet.emplace<AtomicWallet>();
+        }
+
+        // Runs fn on the wallet, holding mu only for the locked Wallet.
+        template <typename Fn>
+        auto with_wallet(Fn &&fn)
+        {
+            if (auto *atomic_wallet = std::get_if<AtomicWallet>(&wallet))
+                return fn(*atomic_wallet);
+
+            std::lock_guard lock(mu);
+            return fn(std::get<Wallet>(wallet));
         }
     };
 
+    static_assert(sizeof(Account) % vertex::core::kCacheLineSize == 0, "Account must fill whole cache lines");
+
+    // 4096-account segments, up to 16M accounts.
+    using AccountTable = vertex::core::SegmentedTable<Account, 12, 4096>;
+    // Cold side of AccountTable, same index.
+    using UserTable = vertex::core::SegmentedTable<User, 12, 4096>;
+
     class ExchangeTestAccess;
 
     class Exchange
@@ -128,58 +218,183 @@ namespace vertex::application
         friend class ExchangeTestAccess;
 
         OrderMetaStore order_meta_store_;
+        WalletMode wallet_mode_{WalletMode::Locked};
 
-        std::unordered_map<UserId, std::shared_ptr<Account>> accounts_;
-        mutable std::shared_mutex accounts_mu_;
+        // Account of UserId{i + 1} lives at index i, so user ids are issued by
+        // the table itself. Lookups are lock-free and accounts never move or
+        // go away, so plain Account pointers stay valid for the Exchange's
+        // lifetime. users_ holds the matching User at the same index and is
+        // appended first. accounts_mu_ serializes create_user. Mutable because
+        // const queries still lock the account they read.
+        mutable AccountTable accounts_;
+        UserTable users_;
+        std::mutex accounts_mu_;
+        // Set in WalletMode::Partitioned only. Declared after the accounts and
+        // before market_dispatcher_, so it drains settlements posted during
+        // dispatcher shutdown and stops before the wallets go away.
+        std::unique_ptr<LedgerPartitions> ledger_;
 
-        UserIdGenerator user_id_generator_;
-        std::mutex user_id_generator_mu_;
+        // Order ids come from per-thread leased blocks (next_local()). Trade
+        // ids are stamped by the market workers.
         OrderIdGenerator order_id_generator_;
-        std::mutex order_id_generator_mu_;
-        TradeIdGenerator trade_id_generator_;
-        std::mutex trade_id_generator_mu_;
 
-        MarketDispatcher market_dispatcher_{};
         TradeHistory trade_history_{};
         OrderHistory order_history_{};
+        // Declared last so it is destroyed first: stopping it drains queued
+        // tasks and settlement-stage completions, which still write to the
+        // meta store, histories and wallets above.
+        MarketDispatcher market_dispatcher_{};
 
         struct PreparedLimitOrder
         {
-            std::shared_ptr<Account> account;
-            Asset asset_to_reserve;
-            Quantity quantity_to_reserve;
+            Account *account;
+            // Full reservation; a copy also lives in meta and is drawn down by fills.
+            Reservation reservation;
             OrderId id;
+            // Owned by market_dispatcher_, stable for the Exchange's lifetime.
+            const Market *market;
+            Quantity base_quantity;
             LimitOrderRequest order_request;
             OrderMeta meta;
+            // Reserved and settled by the market's worker (MarketLedger); the
+            // account and meta then hold no reservation.
+            bool sub_ledger{false};
+        };
+
+        struct PendingMarketOrder
+        {
+            Account *account;
+            Reservation reservation;
+            OrderId id;
+            const Market *market;
+            Side side;
+            Quantity order_quantity;
+            bool sub_ledger{false};
         };
 
-        std::expected<OrderPlacementResult, PlaceOrderError> execute_market_buy_by_quote(
+        struct PendingCancel
+        {
+            Account *account;
+            OrderId order_id;
+            OrderMeta order;
+            bool sub_ledger{false};
+        };
+
+        // Order entry is split into a begin step (validate, reserve, build the
+        // engine request) and a finish step (settle the engine result), so the
+        // blocking and coroutine APIs share one implementation.
+        std::expected<std::pair<PreparedLimitOrder, OrderRequest>, PlaceOrderError> begin_limit_order(
             const UserId user_id,
-            const Market &market,
-            const Quantity order_quantity);
-        std::expected<OrderPlacementResult, PlaceOrderError> execute_market_sell_by_base(
+            const MarketId market_id,
+            const Side side,
+            const Price price,
+            const Quantity quantity);
+        std::expected<OrderPlacementResult, PlaceOrderError> finish_limit_order(
+            const PreparedLimitOrder &order,
+            SubmitResult matching_result);
+        std::expected<std::pair<PendingMarketOrder, OrderRequest>, PlaceOrderError> begin_market_order(
             const UserId user_id,
-            const Market &market,
+            const MarketId market_id,
+            const Side side,
             const Quantity order_quantity);
+        std::expected<OrderPlacementResult, PlaceOrderError> finish_market_order(
+            const PendingMarketOrder &order,
+            SubmitResult matching_result);
+        std::expected<PendingCancel, CancelOrderError> begin_cancel(const UserId user_id, const OrderId order_id);
+        std::expected<CancelOrderResult, CancelOrderError> finish_cancel(
+            const PendingCancel &cancel,
+            CancelResultEx cancel_result);
+
+        OrderPlacementResult settle_market_buy_by_quote(
+            const PendingMarketOrder &order,
+            const std::vector<Execution> &executions);
+        OrderPlacementResult settle_market_sell_by_base(
+            const PendingMarketOrder &order,
+            const std::vector<Execution> &executions);
         std::optional<PlaceOrderError> validate_order(
             const UserId user_id,
-            const Market &market,
+            const Market *market,
             std::optional<Price> price,
             const Quantity quantity) const;
-        std::shared_ptr<Account> get_account(UserId id) const;
-        std::pair<std::shared_ptr<Account>, std::shared_ptr<Account>> get_accounts(UserId id_1, UserId id_2) const;
-        void settle_trade(Account &buyer, Account &seller, const Execution &execution, const Market &market);
+        // nullptr for an unknown user; never blocks.
+        Account *get_account(UserId id) const noexcept;
+
+        // Runs fn on the account's wallet: via Account::with_wallet, or on the
+        // owning ledger thread in WalletMode::Partitioned (waits for it).
+        template <typename Fn>
+        auto with_wallet(Account &account, Fn &&fn) const
+        {
+            if (ledger_)
+            {
+                return ledger_->call(
+                    ledger_->partition_of(account.id),
+                    [&]
+                    {
+                        return fn(std::get<Wallet>(account.wallet));
+                    });
+            }
+
+            return account.with_wallet(std::forward<Fn>(fn));
+        }
+
+        // Fills of one taker order against one counterparty user, summed so the
+        // pair is locked and settled once however many of its orders were hit.
+        struct CounterpartyFills
+        {
+            UserId user_id;
+            Account *account;
+            // Drawn from each filled counterparty order; all on one wallet slot.
+            Reservation funds;
+            // What the taker's reservation gives up for these fills.
+            Quantity taker_draw{0};
+            Quantity base_quantity{0};
+            Quantity quote_quantity{0};
+        };
+
+        struct SettlementBatch
+        {
+            Side taker_side;
+            Quantity taker_draw{0};
+            std::vector<CounterpartyFills> counterparties{};
+        };
+
+        // Draws the counterparty's reservation for one execution and adds it to
+        // that counterparty's entry, resolving the account on first sight.
+        void add_fill(SettlementBatch &batch, const Execution &execution);
+        // taker_funds must hold exactly batch.taker_draw. Each entry is settled
+        // under one account-pair lock; a buyer's surplus over the executed
+        // notional (price improvement) is released in the same step. In
+        // WalletMode::Partitioned each entry is instead two messages, buyer
+        // leg then seller leg, to the owning ledger threads; neither waits.
+        void settle_batch(Account &taker, Reservation taker_funds, SettlementBatch &batch, const Market &market);
+        // Request and meta for an order whose funds are already held (or held
+        // by the market's sub-ledger); takes a fresh order id.
+        PreparedLimitOrder build_limit_order(
+            Account &account,
+            Reservation reservation,
+            const UserId user_id,
+            const MarketId market_id,
+            const Market &market,
+            const Side side,
+            const Price price,
+            const Quantity quantity,
+            const bool sub_ledger);
         std::expected<PreparedLimitOrder, PlaceOrderError> prepare_and_reserve_limit_order(
             const UserId &user_id,
+            const MarketId market_id,
             const Market &market,
             const Side &side,
             const Price &price,
             const Quantity &quantity);
-        void rollback_release_or_assert(Account &account, const Asset &asset, const Quantity quantity, const std::string &context);
+        void rollback_release_or_assert(Account &account, Reservation reservation, const std::string &context);
         
         std::expected<std::vector<OrderRecord>, AnalyticsError> user_orders_snapshot(UserId user_id) const;
     public:
+        static constexpr std::size_t kMaxAccounts = AccountTable::kCapacity;
+
         Exchange() = default;
+        explicit Exchange(MarketDispatcherConfig dispatcher_config);
+        explicit Exchange(ExchangeConfig config);
 
         std::expected<UserId, UserError> create_user(std::string name);
         std::expected<std::string, UserError> get_user_name(const UserId user_id) const;
@@ -192,19 +407,92 @@ namespace vertex::application
         std::expected<Quantity, WalletOperationError> free_balance(const UserId user_id, const Asset &asset) const;
         std::expected<Quantity, WalletOperationError> reserved_balance(const UserId user_id, const Asset &asset) const;
 
+        // Sub-ledger markets (MarketWorkerConfig::sub_ledger) reserve, match and
+        // settle against balances held by the market's worker, not the main
+        // wallet. Funds move between the two only through these calls. Each
+        // holds the amount as reserved on the source until the destination
+        // has taken it, so a refused move leaves it where it was; allocation
+        // is one round trip to the worker, a return two.
+        std::expected<void, WalletOperationError> allocate_to_market(
+            const UserId user_id,
+            const MarketId market_id,
+            const Asset &asset,
+            const Quantity quantity);
+        std::expected<void, WalletOperationError> return_from_market(
+            const UserId user_id,
+            const MarketId market_id,
+            const Asset &asset,
+            const Quantity quantity);
+        std::expected<SubLedgerBalance, WalletOperationError> market_balance(const UserId user_id, const MarketId market_id);
+
+        // The Market overloads resolve the handle once and forward; hot callers
+        // should keep the MarketId returned by register_market.
         std::expected<OrderPlacementResult, PlaceOrderError> place_limit_order(
             const UserId user_id,
             const Market &market,
             const Side side,
             const Price price,
             const Quantity quantity);
+        std::expected<OrderPlacementResult, PlaceOrderError> place_limit_order(
+            const UserId user_id,
+            const MarketId market_id,
+            const Side side,
+            const Price price,
+            const Quantity quantity);
+        // Batch entry, e.g. a quote ladder. Orders are validated one by one,
+        // each account's reservations are taken under a single wallet lock,
+        // and each market gets the orders for it as one worker task, in input
+        // order. Once every market has answered the fills are settled. Results
+        // match orders by index; a failed order does not stop the others.
+        std::vector<std::expected<OrderPlacementResult, PlaceOrderError>> place_limit_orders(
+            std::span<const LimitOrderEntry> orders);
         std::expected<OrderPlacementResult, PlaceOrderError> execute_market_order(
             const UserId user_id,
             const Market &market,
             const Side side,
             const Quantity order_quantity);
+        std::expected<OrderPlacementResult, PlaceOrderError> execute_market_order(
+            const UserId user_id,
+            const MarketId market_id,
+            const Side side,
+            const Quantity order_quantity);
         std::expected<CancelOrderResult, CancelOrderError> cancel_order(const UserId user_id, const OrderId order_id);
-        std::expected<void, RegisterMarketError> register_market(const Market &market);
+
+        // Coroutine variants: `co_await` suspends until the market worker is done,
+        // then resumes on `io_pool` where settlement runs. Await the returned
+        // awaitable immediately; it must not outlive the Exchange.
+        PlaceOrderAwaitable place_limit_order_async(
+            IoThreadPool &io_pool,
+            const UserId user_id,
+            const Market &market,
+            const Side side,
+            const Price price,
+            const Quantity quantity);
+        PlaceOrderAwaitable place_limit_order_async(
+            IoThreadPool &io_pool,
+            const UserId user_id,
+            const MarketId market_id,
+            const Side side,
+            const Price price,
+            const Quantity quantity);
+        PlaceOrderAwaitable execute_market_order_async(
+            IoThreadPool &io_pool,
+            const UserId user_id,
+            const Market &market,
+            const Side side,
+            const Quantity order_quantity);
+        PlaceOrderAwaitable execute_market_order_async(
+            IoThreadPool &io_pool,
+            const UserId user_id,
+            const MarketId market_id,
+            const Side side,
+            const Quantity order_quantity);
+        CancelOrderAwaitable cancel_order_async(IoThreadPool &io_pool, const UserId user_id, const OrderId order_id);
+        // The first overload lists the market with a default MarketSpec (tick 1, lot 1).
+        std::expected<MarketId, RegisterMarketError> register_market(const Market &market, MarketWorkerConfig config = {});
+        std::expected<MarketId, RegisterMarketError> register_market(const Market &market, const MarketSpec &spec, MarketWorkerConfig config = {});
+        std::optional<MarketId> find_market_id(const Market &market) const;
+        std::optional<MarketWorkerPoolStats> market_pool_stats() const;
 
         std::expected<std::size_t, AnalyticsError> order_count_by_status(UserId user_id, OrderStatus status) const;
         std::expected<std::size_t, AnalyticsError> order_count_by_side(UserId user_id, Side side) const;
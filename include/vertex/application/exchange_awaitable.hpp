@@ -0,0 +1,78 @@
+#pragma once
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "vertex/application/io_thread_pool.hpp"
+#include "vertex/engine/market_worker.hpp"
+
+namespace vertex::application
+{
+    // Awaitable returned by the Exchange `*_async` APIs.
+    //
+    // await_suspend hands a continuation to the market worker; when the worker
+    // completes, the raw engine result is stored and the coroutine is posted to
+    // the IoThreadPool. await_resume then runs the settlement step on the pool
+    // thread. On a market with a settlement stage the settlement step runs in
+    // the completion itself (on the stage thread) and the coroutine resumes
+    // with its result. Requests rejected before reaching the engine are ready
+    // immediately.
+    template <typename EngineResult, typename Result>
+    class ExchangeAwaitable
+    {
+    public:
+        using Launch = std::move_only_function<void(vertex::engine::Completion<EngineResult>)>;
+        using Finish = std::move_only_function<Result(EngineResult)>;
+
+    private:
+        IoThreadPool *pool_{nullptr};
+        Launch launch_{};
+        Finish finish_{};
+        std::optional<EngineResult> engine_result_{};
+        std::optional<Result> ready_{};
+        bool finish_in_completion_{false};
+
+    public:
+        explicit ExchangeAwaitable(Result ready) : ready_(std::move(ready)) {}
+
+        ExchangeAwaitable(IoThreadPool &pool, Launch launch, Finish finish, bool finish_in_completion = false)
+            : pool_(&pool), launch_(std::move(launch)), finish_(std::move(finish)), finish_in_completion_(finish_in_completion)
+        {
+        }
+
+        ExchangeAwaitable(const ExchangeAwaitable &) = delete;
+        ExchangeAwaitable &operator=(const ExchangeAwaitable &) = delete;
+
+        bool await_ready() const noexcept
+        {
+            return ready_.has_value();
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            // The coroutine (and this awaitable) may be resumed and destroyed on a
+            // pool thread before launch returns, so launch runs from a local copy
+            // and nothing touches `this` afterwards.
+            Launch launch = std::move(launch_);
+            launch([this, handle](EngineResult result) mutable
+                   {
+                       if (finish_in_completion_)
+                           ready_.emplace(finish_(std::move(result)));
+                       else
+                           engine_result_.emplace(std::move(result));
+                       pool_->post(handle);
+                   });
+        }
+
+        Result await_resume()
+        {
+            if (ready_)
+                return std::move(*ready_);
+
+            return finish_(std::move(*engine_result_));
+        }
+    };
+
+} // namespace vertex::application
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace vertex::application
+{
+    // Small fixed pool of I/O threads that resumes suspended coroutines.
+    // Exchange awaitables hand their coroutine back to the pool once the
+    // market worker completes, so settlement runs on a pool thread.
+    class IoThreadPool
+    {
+    private:
+        std::queue<std::coroutine_handle<>> ready_{};
+        std::mutex mu_;
+        std::condition_variable cv_;
+        bool stopping_{false};
+        std::vector<std::thread> threads_;
+
+        void run();
+
+    public:
+        struct ScheduleAwaitable
+        {
+            IoThreadPool &pool;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { pool.post(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        explicit IoThreadPool(std::size_t thread_count);
+        ~IoThreadPool();
+        IoThreadPool(const IoThreadPool &) = delete;
+        IoThreadPool &operator=(const IoThreadPool &) = delete;
+        IoThreadPool(IoThreadPool &&) = delete;
+        IoThreadPool &operator=(IoThreadPool &&) = delete;
+
+        // Queues handle for resumption on a pool thread.
+        void post(std::coroutine_handle<> handle);
+        // `co_await pool.schedule()` moves the calling coroutine onto the pool.
+        ScheduleAwaitable schedule() noexcept { return ScheduleAwaitable{*this}; }
+        // Stops accepting new work; threads exit after draining queued handles.
+        void stop();
+        std::size_t thread_count() const noexcept { return threads_.size(); }
+    };
+
+    // Fire-and-forget coroutine type for client sessions driven by IoThreadPool.
+    struct DetachedTask
+    {
+        struct promise_type
+        {
+            DetachedTask get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+} // namespace vertex::application
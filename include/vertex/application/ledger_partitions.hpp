@@ -0,0 +1,107 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vertex/core/cache_line.hpp"
+#include "vertex/core/types.hpp"
+
+namespace vertex::application
+{
+    // Fixed set of ledger threads, each the single writer of the wallets of
+    // the users mapped to it (UserId modulo partition count).
+    //
+    // Wallet work is sent to the owning partition as a message and runs there
+    // in the order it was posted, so a wallet is never touched by two threads
+    // and needs no lock. post() is fire-and-forget; call() waits for the
+    // result.
+    class LedgerPartitions
+    {
+    public:
+        using Job = std::move_only_function<void()>;
+
+        explicit LedgerPartitions(std::size_t partition_count);
+        // Runs every posted job, then joins the threads.
+        ~LedgerPartitions();
+        LedgerPartitions(const LedgerPartitions &) = delete;
+        LedgerPartitions &operator=(const LedgerPartitions &) = delete;
+
+        std::size_t partition_count() const noexcept { return partitions_.size(); }
+        std::size_t partition_of(vertex::core::UserId user_id) const noexcept
+        {
+            return (user_id.get_value() - 1) % partitions_.size();
+        }
+
+        void post(std::size_t partition, Job job);
+
+        // Runs fn on the partition's thread and returns its result. Called
+        // from that thread itself, fn runs inline instead of deadlocking.
+        template <typename Fn>
+        std::invoke_result_t<Fn &> call(std::size_t partition, Fn &&fn);
+
+    private:
+        struct alignas(vertex::core::kCacheLineSize) Partition
+        {
+            std::mutex mu;
+            std::condition_variable cv;
+            std::queue<Job> jobs{};
+            bool stopping{false};
+            std::thread thread{};
+        };
+
+        std::vector<std::unique_ptr<Partition>> partitions_;
+
+        bool on_partition_thread(std::size_t partition) const noexcept;
+        void run(Partition &partition);
+    };
+
+    template <typename Fn>
+    std::invoke_result_t<Fn &> LedgerPartitions::call(std::size_t partition, Fn &&fn)
+    {
+        using Result = std::invoke_result_t<Fn &>;
+
+        if (on_partition_thread(partition))
+            return fn();
+
+        // Notified under the lock: the caller cannot return (and destroy
+        // these) until the ledger thread has released it.
+        std::mutex mu;
+        std::condition_variable cv;
+        std::optional<std::conditional_t<std::is_void_v<Result>, bool, Result>> result;
+        post(partition,
+             [&]
+             {
+                 auto value = [&]
+                 {
+                     if constexpr (std::is_void_v<Result>)
+                     {
+                         fn();
+                         return true;
+                     }
+                     else
+                     {
+                         return fn();
+                     }
+                 }();
+                 std::lock_guard lock(mu);
+                 result.emplace(std::move(value));
+                 cv.notify_one();
+             });
+
+        std::unique_lock lock(mu);
+        cv.wait(lock, [&result]
+                { return result.has_value(); });
+
+        if constexpr (!std::is_void_v<Result>)
+            return std::move(*result);
+    }
+} // namespace vertex::application
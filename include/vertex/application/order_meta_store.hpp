@@ -1,6 +1,7 @@
 #pragma once
 #include "vertex/core/types.hpp"
 #include "vertex/application/order_history.hpp"
+#include "vertex/domain/reservation.hpp"
 #include <array>
 #include <unordered_map>
 #include <mutex>
@@ -11,15 +12,17 @@ namespace vertex::application
     using UserId = vertex::core::UserId;
     using OrderId = vertex::core::OrderId;
     using Market = vertex::core::Market;
+    using MarketId = vertex::core::MarketId;
     using Side = vertex::core::Side;
     using Price = vertex::core::Price;
     using TradeId = vertex::core::TradeId;
     using Quantity = vertex::core::Quantity;
+    using Reservation = vertex::domain::Reservation;
 
     struct OrderMeta
     {
         UserId owner;
-        Market market;
+        MarketId market;
         Side side;
 
         Price price;
@@ -30,6 +33,14 @@ namespace vertex::application
 
         std::size_t fill_count{0};
         std::vector<TradeId> trade_ids{};
+
+        // Funds still held for this order; fills and cancel draw from it.
+        Reservation reservation{};
+
+        // Set once the order is filled or canceled while fills matched before
+        // that still have their share to draw. A closed meta is invisible to
+        // everything but draw_reservation and goes with its last draw.
+        bool closed{false};
     };
 
     class OrderMetaStoreTestAccess;
@@ -56,7 +67,13 @@ namespace vertex::application
         bool try_insert(OrderId id, OrderMeta meta);
         std::optional<OrderMeta> find(OrderId) const;
         bool erase(OrderId id);
-        std::optional<OrderRecord> close_and_extract(OrderId order_id, OrderStatus status);
+        // OrderRecord keeps the full Market; the caller resolves meta.market.
+        // Funds still in the reservation stay drawable until they are drawn.
+        std::optional<OrderRecord> close_and_extract(OrderId order_id, OrderStatus status, const Market &market);
         bool append_fill(OrderId id, TradeId trade_id, Quantity qty, Price price);
+        // Splits amount off the order's reservation, closed or not; nullopt if
+        // the order is gone.
+        std::optional<Reservation> draw_reservation(OrderId id, Quantity amount);
+        std::optional<Quantity> reserved_remaining(OrderId id) const;
     };
 }
@@ -3,39 +3,97 @@
 #include <cassert>
 #include <cctype>
 #include <compare>
+#include <cstdio>
+#include <cstdlib>
+#include <expected>
 #include <functional>
+#include <optional>
 #include <string>
+#include <utility>
+#include "vertex/core/asset_registry.hpp"
 
 namespace vertex::core
 {
 
+    // Interned asset: holds only its AssetId, so copies, equality and hashing
+    // never touch the name. Ordering still follows the name.
+    //
+    // The constructor interns and is meant for names the program itself
+    // supplies; if the registry is full it aborts the process. Untrusted
+    // input goes through intern() (reports CapacityExhausted) or, when the
+    // name only needs to be looked up, find().
     template <typename Tag>
     class StrongAsset
     {
     private:
-        std::string name_;
+        AssetId id_;
+
+        explicit StrongAsset(AssetId id) noexcept : id_(id) {}
+        static std::string normalize(std::string name);
 
     public:
         explicit StrongAsset(std::string name);
+        static std::expected<StrongAsset, AssetRegistryError> intern(std::string name);
+        static std::optional<StrongAsset> find(std::string name);
         const std::string &value() const noexcept;
-        auto operator<=>(const StrongAsset &other) const = default;
+        AssetId id() const noexcept { return id_; }
+        bool operator==(const StrongAsset &other) const noexcept = default;
+        std::strong_ordering operator<=>(const StrongAsset &other) const noexcept;
     };
 
     template <typename Tag>
-    StrongAsset<Tag>::StrongAsset(std::string name)
+    std::string StrongAsset<Tag>::normalize(std::string name)
     {
         assert(!name.empty());
 
         std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c)
                        { return std::toupper(c); });
+        return name;
+    }
 
-        name_ = std::move(name);
-    };
+    template <typename Tag>
+    StrongAsset<Tag>::StrongAsset(std::string name)
+    {
+        const auto id = AssetRegistry::instance().intern(normalize(std::move(name)));
+        if (!id)
+        {
+            std::fputs("vertex: asset registry capacity exhausted; use Asset::intern for untrusted names\n", stderr);
+            std::abort();
+        }
+        id_ = *id;
+    }
+
+    template <typename Tag>
+    std::expected<StrongAsset<Tag>, AssetRegistryError> StrongAsset<Tag>::intern(std::string name)
+    {
+        auto id = AssetRegistry::instance().intern(normalize(std::move(name)));
+        if (!id)
+            return std::unexpected(id.error());
+        return StrongAsset{*id};
+    }
+
+    template <typename Tag>
+    std::optional<StrongAsset<Tag>> StrongAsset<Tag>::find(std::string name)
+    {
+        auto id = AssetRegistry::instance().find(normalize(std::move(name)));
+        if (!id)
+            return std::nullopt;
+        return StrongAsset{*id};
+    }
 
     template <typename Tag>
     const std::string &StrongAsset<Tag>::value() const noexcept
     {
-        return name_;
+        return AssetRegistry::instance().name(id_);
+    }
+
+    template <typename Tag>
+    std::strong_ordering StrongAsset<Tag>::operator<=>(const StrongAsset &other) const noexcept
+    {
+        if (id_ == other.id_)
+            return std::strong_ordering::equal;
+
+        return value() <=> other.value();
     }
 }
 
@@ -46,7 +104,7 @@ namespace std
     {
         size_t operator()(const vertex::core::StrongAsset<Tag> &id) const noexcept
         {
-            return std::hash<std::string>{}(id.value());
+            return std::hash<vertex::core::AssetId>{}(id.id());
         }
     };
-}
\ No newline at end of file
+}
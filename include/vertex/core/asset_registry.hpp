@@ -0,0 +1,98 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <expected>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "vertex/core/segmented_table.hpp"
+#include "vertex/core/strong_id.hpp"
+
+namespace vertex::core
+{
+    struct AssetIdTag
+    {
+    };
+    // Dense handle of an interned asset name, starting at 1.
+    using AssetId = StrongId<AssetIdTag>;
+
+    enum class AssetRegistryError
+    {
+        // The registry already holds its maximum number of names.
+        CapacityExhausted
+    };
+
+    // Process-wide intern table for asset names.
+    //
+    // intern() and find() are the only paths that hash a string; they run
+    // when an Asset is built at the API/CLI boundary. Names are never
+    // removed, so read-only callers (balance queries, unknown input) should
+    // use find(), which never adds one. name() is a lock-free index and the
+    // returned reference stays valid for the life of the process.
+    class AssetRegistry
+    {
+    public:
+        static constexpr std::size_t kMaxNames = SegmentedTable<std::string>::kCapacity;
+
+        static AssetRegistry &instance()
+        {
+            static AssetRegistry registry;
+            return registry;
+        }
+
+        // Standalone registries (e.g. tests) may cap the name count lower.
+        explicit AssetRegistry(std::size_t max_names = kMaxNames) : max_names_(max_names < kMaxNames ? max_names : kMaxNames) {}
+        AssetRegistry(const AssetRegistry &) = delete;
+        AssetRegistry &operator=(const AssetRegistry &) = delete;
+
+        // name must already be normalized.
+        std::expected<AssetId, AssetRegistryError> intern(const std::string &name)
+        {
+            if (auto id = find(name))
+                return *id;
+
+            std::lock_guard lock(mutex_);
+            auto it = ids_.find(name);
+            if (it != ids_.end())
+                return it->second;
+
+            if (names_.size() >= max_names_)
+                return std::unexpected(AssetRegistryError::CapacityExhausted);
+
+            const auto index = names_.emplace_back(name);
+            if (!index)
+                return std::unexpected(AssetRegistryError::CapacityExhausted);
+
+            const AssetId id{*index + 1};
+            ids_.emplace(name, id);
+            return id;
+        }
+
+        // name must already be normalized; nullopt if it was never interned.
+        std::optional<AssetId> find(const std::string &name) const
+        {
+            std::shared_lock lock(mutex_);
+            auto it = ids_.find(name);
+            if (it == ids_.end())
+                return std::nullopt;
+            return it->second;
+        }
+
+        const std::string &name(AssetId id) const noexcept
+        {
+            const std::string *name = names_.find(id.get_value() - 1);
+            assert(name != nullptr && "Invariant violated: asset id was never interned");
+            return *name;
+        }
+
+        std::size_t size() const noexcept { return names_.size(); }
+
+    private:
+        const std::size_t max_names_;
+        SegmentedTable<std::string> names_{};
+        std::unordered_map<std::string, AssetId> ids_{};
+        mutable std::shared_mutex mutex_;
+    };
+} // namespace vertex::core
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+
+namespace vertex::core
+{
+    // Destructive interference size assumed for alignment of data written by
+    // different threads (x86-64 and most AArch64 parts).
+    inline constexpr std::size_t kCacheLineSize = 64;
+} // namespace vertex::core
@@ -9,25 +9,51 @@ namespace vertex::core
 {
     template<typename>
     struct is_strong_id : std::false_type {}; //default, for all types is_strong_id = false
-    
+
     template<typename Tag>
     struct is_strong_id<StrongId<Tag>> : std::true_type{}; //for StrongId<Tag> types is_strong_id = true
-    
 
+    namespace detail
+    {
+        // Process-wide number identifying an IdGenerator in thread-local lease caches.
+        inline std::uint64_t next_generator_instance() noexcept
+        {
+            static std::atomic<std::uint64_t> instances{0};
+            return instances.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+    } // namespace detail
 
+    // Source of unique ids starting at 1.
+    //
+    // next() hands out one id per atomic increment and keeps ids dense.
+    // Hot paths lease blocks instead (next_local(), IdLease), so the shared
+    // counter is touched once per block; ids stay unique but leave gaps and
+    // are only ordered per lease holder.
     template <typename T>
     class IdGenerator
     {
         static_assert(
-            is_strong_id<T>::value, 
+            is_strong_id<T>::value,
             "T must be StrongId");   //check of template typename
 
     private:
         std::atomic<std::uint64_t> counter{0};
+        const std::uint64_t instance_{detail::next_generator_instance()};
 
     public:
+        static constexpr std::uint64_t kLeaseSize = 64;
+
         IdGenerator() = default;
+        IdGenerator(const IdGenerator &) = delete;
+        IdGenerator &operator=(const IdGenerator &) = delete;
+
         T next();
+        // Reserves count consecutive ids and returns the first one's value.
+        std::uint64_t lease(std::uint64_t count);
+        // Next id from the calling thread's block of kLeaseSize. One block is
+        // cached per thread and id type; switching generators on a thread
+        // abandons the rest of the cached block.
+        T next_local();
     };
 
     template <typename T>
@@ -37,4 +63,55 @@ namespace vertex::core
         return T{value};
     }
 
+    template <typename T>
+    std::uint64_t IdGenerator<T>::lease(std::uint64_t count)
+    {
+        return counter.fetch_add(count, std::memory_order_relaxed) + 1;
+    }
+
+    template <typename T>
+    T IdGenerator<T>::next_local()
+    {
+        struct Block
+        {
+            std::uint64_t instance{0};
+            std::uint64_t next{0};
+            std::uint64_t end{0};
+        };
+        thread_local Block block;
+
+        if (block.instance != instance_ || block.next == block.end)
+        {
+            block.instance = instance_;
+            block.next = lease(kLeaseSize);
+            block.end = block.next + kLeaseSize;
+        }
+        return T{block.next++};
+    }
+
+    // Single-owner cursor over blocks leased from an IdGenerator; ids it
+    // returns are strictly increasing. Not thread-safe: one holder (e.g. a
+    // market worker) uses it at a time.
+    template <typename T>
+    class IdLease
+    {
+    private:
+        IdGenerator<T> *generator_;
+        std::uint64_t next_{0};
+        std::uint64_t end_{0};
+
+    public:
+        explicit IdLease(IdGenerator<T> &generator) : generator_(&generator) {}
+
+        T next()
+        {
+            if (next_ == end_)
+            {
+                next_ = generator_->lease(IdGenerator<T>::kLeaseSize);
+                end_ = next_ + IdGenerator<T>::kLeaseSize;
+            }
+            return T{next_++};
+        }
+    };
+
 } // namespace vertex::core
@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 #include <compare>
+#include <cstdint>
 #include <functional>
 #include <utility>
 #include "vertex/core/asset.hpp"
@@ -43,9 +44,15 @@ namespace std
     {
         size_t operator()(const vertex::core::Market &id) const noexcept
         {
-            auto h1 = std::hash<vertex::core::Asset>{}(id.base());
-            auto h2 = std::hash<vertex::core::Asset>{}(id.quote());
-            return h1 ^ (h2 << 1);
+            // Asset hashes are small dense ids, so mix the pair (splitmix64
+            // finalizer) to spread it over every bit, not just the low ones.
+            std::uint64_t h = (id.base().id().get_value() << 32) ^ id.quote().id().get_value();
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebULL;
+            h ^= h >> 31;
+            return static_cast<size_t>(h);
         }
     };
 }
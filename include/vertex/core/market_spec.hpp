@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include "vertex/core/notional.hpp"
+#include "vertex/core/types.hpp"
+
+namespace vertex::core
+{
+    // Price as a count of ticks and quantity as a count of lots; the engine
+    // stores resting orders in these units.
+    using Ticks = std::uint32_t;
+    using Lots = std::uint32_t;
+
+    // Trading rules fixed when a market is registered. Prices must be
+    // multiples of tick_size inside [lowest_price(), highest_price()];
+    // base quantities must be multiples of lot_size and at most kMaxLots lots.
+    struct MarketSpec
+    {
+        static constexpr Ticks kMaxTicks = std::numeric_limits<Ticks>::max();
+        static constexpr Lots kMaxLots = std::numeric_limits<Lots>::max();
+
+        Price tick_size{1};
+        Quantity lot_size{1};
+        // 0 means one tick.
+        Price min_price{0};
+        // 0 means as high as kMaxTicks ticks reach.
+        Price max_price{0};
+
+        constexpr Price lowest_price() const noexcept
+        {
+            return min_price != 0 ? min_price : tick_size;
+        }
+
+        constexpr Price highest_price() const noexcept
+        {
+            if (max_price != 0)
+                return max_price;
+            const auto widest = checked_notional(tick_size, kMaxTicks);
+            return widest ? *widest : (std::numeric_limits<Price>::max() / tick_size) * tick_size;
+        }
+
+        constexpr bool is_valid() const noexcept
+        {
+            if (tick_size <= 0 || lot_size <= 0 || min_price < 0 || max_price < 0)
+                return false;
+            if (!checked_notional(lot_size, kMaxLots))
+                return false;
+
+            const Price low = lowest_price();
+            const Price high = highest_price();
+            return low <= high && low % tick_size == 0 && high % tick_size == 0 &&
+                   high / tick_size <= kMaxTicks;
+        }
+
+        constexpr bool is_on_tick(Price price) const noexcept { return price % tick_size == 0; }
+        constexpr bool is_in_band(Price price) const noexcept { return price >= lowest_price() && price <= highest_price(); }
+        constexpr bool is_on_lot(Quantity quantity) const noexcept { return quantity % lot_size == 0; }
+        constexpr bool fits_lots(Quantity quantity) const noexcept { return quantity / lot_size <= kMaxLots; }
+
+        // Conversions assume a validated order; off-grid values are a caller bug.
+        constexpr Ticks to_ticks(Price price) const noexcept
+        {
+            assert(price > 0 && is_on_tick(price) && price / tick_size <= kMaxTicks &&
+                   "Invariant violated: price is not representable in ticks");
+            return static_cast<Ticks>(price / tick_size);
+        }
+
+        constexpr Price to_price(Ticks ticks) const noexcept
+        {
+            return static_cast<Price>(ticks) * tick_size;
+        }
+
+        constexpr Lots to_lots(Quantity quantity) const noexcept
+        {
+            assert(quantity >= 0 && is_on_lot(quantity) && fits_lots(quantity) &&
+                   "Invariant violated: quantity is not representable in lots");
+            return static_cast<Lots>(quantity / lot_size);
+        }
+
+        constexpr Quantity to_quantity(Lots lots) const noexcept
+        {
+            return static_cast<Quantity>(lots) * lot_size;
+        }
+    };
+} // namespace vertex::core
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "vertex/core/types.hpp"
+
+namespace vertex::core
+{
+    // Price and Quantity stay plain int64 minimal units; every product of the
+    // two is checked so fine ticks cannot wrap silently. On GCC/Clang the
+    // product goes through a 128-bit intermediate (one widening multiply plus
+    // a range check); other compilers use a wrap-and-divide check.
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef __int128 WideQuantity;
+#endif
+
+    // nullopt if price * quantity does not fit in a Quantity.
+    constexpr std::optional<Quantity> checked_notional(Price price, Quantity quantity) noexcept
+    {
+        constexpr Quantity kMin = std::numeric_limits<Quantity>::min();
+        constexpr Quantity kMax = std::numeric_limits<Quantity>::max();
+#if defined(__SIZEOF_INT128__)
+        const WideQuantity wide = static_cast<WideQuantity>(price) * quantity;
+        if (wide < kMin || wide > kMax)
+            return std::nullopt;
+        return static_cast<Quantity>(wide);
+#else
+        if (price == -1)
+            return quantity == kMin ? std::nullopt : std::optional<Quantity>(-quantity);
+        const auto product = static_cast<Quantity>(static_cast<std::uint64_t>(price) * static_cast<std::uint64_t>(quantity));
+        if (price != 0 && product / price != quantity)
+            return std::nullopt;
+        (void)kMax;
+        return product;
+#endif
+    }
+
+    // For amounts already bounded by a checked reservation (fills, cancels).
+    constexpr Quantity notional(Price price, Quantity quantity) noexcept
+    {
+        const auto result = checked_notional(price, quantity);
+        assert(result.has_value() && "Invariant violated: notional exceeds a checked reservation");
+        return *result;
+    }
+
+    // nullopt if lhs + rhs does not fit in a Quantity.
+    constexpr std::optional<Quantity> checked_add(Quantity lhs, Quantity rhs) noexcept
+    {
+        if ((rhs > 0 && lhs > std::numeric_limits<Quantity>::max() - rhs) ||
+            (rhs < 0 && lhs < std::numeric_limits<Quantity>::min() - rhs))
+            return std::nullopt;
+        return lhs + rhs;
+    }
+} // namespace vertex::core
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace vertex::core
+{
+    // Append-only table indexed by a dense integer, with lock-free reads.
+    //
+    // Elements live in fixed-size segments that are allocated on demand and
+    // never move, so pointers returned by find() stay valid for the table's
+    // lifetime. Appends must be serialized by the caller; an element becomes
+    // visible to find() only after it is fully constructed.
+    template <typename T, std::size_t SegmentBits = 10, std::size_t MaxSegments = 1024>
+    class SegmentedTable
+    {
+    public:
+        static constexpr std::size_t kSegmentSize = std::size_t{1} << SegmentBits;
+        static constexpr std::size_t kCapacity = kSegmentSize * MaxSegments;
+
+        SegmentedTable() = default;
+        ~SegmentedTable();
+        SegmentedTable(const SegmentedTable &) = delete;
+        SegmentedTable &operator=(const SegmentedTable &) = delete;
+        SegmentedTable(SegmentedTable &&) = delete;
+        SegmentedTable &operator=(SegmentedTable &&) = delete;
+
+        // Writer side. Returns the new element's index, or nullopt when full.
+        template <typename... Args>
+        std::optional<std::size_t> emplace_back(Args &&...args);
+
+        T *find(std::size_t index) noexcept;
+        const T *find(std::size_t index) const noexcept;
+        std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+    private:
+        std::array<std::atomic<T *>, MaxSegments> segments_{};
+        std::atomic<std::size_t> size_{0};
+    };
+
+    template <typename T, std::size_t SegmentBits, std::size_t MaxSegments>
+    SegmentedTable<T, SegmentBits, MaxSegments>::~SegmentedTable()
+    {
+        const std::size_t count = size_.load(std::memory_order_relaxed);
+        for (std::size_t i = count; i > 0; --i)
+        {
+            std::destroy_at(find(i - 1));
+        }
+
+        std::allocator<T> allocator;
+        for (auto &segment : segments_)
+        {
+            T *storage = segment.load(std::memory_order_relaxed);
+            if (storage == nullptr)
+                break;
+            allocator.deallocate(storage, kSegmentSize);
+        }
+    }
+
+    template <typename T, std::size_t SegmentBits, std::size_t MaxSegments>
+    template <typename... Args>
+    std::optional<std::size_t> SegmentedTable<T, SegmentBits, MaxSegments>::emplace_back(Args &&...args)
+    {
+        const std::size_t index = size_.load(std::memory_order_relaxed);
+        if (index >= kCapacity)
+            return std::nullopt;
+
+        std::atomic<T *> &segment = segments_[index >> SegmentBits];
+        T *storage = segment.load(std::memory_order_relaxed);
+        if (storage == nullptr)
+        {
+            storage = std::allocator<T>{}.allocate(kSegmentSize);
+            segment.store(storage, std::memory_order_release);
+        }
+
+        std::construct_at(storage + (index & (kSegmentSize - 1)), std::forward<Args>(args)...);
+        size_.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+    template <typename T, std::size_t SegmentBits, std::size_t MaxSegments>
+    T *SegmentedTable<T, SegmentBits, MaxSegments>::find(std::size_t index) noexcept
+    {
+        return const_cast<T *>(std::as_const(*this).find(index));
+    }
+
+    template <typename T, std::size_t SegmentBits, std::size_t MaxSegments>
+    const T *SegmentedTable<T, SegmentBits, MaxSegments>::find(std::size_t index) const noexcept
+    {
+        if (index >= size_.load(std::memory_order_acquire))
+            return nullptr;
+
+        const T *storage = segments_[index >> SegmentBits].load(std::memory_order_acquire);
+        assert(storage != nullptr && "Invariant violated: published index without a segment");
+        return storage + (index & (kSegmentSize - 1));
+    }
+
+} // namespace vertex::core
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "vertex/core/cache_line.hpp"
+
+namespace vertex::core
+{
+    // Bounded lock-free ring for one producer and one consumer.
+    //
+    // Producer and consumer may change threads as long as a hand-over is
+    // ordered by other synchronization (e.g. a mutex). Indices only grow;
+    // the slot is the index masked by the power-of-two capacity. Head and
+    // tail sit on separate cache lines so the two sides do not share one.
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        // capacity is rounded up to a power of two.
+        explicit SpscQueue(std::size_t capacity)
+            : slots_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)), mask_(slots_.size() - 1)
+        {
+        }
+
+        SpscQueue(const SpscQueue &) = delete;
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        std::size_t capacity() const noexcept { return slots_.size(); }
+
+        // Producer side. Returns false (value untouched) when the ring is full.
+        bool try_push(T &&value)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ == slots_.size())
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ == slots_.size())
+                    return false;
+            }
+
+            slots_[tail & mask_].emplace(std::move(value));
+            tail_.store(tail + 1, std::memory_order_release);
+            tail_.notify_one();
+            return true;
+        }
+
+        // Consumer side.
+        std::optional<T> try_pop()
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cached_tail_)
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head == cached_tail_)
+                    return std::nullopt;
+            }
+
+            std::optional<T> &slot = slots_[head & mask_];
+            std::optional<T> value{std::move(slot)};
+            slot.reset();
+            head_.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+        // Consumer side: blocks while the ring is empty.
+        void wait_while_empty() const
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            tail_.wait(head, std::memory_order_acquire);
+        }
+
+    private:
+        std::vector<std::optional<T>> slots_;
+        const std::size_t mask_;
+
+        // Consumer line: head_ and its last view of tail_, refreshed only when
+        // the ring looks empty.
+        alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+        std::size_t cached_tail_{0};
+
+        // Producer line: tail_ and its last view of head_, refreshed only when
+        // the ring looks full.
+        alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+        std::size_t cached_head_{0};
+    };
+} // namespace vertex::core
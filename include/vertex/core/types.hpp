@@ -13,10 +13,13 @@ namespace vertex::core{
     struct OrderTag{};
     struct TradeTag{};
     struct AssetTag {};
+    struct MarketTag{};
 
     using UserId = StrongId<UserTag>;
     using OrderId = StrongId<OrderTag>;
     using TradeId = StrongId<TradeTag>;
+    // Dense handle issued by MarketDispatcher::register_market, starting at 1.
+    using MarketId = StrongId<MarketTag>;
     
     using Asset = StrongAsset<AssetTag>;
     using Price = std::int64_t; //price in small currency unit
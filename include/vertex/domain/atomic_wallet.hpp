@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include "vertex/core/types.hpp"
+#include "vertex/domain/wallet.hpp"
+
+namespace vertex::domain
+{
+    // Wallet variant that is safe to share between threads without an
+    // external lock. Each free/reserved counter is updated with a CAS loop
+    // that refuses to go below zero; a transfer between the two (reserve,
+    // release) debits first and credits second, so no counter is ever
+    // negative, although a concurrent reader may briefly see the amount in
+    // neither. Deposit bounds the slot's held total (see AtomicBalance)
+    // rather than free + reserved, which it cannot read atomically. Same
+    // error semantics as Wallet.
+    //
+    // Inline slots are probed like Wallet's; a first deposit claims one with a
+    // CAS on its asset id. Balance updates are lock-free only for those first
+    // kInlineAssets assets the wallet holds. A spilled asset takes a
+    // shared_mutex to find its slot on every call, exclusively on its first
+    // deposit.
+    class AtomicWallet
+    {
+    public:
+        static constexpr std::size_t kInlineAssets = Wallet::kInlineAssets;
+
+    private:
+        struct InlineSlot
+        {
+            // AssetId value; 0 while the slot is free.
+            std::atomic<std::uint64_t> asset{0};
+            AtomicBalance balance{};
+        };
+
+        std::array<InlineSlot, kInlineAssets> inline_slots_{};
+        std::unordered_map<vertex::core::AssetId, std::unique_ptr<AtomicBalance>> spilled_balances_{};
+        mutable std::shared_mutex spilled_mu_;
+
+        // nullptr if the asset was never deposited.
+        AtomicBalance *find(const Asset &asset) noexcept;
+        const AtomicBalance *find(const Asset &asset) const noexcept;
+        AtomicBalance &find_or_create(const Asset &asset);
+
+    public:
+        AtomicWallet() = default;
+        AtomicWallet(const AtomicWallet &) = delete;
+        AtomicWallet &operator=(const AtomicWallet &) = delete;
+
+        std::expected<void, WalletError> deposit(const Asset &asset, const Quantity amount);
+        std::expected<void, WalletError> withdraw(const Asset &asset, const Quantity amount);
+        std::expected<Reservation, WalletError> reserve(const Asset &asset, const Quantity amount);
+        std::expected<void, WalletError> release(const Asset &asset, const Quantity amount);
+        std::expected<void, WalletError> consume_reserved(const Asset &asset, Quantity amount);
+        std::expected<void, WalletError> release(Reservation &reservation, const Quantity amount);
+        std::expected<void, WalletError> consume_reserved(Reservation &reservation, Quantity amount);
+        Quantity free_balance(const Asset &asset) const;
+        Quantity reserved_balance(const Asset &asset) const;
+    };
+} // namespace vertex::domain
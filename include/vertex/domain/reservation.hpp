@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <variant>
+#include "vertex/core/types.hpp"
+
+namespace vertex::domain
+{
+    struct Balance
+    {
+        vertex::core::Quantity free{0};
+        vertex::core::Quantity reserved{0};
+    };
+
+    // held is free + reserved plus whatever a reserve/release has debited
+    // from one counter and not yet credited to the other. Only deposit raises
+    // it and it is raised before free, so free + reserved <= held <= the
+    // Quantity range under any interleaving.
+    struct AtomicBalance
+    {
+        std::atomic<vertex::core::Quantity> free{0};
+        std::atomic<vertex::core::Quantity> reserved{0};
+        std::atomic<vertex::core::Quantity> held{0};
+    };
+
+    // Funds reserved on one wallet slot, carried with the order that reserved
+    // them. Wallet slots never move, so release/consume through a handle skip
+    // the asset lookup. remaining is this handle's share of the slot's
+    // reserved balance, not the slot total.
+    struct Reservation
+    {
+        std::variant<std::monostate, Balance *, AtomicBalance *> slot{};
+        vertex::core::Quantity remaining{0};
+
+        // Moves amount out of this handle into a new one on the same slot.
+        Reservation split(vertex::core::Quantity amount) noexcept
+        {
+            assert(0 <= amount && amount <= remaining && "Invariant violated: reservation split exceeds remaining");
+            remaining -= amount;
+            return Reservation{slot, amount};
+        }
+
+        // Folds other into this handle; both must be on the same slot unless
+        // one of them is empty.
+        void absorb(Reservation other) noexcept
+        {
+            if (std::holds_alternative<std::monostate>(slot))
+                slot = other.slot;
+            assert((std::holds_alternative<std::monostate>(other.slot) || slot == other.slot) &&
+                   "Invariant violated: absorbing a reservation on another slot");
+            remaining += other.remaining;
+        }
+    };
+} // namespace vertex::domain
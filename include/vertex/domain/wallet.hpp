@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <unordered_map>
 #include <expected>
 #include "vertex/core/types.hpp"
+#include "vertex/domain/reservation.hpp"
 
 namespace vertex::domain
 {
@@ -12,27 +15,47 @@ namespace vertex::domain
     {
         InsufficientFunds,
         InsufficientReserved,
-        InvalidAmount
-    };
-
-    struct Balance
-    {
-        vertex::core::Quantity free{0};
-        vertex::core::Quantity reserved{0};
+        InvalidAmount,
+        // Deposit would push free + reserved past the Quantity range.
+        BalanceOverflow
     };
 
+    // The first kInlineAssets assets this wallet holds live in a small inline
+    // array, placed by linear probing from AssetId % kInlineAssets; further
+    // assets spill to a sparse map. A slot is claimed on first deposit and
+    // never cleared, so an empty slot on the probe path means the asset was
+    // never deposited, inline or spilled.
     class Wallet
     {
+    public:
+        static constexpr std::size_t kInlineAssets = 4;
+
     private:
-        std::unordered_map<Asset, Balance> balances_{};
+        struct InlineSlot
+        {
+            vertex::core::AssetId asset{};
+            Balance balance{};
+        };
+
+        std::array<InlineSlot, kInlineAssets> inline_slots_{};
+        std::unordered_map<vertex::core::AssetId, Balance> spilled_balances_{};
+
+        // nullptr if the asset was never deposited.
+        Balance *find(const Asset &asset) noexcept;
+        const Balance *find(const Asset &asset) const noexcept;
+        Balance &find_or_create(const Asset &asset);
 
     public:
         Wallet() = default;
         std::expected<void, WalletError> deposit(const Asset &asset, const Quantity amount);
         std::expected<void, WalletError> withdraw(const Asset &asset, const Quantity amount);
-        std::expected<void, WalletError> reserve(const Asset &asset, const Quantity amount);
+        std::expected<Reservation, WalletError> reserve(const Asset &asset, const Quantity amount);
         std::expected<void, WalletError> release(const Asset &asset, const Quantity amount);
         std::expected<void, WalletError> consume_reserved(const Asset& asset, Quantity amount);
+        // Handle overloads: reservation must come from this wallet's reserve();
+        // amount is taken from reservation.remaining.
+        std::expected<void, WalletError> release(Reservation &reservation, const Quantity amount);
+        std::expected<void, WalletError> consume_reserved(Reservation &reservation, Quantity amount);
         Quantity free_balance(const Asset &asset) const;
         Quantity reserved_balance(const Asset &asset) const;
     };
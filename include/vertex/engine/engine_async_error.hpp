@@ -6,6 +6,14 @@ namespace vertex::engine
         WorkerStopped,
         MarketAlreadyRegistered,
         MarketNotFound,
+        Overloaded,
+        InvalidMarketSpec,
+        // register_market: the dispatcher's market table is full.
+        CapacityExhausted,
+        // Sub-ledger markets only (MarketWorkerConfig::sub_ledger).
+        InsufficientFunds,
+        BalanceOverflow,
+        NoSubLedger,
     };
 
 }
@@ -1,39 +1,97 @@
 #pragma once
+#include <atomic>
 #include <expected>
 #include <future>
-#include <unordered_map>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
+#include <optional>
 #include <vector>
+#include <vertex/core/segmented_table.hpp>
+#include <vertex/engine/market_routing_table.hpp>
 #include <vertex/engine/market_worker.hpp>
+#include <vertex/engine/market_worker_pool.hpp>
 #include <vertex/engine/engine_async_error.hpp>
 
 namespace vertex::engine
 {
+    struct MarketDispatcherConfig
+    {
+        // 0 keeps one dedicated thread per market; otherwise all markets share
+        // a MarketWorkerPool with this many threads.
+        std::size_t pool_threads{0};
+        std::size_t pool_batch_size{MarketWorkerPool::kDefaultBatchSize};
+        // 0 disables work stealing between pool threads.
+        std::size_t pool_steal_threshold{MarketWorkerPool::kDefaultStealThreshold};
+    };
+
     class MarketDispatcher
     {
     private:
-        std::unordered_map<Market, std::shared_ptr<MarketWorker>> workers_{};
-        mutable std::shared_mutex workers_mutex_;
-        bool stopping_{false};
-        
-        Market market_of(const OrderRequest &);
+        struct MarketSlot
+        {
+            Market market;
+            MarketSpec spec;
+            std::unique_ptr<MarketWorker> worker;
+        };
 
-        template <typename T>
-        std::future<std::expected<T, EngineAsyncError>> make_ready_future_error(EngineAsyncError error);
+        // Shared by every market; each worker leases blocks of trade ids from it.
+        TradeIdGenerator trade_ids_{};
+        // Declared before markets_ so pooled workers are destroyed first.
+        std::unique_ptr<MarketWorkerPool> pool_{};
+        // Slot i belongs to MarketId{i + 1}; only appended to, so lookups are a lock-free index.
+        vertex::core::SegmentedTable<MarketSlot> markets_{};
+        // Market -> MarketId for the string-keyed overloads; lock-free as well.
+        MarketRoutingTable routes_{};
+        // Serializes register_market and stop_all.
+        std::mutex workers_mutex_;
+        std::atomic<bool> stopping_{false};
+
+        static MarketId market_of(const OrderRequest &) noexcept;
+        std::expected<MarketWorker *, EngineAsyncError> find_worker(MarketId market_id) const noexcept;
+        std::expected<MarketWorker *, EngineAsyncError> find_worker(const Market &market) const noexcept;
 
     public:
-        MarketDispatcher() = default;
+        explicit MarketDispatcher(MarketDispatcherConfig config = {});
         ~MarketDispatcher();
 
-        std::expected<void, EngineAsyncError> register_market(const Market &market);
+        std::expected<MarketId, EngineAsyncError> register_market(const Market &market, MarketWorkerConfig config = {});
+        // InvalidMarketSpec if !spec.is_valid().
+        std::expected<MarketId, EngineAsyncError> register_market(const Market &market, const MarketSpec &spec, MarketWorkerConfig config = {});
         bool has_market(const Market &market) const noexcept;
+        bool has_market(MarketId market_id) const noexcept;
+        std::optional<MarketId> find_market_id(const Market &market) const noexcept;
+        // Stable for the dispatcher's lifetime; nullptr if market_id was never issued.
+        const Market *find_market(MarketId market_id) const noexcept;
+        // Same lifetime rules as find_market.
+        const MarketSpec *find_market_spec(MarketId market_id) const noexcept;
+        // True if the market was registered with MarketWorkerConfig::settlement_stage.
+        bool has_settlement_stage(MarketId market_id) const noexcept;
+        // True if the market was registered with MarketWorkerConfig::sub_ledger.
+        bool has_sub_ledger(MarketId market_id) const noexcept;
+        // Scheduling stats of the shared pool; nullopt in thread-per-market mode.
+        std::optional<MarketWorkerPoolStats> pool_stats() const;
 
         std::future<std::expected<std::vector<Execution>, EngineAsyncError>> submit(OrderRequest &&order_request);
+        // Every request must belong to market_id; the batch is one worker task.
+        std::future<SubmitBatchResult> submit_batch(MarketId market_id, std::vector<OrderRequest> &&order_requests);
+        std::future<std::expected<std::optional<CancelResult>, EngineAsyncError>> cancel(MarketId market_id, OrderId order_id);
         std::future<std::expected<std::optional<CancelResult>, EngineAsyncError>> cancel(const Market &market, OrderId order_id);
         std::future<std::expected<std::optional<Price>, EngineAsyncError>> best_bid(const Market &market);
         std::future<std::expected<std::optional<Price>, EngineAsyncError>> best_ask(const Market &market);
+        std::future<LedgerResult> transfer(MarketId market_id, UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction);
+        std::future<LedgerBalanceResult> ledger_balance(MarketId market_id, UserId user_id);
+
+        // Continuation overloads: routing errors are reported inline on the
+        // caller thread, otherwise on_done runs on the market worker thread
+        // (or its settlement stage thread).
+        void submit(OrderRequest &&order_request, SubmitCompletion on_done);
+        void submit_batch(MarketId market_id, std::vector<OrderRequest> &&order_requests, SubmitBatchCompletion on_done);
+        void cancel(MarketId market_id, OrderId order_id, CancelCompletion on_done);
+        void cancel(const Market &market, OrderId order_id, CancelCompletion on_done);
+        void best_bid(const Market &market, PriceCompletion on_done);
+        void best_ask(const Market &market, PriceCompletion on_done);
+        void transfer(MarketId market_id, UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction, LedgerCompletion on_done);
+        void ledger_balance(MarketId market_id, UserId user_id, LedgerBalanceCompletion on_done);
         void stop_all();
     };
 
@@ -0,0 +1,77 @@
+#pragma once
+#include <expected>
+#include <unordered_map>
+#include "vertex/core/types.hpp"
+#include "vertex/engine/engine_async_error.hpp"
+#include "vertex/engine/order_book.hpp"
+
+namespace vertex::engine
+{
+    enum class LedgerAsset
+    {
+        Base,
+        Quote
+    };
+
+    enum class LedgerTransfer
+    {
+        // Into the market's sub-ledger (free balance).
+        Credit,
+        // Out of the sub-ledger's free balance.
+        Debit,
+        // A debit in two steps, for a move that can still be called off once
+        // the funds are out of free: Hold parks them in reserved, then
+        // DebitHeld takes them out or ReleaseHold puts them back. Neither
+        // second step can fail.
+        Hold,
+        DebitHeld,
+        ReleaseHold
+    };
+
+    struct SubLedgerBalance
+    {
+        Quantity base_free{0};
+        Quantity base_reserved{0};
+        Quantity quote_free{0};
+        Quantity quote_reserved{0};
+    };
+
+    // Pre-funded balances of one market, owned by its MarketWorker.
+    //
+    // Only whoever runs the market's tasks touches it, so it takes no locks.
+    // Funds come in and go out through transfer(). In between, order entry
+    // reserves here, fills settle here, and cancels release here.
+    //
+    // Fills only move funds between users of this ledger, so bounding each
+    // asset's ledger-wide total at transfer() bounds every user's balance
+    // too: a fill's credit can never overflow.
+    class MarketLedger
+    {
+    public:
+        // InsufficientFunds when a debit or hold exceeds the free balance,
+        // BalanceOverflow when a credit would take the asset's ledger-wide
+        // total past the Quantity range.
+        std::expected<void, EngineAsyncError> transfer(UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction);
+        SubLedgerBalance balance(UserId user_id) const;
+
+        // Moves amount from free to reserved; false (nothing moved) if short
+        // or amount is not positive.
+        bool reserve(UserId user_id, LedgerAsset asset, Quantity amount);
+        void release(UserId user_id, LedgerAsset asset, Quantity amount);
+        // Pays one execution out of both sides' reservations. The buyer holds
+        // quote at its limit price (a market buy at the execution price); the
+        // surplus over the executed notional goes back to free. Cannot fail
+        // while funds only enter through transfer(); should either credit
+        // still not fit, both reservations go back to free instead and it
+        // returns false.
+        bool settle(const Execution &execution);
+
+    private:
+        std::unordered_map<UserId, SubLedgerBalance> balances_{};
+        // Free plus reserved over all users, per asset.
+        Quantity base_total_{0};
+        Quantity quote_total_{0};
+
+        Quantity &total_of(LedgerAsset asset) noexcept;
+    };
+} // namespace vertex::engine
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "vertex/core/market.hpp"
+#include "vertex/core/types.hpp"
+
+namespace vertex::engine
+{
+    // Insert-only Market -> MarketId map with lock-free lookups.
+    //
+    // Readers load the current table and probe immutable entries; they never
+    // write shared memory. Writers must be serialized by the caller. A grow
+    // builds a new table and swaps the pointer (RCU style); retired tables
+    // and all entries are only freed by the destructor, so a reader holding
+    // an old table stays valid.
+    class MarketRoutingTable
+    {
+    public:
+        MarketRoutingTable();
+        ~MarketRoutingTable() = default;
+        MarketRoutingTable(const MarketRoutingTable &) = delete;
+        MarketRoutingTable &operator=(const MarketRoutingTable &) = delete;
+        MarketRoutingTable(MarketRoutingTable &&) = delete;
+        MarketRoutingTable &operator=(MarketRoutingTable &&) = delete;
+
+        // Invalid (default) MarketId if market is not present.
+        vertex::core::MarketId find(const vertex::core::Market &market) const noexcept;
+        // Returns false if market is already present.
+        bool insert(const vertex::core::Market &market, vertex::core::MarketId id);
+        // Writer side only (same serialization as insert).
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        struct Entry
+        {
+            vertex::core::Market market;
+            std::size_t hash;
+            vertex::core::MarketId id;
+        };
+
+        struct Table
+        {
+            explicit Table(std::size_t capacity);
+
+            std::size_t mask;
+            std::unique_ptr<std::atomic<const Entry *>[]> slots;
+        };
+
+        static constexpr std::size_t kInitialCapacity = 64;
+
+        std::atomic<const Table *> table_{nullptr};
+        std::vector<std::unique_ptr<Table>> tables_{};
+        std::vector<std::unique_ptr<Entry>> entries_{};
+        std::size_t size_{0};
+
+        static void place(const Table &table, const Entry *entry) noexcept;
+    };
+
+}
@@ -1,53 +1,156 @@
 #pragma once
+#include <atomic>
 #include <condition_variable>
 #include <expected>
+#include <functional>
+#include <memory>
 #include <future>
+#include <memory_resource>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <vector>
 #include <variant>
 #include <optional>
 #include <queue>
+#include <type_traits>
 #include <utility>
+#include "vertex/core/id_generator.hpp"
 #include "vertex/engine/order_book.hpp"
 #include "vertex/engine/order_request.hpp"
 #include "vertex/engine/engine_async_error.hpp"
+#include "vertex/engine/market_ledger.hpp"
+#include "vertex/engine/market_worker_pool.hpp"
+#include "vertex/engine/settlement_stage.hpp"
+#include "vertex/engine/worker_arena.hpp"
 
 namespace vertex::engine
 {
 
     using SubmitResult = std::expected<std::vector<Execution>, EngineAsyncError>;
+    // submit_into: the executions are in the caller's buffer.
+    using SubmitIntoResult = std::expected<void, EngineAsyncError>;
+    // One result per request, in request order. A rejected batch reports the
+    // rejection for every request.
+    using SubmitBatchResult = std::vector<SubmitResult>;
     using CancelResultEx = std::expected<std::optional<CancelResult>, EngineAsyncError>;
     using PriceResult = std::expected<std::optional<Price>, EngineAsyncError>;
+    using LedgerResult = std::expected<void, EngineAsyncError>;
+    using LedgerBalanceResult = std::expected<SubLedgerBalance, EngineAsyncError>;
+    using TradeIdGenerator = vertex::core::IdGenerator<TradeId>;
+
+    // Continuation invoked exactly once with the task result. It runs on the
+    // worker thread (or inline on the caller thread when the task is rejected),
+    // so it must be short, must not throw and must not block on this worker.
+    template <typename Result>
+    using Completion = std::move_only_function<void(Result)>;
+
+    using SubmitCompletion = Completion<SubmitResult>;
+    using SubmitIntoCompletion = Completion<SubmitIntoResult>;
+    using SubmitBatchCompletion = Completion<SubmitBatchResult>;
+    using CancelCompletion = Completion<CancelResultEx>;
+    using PriceCompletion = Completion<PriceResult>;
+    using LedgerCompletion = Completion<LedgerResult>;
+    using LedgerBalanceCompletion = Completion<LedgerBalanceResult>;
+
+    // Adapts a promise into a continuation, used by the future-returning APIs.
+    template <typename Result>
+    Completion<Result> complete_promise(std::promise<Result> promise)
+    {
+        return [promise = std::move(promise)](Result result) mutable
+        {
+            promise.set_value(std::move(result));
+        };
+    }
 
     struct SubmitTask
     {
         OrderRequest request;
-        std::promise<SubmitResult> done;
+        SubmitCompletion done;
+    };
+
+    // out is owned by the caller and only touched by the worker until done runs.
+    struct SubmitIntoTask
+    {
+        OrderRequest request;
+        ExecutionBuffer *out;
+        SubmitIntoCompletion done;
+    };
+
+    // Requests run back to back as one queue entry, so the batch counts once
+    // against queue_capacity and no other task interleaves with it.
+    struct SubmitBatchTask
+    {
+        std::vector<OrderRequest> requests;
+        SubmitBatchCompletion done;
     };
 
     struct CancelTask
     {
         OrderId order_id;
-        std::promise<CancelResultEx> done;
+        CancelCompletion done;
     };
 
     struct BestBidTask
     {
-        std::promise<PriceResult> done;
+        PriceCompletion done;
     };
 
     struct BestAskTask
     {
-        std::promise<PriceResult> done;
+        PriceCompletion done;
+    };
+
+    struct LedgerTransferTask
+    {
+        UserId user_id;
+        LedgerAsset asset;
+        Quantity amount;
+        LedgerTransfer direction;
+        LedgerCompletion done;
+    };
+
+    struct LedgerBalanceTask
+    {
+        UserId user_id;
+        LedgerBalanceCompletion done;
     };
 
-    using MarketTask = std::variant<SubmitTask, CancelTask, BestBidTask, BestAskTask>;
+    using MarketTask = std::variant<SubmitTask, SubmitIntoTask, SubmitBatchTask, CancelTask, BestBidTask, BestAskTask, LedgerTransferTask, LedgerBalanceTask>;
+
+    struct MarketWorkerConfig
+    {
+        // Max queued tasks before new submits are rejected with Overloaded.
+        // Cancels and queries are never shed. 0 means unbounded.
+        std::size_t queue_capacity{0};
+        // Route cancels to a separate lane drained ahead of the normal FIFO.
+        bool priority_lane{false};
+        // Max consecutive priority tasks while normal tasks are waiting.
+        // 0 means the priority lane always wins.
+        std::size_t max_priority_burst{0};
+        // Run completions of executed tasks on a SettlementStage thread
+        // instead of the worker thread: the market's own, or for a pooled
+        // market the one its pool thread shares. Rejected tasks still
+        // complete inline on the caller thread.
+        bool settlement_stage{false};
+        std::size_t settlement_stage_capacity{SettlementStage::kDefaultCapacity};
+        // Keep a MarketLedger of pre-funded balances. Submits then reserve
+        // and settle against it on the worker (InsufficientFunds if short),
+        // and cancels release into it. Ledger tasks fail with NoSubLedger
+        // otherwise.
+        bool sub_ledger{false};
+    };
 
     class MarketWorker
     {
     public:
-        explicit MarketWorker(Market market);
+        // Executions are stamped with trade ids leased from trade_ids, which
+        // must outlive the worker; nullptr gives the worker its own numbering.
+        explicit MarketWorker(Market market, MarketWorkerConfig config = {});
+        MarketWorker(Market market, const MarketSpec &spec, MarketWorkerConfig config = {}, TradeIdGenerator *trade_ids = nullptr);
+        // Pooled worker: no dedicated thread, tasks run on a pool thread.
+        MarketWorker(Market market, MarketWorkerConfig config, MarketWorkerPool &pool);
+        MarketWorker(Market market, const MarketSpec &spec, MarketWorkerConfig config, MarketWorkerPool &pool, TradeIdGenerator *trade_ids = nullptr);
         ~MarketWorker();
         MarketWorker(const MarketWorker &) = delete;
         MarketWorker &operator=(const MarketWorker &) = delete;
@@ -55,42 +158,153 @@ namespace vertex::engine
         MarketWorker &operator=(MarketWorker &&) = delete;
 
         std::future<SubmitResult> submit(OrderRequest request);
+        std::future<SubmitBatchResult> submit_batch(std::vector<OrderRequest> requests);
         std::future<CancelResultEx> cancel(OrderId order_id);
         std::future<PriceResult> best_bid();
         std::future<PriceResult> best_ask();
+        std::future<LedgerResult> transfer(UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction);
+        std::future<LedgerBalanceResult> ledger_balance(UserId user_id);
+
+        void submit(OrderRequest request, SubmitCompletion on_done);
+        // Matches into out instead of a fresh vector: out is cleared and, when
+        // on_done runs, holds the executions. out must stay alive and untouched
+        // until then. It keeps its capacity, so a caller that reuses its buffer
+        // (and whose on_done fits move_only_function's inline storage) submits
+        // without allocating once the buffer has grown.
+        void submit_into(OrderRequest request, ExecutionBuffer &out, SubmitIntoCompletion on_done);
+        void submit_batch(std::vector<OrderRequest> requests, SubmitBatchCompletion on_done);
+        void cancel(OrderId order_id, CancelCompletion on_done);
+        void best_bid(PriceCompletion on_done);
+        void best_ask(PriceCompletion on_done);
+        void transfer(UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction, LedgerCompletion on_done);
+        void ledger_balance(UserId user_id, LedgerBalanceCompletion on_done);
         void stop();
 
+        // Allocations that overflowed the dedicated thread's scratch arena.
+        // Pooled workers report this per pool thread in MarketWorkerPoolStats.
+        std::uint64_t arena_upstream_allocations() const noexcept
+        {
+            return arena_upstream_allocations_.load(std::memory_order_relaxed);
+        }
+
+        // Sub-ledger executions whose credit would have overflowed a balance;
+        // zero while the ledger's transfer() bound holds. They matched in the
+        // book but paid nothing out; both sides' funds went back to free.
+        std::uint64_t unsettled_ledger_executions() const noexcept
+        {
+            return unsettled_ledger_executions_.load(std::memory_order_relaxed);
+        }
+
+        bool has_settlement_stage() const noexcept { return stage_ != nullptr; }
+        bool has_sub_ledger() const noexcept { return ledger_ != nullptr; }
+
     private:
-        std::queue<MarketTask> task_queue_{};
+        friend class MarketWorkerPool;
+
+        using TaskQueue = std::queue<MarketTask, std::pmr::deque<MarketTask>>;
+
+        // Recycles the lanes' deque blocks, so a steady queue depth stops
+        // allocating. Only touched under queue_mutex_.
+        std::pmr::unsynchronized_pool_resource task_pool_{};
+        TaskQueue task_queue_{std::pmr::polymorphic_allocator<MarketTask>{&task_pool_}};
+        TaskQueue priority_queue_{std::pmr::polymorphic_allocator<MarketTask>{&task_pool_}};
+        const MarketWorkerConfig config_;
         std::thread worker_thread_;
         OrderBook order_book_;
         std::mutex queue_mutex_;
         std::condition_variable queue_cv_;
         bool stopping_{false};
+        std::size_t priority_burst_{0};
+        MarketWorkerPool *pool_{nullptr};
+        // Pool thread whose run queue takes this market; moved by work stealing.
+        std::atomic<std::size_t> home_{0};
+        // Pooled mode: true while this market sits in (or is drained from) a run queue.
+        bool scheduled_{false};
+        std::atomic<std::uint64_t> arena_upstream_allocations_{0};
+        std::atomic<std::uint64_t> unsettled_ledger_executions_{0};
+        TradeIdGenerator own_trade_ids_{};
+        // Only touched by whoever runs this market's tasks, so ids are increasing per market.
+        vertex::core::IdLease<TradeId> trade_ids_;
+        // Dedicated mode only; destroyed explicitly in ~MarketWorker once no
+        // task can run any more.
+        std::unique_ptr<SettlementStage> own_stage_;
+        // own_stage_, or the pool's shared stage for this market's lane.
+        SettlementStage *stage_{nullptr};
+        // Set with MarketWorkerConfig::sub_ledger; touched like order_book_.
+        std::unique_ptr<MarketLedger> ledger_;
 
         void run();
+        struct BatchResult
+        {
+            std::size_t tasks_run{0};
+            // True if tasks remain; the market then stays scheduled.
+            bool has_more{false};
+        };
+
+        // Pooled mode: runs up to max_tasks queued tasks. Matching scratch comes
+        // from arena, which the caller may reset once this returns.
+        BatchResult run_batch(std::size_t max_tasks, std::pmr::memory_resource *arena);
+        MarketTask pop_next_task();
+        void run_task(MarketTask &task, ExecutionBuffer &scratch);
+        template <typename Result>
+        void complete(Completion<Result> &done, Result result);
         template <typename Task>
-        bool try_enqueue(Task &&task);
-        std::vector<Execution> handle_submit(const OrderRequest &req);
-        std::vector<Execution> handle_limit_request(const LimitOrderRequest &req);
-        std::vector<Execution> handle_market_buy_by_quote(const MarketBuyByQuoteRequest &req);
-        std::vector<Execution> handle_market_sell_by_base(const MarketSellByBaseRequest &req);
+        std::expected<void, EngineAsyncError> try_enqueue(Task &&task);
+        // Reserve (sub-ledger), match into out, stamp trade ids and settle one request.
+        SubmitIntoResult run_submit_into(const OrderRequest &req, ExecutionBuffer &out);
+        // run_submit_into on scratch, copied out into the result vector.
+        SubmitResult run_submit(const OrderRequest &req, ExecutionBuffer &scratch);
+        void handle_submit(const OrderRequest &req, ExecutionBuffer &out);
+        void handle_limit_request(const LimitOrderRequest &req, ExecutionBuffer &out);
+        void handle_market_buy_by_quote(const MarketBuyByQuoteRequest &req, ExecutionBuffer &out);
+        void handle_market_sell_by_base(const MarketSellByBaseRequest &req, ExecutionBuffer &out);
+        // Sub-ledger markets: what the request holds until it fills or rests.
+        // False if the user is short or the amount is not representable
+        // (price * quantity overflows) or not positive.
+        bool reserve_in_ledger(const OrderRequest &req);
+        // Settles the fills and returns a market order's unfilled remainder.
+        void settle_in_ledger(const OrderRequest &req, const ExecutionBuffer &executions);
     };
 
     template <typename Task>
-    bool MarketWorker::try_enqueue(Task &&task)
+    std::expected<void, EngineAsyncError> MarketWorker::try_enqueue(Task &&task)
     {
+        bool schedule = false;
         {
             std::lock_guard lock(queue_mutex_);
+            // Important for callers: on error, task was not moved into
+            // task_queue_, so caller may still read/finish it.
             if (stopping_)
-                // Important for callers: when this returns false, task was not
-                // moved into task_queue_, so caller may still read/finish it.
-                return false;
+                return std::unexpected(EngineAsyncError::WorkerStopped);
+
+            if constexpr (std::is_same_v<std::remove_cvref_t<Task>, SubmitTask> ||
+                          std::is_same_v<std::remove_cvref_t<Task>, SubmitIntoTask> ||
+                          std::is_same_v<std::remove_cvref_t<Task>, SubmitBatchTask>)
+            {
+                if (config_.queue_capacity != 0 && task_queue_.size() >= config_.queue_capacity)
+                    return std::unexpected(EngineAsyncError::Overloaded);
+            }
+
+            TaskQueue *lane = &task_queue_;
+            if constexpr (std::is_same_v<std::remove_cvref_t<Task>, CancelTask>)
+            {
+                if (config_.priority_lane)
+                    lane = &priority_queue_;
+            }
+
+            lane->emplace(std::forward<Task>(task));
 
-            task_queue_.emplace(std::forward<Task>(task));
+            if (pool_ != nullptr)
+            {
+                schedule = !scheduled_;
+                scheduled_ = true;
+            }
         }
 
-        queue_cv_.notify_one();
-        return true;
+        if (schedule)
+            pool_->schedule(this, home_.load(std::memory_order_relaxed));
+        else if (pool_ == nullptr)
+            queue_cv_.notify_one();
+        return {};
     }
 }
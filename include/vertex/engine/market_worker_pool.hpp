@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "vertex/engine/settlement_stage.hpp"
+
+namespace vertex::engine
+{
+    class MarketWorker;
+
+    struct MarketWorkerPoolThreadStats
+    {
+        std::uint64_t busy_ns{0};
+        std::uint64_t tasks_run{0};
+        std::uint64_t batches_run{0};
+        // Scratch allocations that overflowed this thread's WorkerArena.
+        std::uint64_t arena_upstream_allocations{0};
+    };
+
+    struct MarketWorkerPoolStats
+    {
+        // Wall time since the pool started; busy_ns / elapsed_ns is utilisation.
+        std::uint64_t elapsed_ns{0};
+        std::uint64_t migrations{0};
+        std::vector<MarketWorkerPoolThreadStats> threads{};
+    };
+
+    // Fixed pool of threads that runs many pooled MarketWorkers (M:N).
+    // A market with queued tasks sits in exactly one run queue and is drained
+    // by one thread at a time, so per-market ordering is preserved; an idle
+    // market is in no run queue and costs no thread.
+    //
+    // A thread whose run queue is empty steals a ready market from a thread
+    // that has at least steal_threshold markets waiting, and becomes that
+    // market's new home. Only queued (not running) markets move, so a market
+    // never runs on two threads at once.
+    //
+    // Pooled markets with a settlement stage share one SettlementStage per
+    // pool thread, picked by the market's first home and kept when it is
+    // stolen, so the pool adds at most thread_count stage threads however
+    // many markets it runs.
+    class MarketWorkerPool
+    {
+    public:
+        static constexpr std::size_t kDefaultBatchSize = 64;
+        static constexpr std::size_t kDefaultStealThreshold = 1;
+
+        // steal_threshold == 0 disables work stealing.
+        explicit MarketWorkerPool(
+            std::size_t thread_count,
+            std::size_t batch_size = kDefaultBatchSize,
+            std::size_t steal_threshold = kDefaultStealThreshold);
+        // All pooled workers must be destroyed before the pool.
+        ~MarketWorkerPool();
+        MarketWorkerPool(const MarketWorkerPool &) = delete;
+        MarketWorkerPool &operator=(const MarketWorkerPool &) = delete;
+        MarketWorkerPool(MarketWorkerPool &&) = delete;
+        MarketWorkerPool &operator=(MarketWorkerPool &&) = delete;
+
+        std::size_t thread_count() const noexcept { return threads_.size(); }
+        MarketWorkerPoolStats stats() const;
+
+    private:
+        friend class MarketWorker;
+
+        struct RunQueue
+        {
+            std::mutex mu;
+            std::condition_variable cv;
+            // Recycles ready's blocks; only touched under mu.
+            std::pmr::unsynchronized_pool_resource ready_pool{};
+            std::pmr::deque<MarketWorker *> ready{&ready_pool};
+            bool stopping{false};
+            std::atomic<std::uint64_t> busy_ns{0};
+            std::atomic<std::uint64_t> tasks_run{0};
+            std::atomic<std::uint64_t> batches_run{0};
+            std::atomic<std::uint64_t> arena_upstream_allocations{0};
+        };
+
+        // How long an idle thread sleeps before looking for work to steal.
+        static constexpr std::chrono::microseconds kStealPollInterval{500};
+
+        const std::size_t batch_size_;
+        const std::size_t steal_threshold_;
+        const std::chrono::steady_clock::time_point started_at_;
+        std::vector<std::unique_ptr<RunQueue>> run_queues_;
+        std::vector<std::thread> threads_;
+        std::atomic<std::size_t> next_home_{0};
+        std::atomic<std::uint64_t> migrations_{0};
+        // One per pool thread, made on first use; the first market to ask
+        // sizes it. Outlives every pooled worker, so their last completions
+        // run before the pool is gone.
+        std::mutex stages_mu_;
+        std::vector<std::unique_ptr<SettlementStage>> stages_;
+
+        // Round-robin home thread for a newly registered market.
+        std::size_t assign_home() noexcept;
+        SettlementStage &settlement_stage(std::size_t lane, std::size_t capacity);
+        // Called by a worker that just went from idle to having queued tasks.
+        void schedule(MarketWorker *worker, std::size_t home);
+        void run(std::size_t index);
+        MarketWorker *try_steal(std::size_t thief);
+    };
+
+}
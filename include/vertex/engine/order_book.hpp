@@ -1,12 +1,14 @@
 #pragma once
+#include <cstdint>
 #include <functional>
-#include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <unordered_map>
 #include <vector>
 #include "vertex/core/types.hpp"
+#include "vertex/engine/order_request.hpp"
 #include "vertex/engine/resting_order.hpp"
 
 namespace vertex::engine
@@ -16,55 +18,99 @@ namespace vertex::engine
     using Side = vertex::core::Side;
     using Price = vertex::core::Price;
     using OrderId = vertex::core::OrderId;
+    using TradeId = vertex::core::TradeId;
+    using MarketSpec = vertex::core::MarketSpec;
 
-    struct OrderLocation
-    {
-        Side side;
-        Price price;
-        std::list<RestingOrder>::iterator it;
-    };
-
+    // FIFO of resting orders at one price, linked through RestingOrder::prev/next.
     struct PriceLevel
     {
-        std::list<RestingOrder> orders;
+        OrderSlot head{kNoOrderSlot};
+        OrderSlot tail{kNoOrderSlot};
+
+        bool empty() const noexcept { return head == kNoOrderSlot; }
     };
 
     struct Execution
     {
         OrderId buy_order_id;
         OrderId sell_order_id;
+        UserId buy_owner;
+        UserId sell_owner;
         Quantity quantity;
         Price execution_price;
         std::optional<Price> buy_order_limit_price;
         bool buy_fully_filled;
         bool sell_fully_filled;
+        // Stamped by the MarketWorker; the book leaves it invalid.
+        TradeId trade_id{};
     };
     struct CancelResult
     {
         OrderId id;
+        UserId owner;
         Side side;
         Price price;
         Quantity remaining_quantity;
     };
+
+    struct RestingOrderInfo
+    {
+        OrderId id;
+        UserId owner;
+        Side side;
+        Price limit_price;
+        Quantity initial_quantity;
+        Quantity remaining_quantity;
+        std::uint64_t sequence;
+    };
+
+    // Matching output buffer; workers back it with a per-thread arena.
+    using ExecutionBuffer = std::pmr::vector<Execution>;
+
     class OrderBook
     {
     private:
         const Market market_;
-        std::map<Price, PriceLevel, std::greater<>> bids_{}; // buyers list
-        std::map<Price, PriceLevel, std::less<>> asks_{};    // seller list
-        std::unordered_map<OrderId, OrderLocation> index_{};
+        const MarketSpec spec_;
+        // Levels are keyed by tick count; Execution and CancelResult convert
+        // back to Price/Quantity so callers never see ticks or lots.
+        std::map<Ticks, PriceLevel, std::greater<>> bids_{}; // buyers list
+        std::map<Ticks, PriceLevel, std::less<>> asks_{};    // seller list
+        // Resting orders live in one contiguous pool; slots of filled or
+        // cancelled orders are chained from free_head_ through next and reused.
+        std::vector<RestingOrder> orders_{};
+        std::vector<RestingOrderCold> cold_{};
+        OrderSlot free_head_{kNoOrderSlot};
+        std::uint64_t next_sequence_{0};
+        std::unordered_map<OrderId, OrderSlot> index_{};
+
+        OrderSlot allocate_slot();
+        void free_slot(OrderSlot slot) noexcept;
+        void push_back(PriceLevel &level, OrderSlot slot) noexcept;
+        void unlink(PriceLevel &level, OrderSlot slot) noexcept;
 
     public:
-        explicit OrderBook(Market market);
+        // spec must be valid; orders handed to the book must already conform to it.
+        explicit OrderBook(Market market, MarketSpec spec = {});
+        const MarketSpec &spec() const noexcept { return spec_; }
         std::optional<CancelResult> cancel(OrderId order_id);
         std::optional<Price> best_bid() const;
         std::optional<Price> best_ask() const;
 
-        void insert_resting(Side side, RestingOrder &&order);
-        std::vector<Execution> match_limit_buy_against_asks(const OrderId taker_order_id, const Price limit_price, Quantity &remaining_base_quantity);
-        std::vector<Execution> match_limit_sell_against_bids(const OrderId taker_order_id, const Price limit_price, Quantity &remaining_base_quantity);
-        std::vector<Execution> match_market_buy_by_quote_against_asks(const OrderId taker_order_id, Quantity remaining_quote_budget);
-        std::vector<Execution> match_market_sell_by_base_against_bids(const OrderId taker_order_id, Quantity remaining_base_quantity);
+        // Books the unfilled remainder of a limit order.
+        void insert_resting(const LimitOrderRequest &order, Quantity remaining_base_quantity);
+        std::optional<RestingOrderInfo> find_resting(OrderId order_id) const;
+        std::size_t resting_count() const noexcept { return index_.size(); }
+        std::vector<Execution> match_limit_buy_against_asks(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity);
+        std::vector<Execution> match_limit_sell_against_bids(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity);
+        std::vector<Execution> match_market_buy_by_quote_against_asks(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_quote_budget);
+        std::vector<Execution> match_market_sell_by_base_against_bids(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_base_quantity);
+
+        // Same matching, appending executions to out instead of returning a new vector.
+        void match_limit_buy_against_asks(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity, ExecutionBuffer &out);
+        void match_limit_sell_against_bids(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity, ExecutionBuffer &out);
+        void match_market_buy_by_quote_against_asks(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_quote_budget, ExecutionBuffer &out);
+        void match_market_sell_by_base_against_bids(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_base_quantity, ExecutionBuffer &out);
     };
 
 }
\ No newline at end of file
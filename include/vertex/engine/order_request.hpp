@@ -5,6 +5,7 @@
 namespace vertex::engine
 {
     using Market = vertex::core::Market;
+    using MarketId = vertex::core::MarketId;
     using OrderId = vertex::core::OrderId;
     using UserId = vertex::core::UserId;
     using Price = vertex::core::Price;
@@ -15,7 +16,7 @@ namespace vertex::engine
     {
         OrderId id;
         UserId user_id;
-        Market market;
+        MarketId market;
         Side side;
         Price limit_price;
         Quantity base_quantity;
@@ -25,14 +26,14 @@ namespace vertex::engine
     {
         OrderId id;
         UserId user_id;
-        Market market;
+        MarketId market;
         Quantity quote_budget;
     };
     struct MarketSellByBaseRequest
     {
         OrderId id;
         UserId user_id;
-        Market market;
+        MarketId market;
         Quantity base_quantity;
     };
 
@@ -1,36 +1,64 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
+#include <limits>
+#include "vertex/core/market_spec.hpp"
 #include "vertex/core/types.hpp"
 namespace vertex::engine
 {
     using OrderId = vertex::core::OrderId;
+    using UserId = vertex::core::UserId;
     using Market = vertex::core::Market;
     using Side = vertex::core::Side;
     using Price = vertex::core::Price;
     using Quantity = vertex::core::Quantity;
+    using Ticks = vertex::core::Ticks;
+    using Lots = vertex::core::Lots;
 
+    // Index of a resting order in its book's pool.
+    using OrderSlot = std::uint32_t;
+    inline constexpr OrderSlot kNoOrderSlot = std::numeric_limits<OrderSlot>::max();
+    // Owner UserId narrowed to 32 bits; UserIds are dense from 1.
+    using OwnerSlot = std::uint32_t;
+
+    // Hot half of a resting order: everything the matching loop touches.
+    // Price and quantity are tick/lot counts of the book's MarketSpec;
+    // prev/next link the order into its price level's FIFO.
     struct RestingOrder
     {
         OrderId id;
-        Price limit_price;
-        Quantity initial_base_quantity;
-        Quantity remaining_base_quantity;
+        Ticks limit_ticks;
+        Lots remaining_lots;
+        OrderSlot prev;
+        OrderSlot next;
+        OwnerSlot owner;
+        Side side;
 
-        void reduce(Quantity executed)
+        void reduce(Lots executed)
         {
             assert(executed > 0);
-            assert(executed <= remaining_base_quantity);
-            remaining_base_quantity -= executed;
+            assert(executed <= remaining_lots);
+            remaining_lots -= executed;
         }
         bool is_filled() const noexcept
         {
-            return remaining_base_quantity == 0;
+            return remaining_lots == 0;
         }
         bool is_active() const noexcept
         {
-            return remaining_base_quantity > 0;
+            return remaining_lots > 0;
         }
     };
 
-}
\ No newline at end of file
+    static_assert(sizeof(RestingOrder) == 32, "RestingOrder must stay two per cache line");
+
+    // Cold half, same slot in a parallel array; never read while matching.
+    struct RestingOrderCold
+    {
+        Lots initial_lots;
+        // Book-local arrival number, increasing with every inserted order.
+        std::uint64_t sequence;
+    };
+
+}
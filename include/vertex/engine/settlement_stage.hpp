@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "vertex/core/spsc_queue.hpp"
+
+namespace vertex::engine
+{
+    // Per-market pipeline stage after matching.
+    //
+    // The market's completions are posted here in the order the worker ran
+    // its tasks and run one by one on the stage's own thread, so work done in
+    // a completion (the Exchange settles wallets, records trades and closes
+    // orders there) overlaps with matching of later tasks and happens in
+    // matching order. The producer is whoever runs the market's tasks, one
+    // thread at a time.
+    //
+    // A MarketWorkerPool shares one stage between the markets of a pool
+    // thread instead; such a shared stage takes posts from several threads
+    // and serialises them on a mutex, so each market's jobs still run in
+    // the order it posted them.
+    class SettlementStage
+    {
+    public:
+        using Job = std::move_only_function<void()>;
+
+        static constexpr std::size_t kDefaultCapacity = 1024;
+
+        explicit SettlementStage(std::size_t capacity = kDefaultCapacity, bool shared = false);
+        // Runs every posted job, then joins the thread.
+        ~SettlementStage();
+        SettlementStage(const SettlementStage &) = delete;
+        SettlementStage &operator=(const SettlementStage &) = delete;
+
+        // Producer side. Yields while the ring is full, so a slow stage
+        // pushes back on matching instead of growing without bound.
+        void post(Job job);
+
+    private:
+        vertex::core::SpscQueue<Job> queue_;
+        const bool shared_;
+        // Shared stages only: one producer at a time on queue_.
+        std::mutex producer_mu_;
+        std::thread thread_;
+
+        void run();
+    };
+} // namespace vertex::engine
@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace vertex::engine
+{
+    // Forwards to upstream and counts every allocation that reaches it.
+    class CountingResource final : public std::pmr::memory_resource
+    {
+    public:
+        explicit CountingResource(
+            std::atomic<std::uint64_t> &allocations,
+            std::pmr::memory_resource *upstream = std::pmr::new_delete_resource()) noexcept
+            : allocations_(allocations), upstream_(upstream)
+        {
+        }
+
+    private:
+        std::atomic<std::uint64_t> &allocations_;
+        std::pmr::memory_resource *upstream_;
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            allocations_.fetch_add(1, std::memory_order_relaxed);
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+        {
+            upstream_->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    // Monotonic scratch arena owned by the thread that runs market tasks.
+    // Transient matching allocations come from an inline buffer; reset()
+    // after each batch rewinds it. Only overflow reaches the global allocator,
+    // and each such allocation is counted.
+    class WorkerArena
+    {
+    public:
+        static constexpr std::size_t kBufferSize = 16 * 1024;
+
+        explicit WorkerArena(std::atomic<std::uint64_t> &upstream_allocations) noexcept
+            : upstream_(upstream_allocations), arena_(buffer_.data(), buffer_.size(), &upstream_)
+        {
+        }
+        WorkerArena(const WorkerArena &) = delete;
+        WorkerArena &operator=(const WorkerArena &) = delete;
+        WorkerArena(WorkerArena &&) = delete;
+        WorkerArena &operator=(WorkerArena &&) = delete;
+
+        std::pmr::memory_resource *resource() noexcept { return &arena_; }
+        // Every allocation from resource() must be dead by now.
+        void reset() noexcept { arena_.release(); }
+
+    private:
+        alignas(std::max_align_t) std::array<std::byte, kBufferSize> buffer_;
+        CountingResource upstream_;
+        std::pmr::monotonic_buffer_resource arena_;
+    };
+
+}
@@ -1,6 +1,7 @@
 #include "vertex/application/exchange.hpp"
 
 #include <cassert>
+#include <utility>
 
 namespace vertex::application
 {
@@ -14,6 +15,10 @@ namespace vertex::application
                 return RegisterMarketError::WorkerStopped;
             case EngineAsyncError::MarketAlreadyRegistered:
                 return RegisterMarketError::AlreadyListed;
+            case EngineAsyncError::InvalidMarketSpec:
+                return RegisterMarketError::InvalidSpec;
+            case EngineAsyncError::CapacityExhausted:
+                return RegisterMarketError::CapacityExhausted;
             default:
                 assert(false && "Unexpected EngineAsyncError in register market mapping");
                 return RegisterMarketError::WorkerStopped;
@@ -21,53 +26,78 @@ namespace vertex::application
         }
     } // namespace
 
+    Exchange::Exchange(MarketDispatcherConfig dispatcher_config)
+        : market_dispatcher_(dispatcher_config)
+    {
+    }
+
+    Exchange::Exchange(ExchangeConfig config)
+        : wallet_mode_(config.wallet_mode),
+          ledger_(config.wallet_mode == WalletMode::Partitioned ? std::make_unique<LedgerPartitions>(config.ledger_partitions) : nullptr),
+          market_dispatcher_(config.dispatcher)
+    {
+    }
+
     std::expected<UserId, UserError> Exchange::create_user(std::string name)
     {
         if (name.empty())
             return std::unexpected(UserError::EmptyName);
 
-        UserId user_id;
-        {
-            std::lock_guard lock(user_id_generator_mu_);
-            user_id = user_id_generator_.next();
-        }
-
-        User user{user_id, name};
+        static_assert(UserTable::kCapacity == AccountTable::kCapacity);
 
-        {
-            std::lock_guard lock(accounts_mu_);
-            auto [_, inserted] = accounts_.emplace(user.id(), std::make_shared<Account>(user, Wallet{}));
-            if (!inserted)
-                return std::unexpected(UserError::UserAlreadyExists);
-        }
+        std::lock_guard lock(accounts_mu_);
+        // The tables are append-only and cannot drop a half-made user, so
+        // capacity is checked once for both before either grows.
+        if (accounts_.size() >= kMaxAccounts)
+            return std::unexpected(UserError::UserCapacityExhausted);
+        // Appends are serialized, so the next index is known before emplacing.
+        const UserId user_id{accounts_.size() + 1};
+        // users_ first: an account is visible only once its User is.
+        const auto user_index = users_.emplace_back(user_id, std::move(name));
+        const auto index = accounts_.emplace_back(user_id, wallet_mode_);
+        if (!user_index || !index)
+            return std::unexpected(UserError::UserCapacityExhausted);
 
-        return user.id();
+        assert(*index == *user_index && "Invariant violated: account and user tables out of step");
+        assert(*index + 1 == user_id.get_value() && "Invariant violated: account index does not match user id");
+        return user_id;
     }
 
     std::expected<std::string, UserError> Exchange::get_user_name(const UserId user_id) const
     {
-        std::shared_lock lock(accounts_mu_);
-        auto it_user = accounts_.find(user_id);
-
-        if (it_user == accounts_.end())
+        if (get_account(user_id) == nullptr)
             return std::unexpected(UserError::UserNotFound);
 
-        return it_user->second->user.name();
+        return users_.find(user_id.get_value() - 1)->name();
     }
 
     bool Exchange::user_exists(const UserId user_id) const
     {
-        std::shared_lock lock(accounts_mu_);
-        return accounts_.find(user_id) != accounts_.end();
+        return get_account(user_id) != nullptr;
     }
 
-    std::expected<void, RegisterMarketError> Exchange::register_market(const Market &market)
+    std::expected<MarketId, RegisterMarketError> Exchange::register_market(const Market &market, MarketWorkerConfig config)
     {
-        auto register_result = market_dispatcher_.register_market(market);
+        return register_market(market, MarketSpec{}, config);
+    }
+
+    std::expected<MarketId, RegisterMarketError> Exchange::register_market(const Market &market, const MarketSpec &spec, MarketWorkerConfig config)
+    {
+        auto register_result = market_dispatcher_.register_market(market, spec, config);
         if (!register_result)
             return std::unexpected(map_to_register_market_error(register_result.error()));
 
-        return {};
+        return register_result.value();
+    }
+
+    std::optional<MarketId> Exchange::find_market_id(const Market &market) const
+    {
+        return market_dispatcher_.find_market_id(market);
+    }
+
+    std::optional<MarketWorkerPoolStats> Exchange::market_pool_stats() const
+    {
+        return market_dispatcher_.pool_stats();
     }
 
 } // namespace vertex::application
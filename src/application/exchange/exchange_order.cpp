@@ -1,7 +1,11 @@
 #include "vertex/application/exchange.hpp"
+#include "vertex/core/notional.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <future>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -17,6 +21,10 @@ namespace vertex::application
                 return PlaceOrderError::WorkerStopped;
             case EngineAsyncError::MarketNotFound:
                 return PlaceOrderError::MarketNotListed;
+            case EngineAsyncError::Overloaded:
+                return PlaceOrderError::Overloaded;
+            case EngineAsyncError::InsufficientFunds:
+                return PlaceOrderError::InsufficientFunds;
             default:
                 assert(false && "Unexpected EngineAsyncError in place order mapping");
                 return PlaceOrderError::WorkerStopped;
@@ -37,6 +45,51 @@ namespace vertex::application
             }
         }
 
+        // price is checked for limit orders; base_quantity is absent for market
+        // buys, whose quantity is a quote budget. Only limit orders can rest, so
+        // only they must fit the book's 32-bit lot count.
+        std::optional<PlaceOrderError> check_market_spec(
+            const MarketSpec &spec,
+            const std::optional<Price> price,
+            const std::optional<Quantity> base_quantity)
+        {
+            if (price)
+            {
+                if (!spec.is_on_tick(*price))
+                    return PlaceOrderError::PriceNotOnTick;
+                if (!spec.is_in_band(*price))
+                    return PlaceOrderError::PriceOutOfBand;
+            }
+
+            if (base_quantity)
+            {
+                if (!spec.is_on_lot(*base_quantity))
+                    return PlaceOrderError::QuantityNotOnLot;
+                if (price && !spec.fits_lots(*base_quantity))
+                    return PlaceOrderError::InvalidQuantity;
+            }
+
+            return std::nullopt;
+        }
+
+        // Blocking entry on a market with a settlement stage: finish runs inside
+        // the engine completion, i.e. on the stage thread, and the caller waits
+        // for its result.
+        template <typename EngineResult, typename Launch, typename Finish>
+        std::invoke_result_t<Finish &, EngineResult> finish_in_completion(Launch launch, Finish finish)
+        {
+            using Result = std::invoke_result_t<Finish &, EngineResult>;
+
+            std::promise<Result> settled;
+            auto result = settled.get_future();
+            launch(vertex::engine::Completion<EngineResult>{
+                [finish = std::move(finish), settled = std::move(settled)](EngineResult engine_result) mutable
+                {
+                    settled.set_value(finish(std::move(engine_result)));
+                }});
+            return result.get();
+        }
+
         std::optional<double> compute_avg_price(Quantity executed_base_qty, Quantity executed_quote_qty)
         {
             if (executed_base_qty == 0)
@@ -48,14 +101,14 @@ namespace vertex::application
 
     std::optional<PlaceOrderError> Exchange::validate_order(
         const UserId user_id,
-        const Market &market,
+        const Market *market,
         const std::optional<Price> price,
         const Quantity quantity) const
     {
         if (!user_id.is_valid())
             return PlaceOrderError::UserNotFound;
 
-        if (!market_dispatcher_.has_market(market))
+        if (market == nullptr)
             return PlaceOrderError::MarketNotListed;
 
         if (quantity <= 0)
@@ -74,73 +127,357 @@ namespace vertex::application
         const Price price,
         const Quantity quantity)
     {
+        return place_limit_order(user_id, market_dispatcher_.find_market_id(market).value_or(MarketId{}), side, price, quantity);
+    }
+
+    std::expected<OrderPlacementResult, PlaceOrderError> Exchange::place_limit_order(
+        const UserId user_id,
+        const MarketId market_id,
+        const Side side,
+        const Price price,
+        const Quantity quantity)
+    {
+        auto pending = begin_limit_order(user_id, market_id, side, price, quantity);
+        if (!pending)
+            return std::unexpected(pending.error());
+
+        auto [order, order_request] = std::move(pending.value());
+        if (market_dispatcher_.has_settlement_stage(market_id))
+        {
+            return finish_in_completion<SubmitResult>(
+                [this, &order_request](vertex::engine::SubmitCompletion on_done)
+                {
+                    market_dispatcher_.submit(std::move(order_request), std::move(on_done));
+                },
+                [this, &order](SubmitResult matching_result)
+                {
+                    return finish_limit_order(order, std::move(matching_result));
+                });
+        }
+
+        auto matching_result = market_dispatcher_.submit(std::move(order_request)).get();
+        return finish_limit_order(order, std::move(matching_result));
+    }
+
+    std::vector<std::expected<OrderPlacementResult, PlaceOrderError>> Exchange::place_limit_orders(
+        std::span<const LimitOrderEntry> orders)
+    {
+        // Every slot is overwritten below.
+        std::vector<std::expected<OrderPlacementResult, PlaceOrderError>> results(
+            orders.size(), std::unexpected(PlaceOrderError::WorkerStopped));
+
+        struct Checked
+        {
+            Account *account;
+            const Market *market;
+            Asset asset;
+            Quantity amount;
+            Reservation reservation{};
+            bool sub_ledger{false};
+            bool ready{false};
+        };
+
+        // Empty for orders that failed validation.
+        std::vector<std::optional<Checked>> checked(orders.size());
+        std::vector<std::size_t> to_reserve;
+        for (std::size_t i = 0; i < orders.size(); ++i)
+        {
+            const LimitOrderEntry &entry = orders[i];
+            const Market *market = market_dispatcher_.find_market(entry.market_id);
+            if (auto error = validate_order(entry.user_id, market, entry.price, entry.quantity))
+            {
+                results[i] = std::unexpected(*error);
+                continue;
+            }
+
+            if (auto error = check_market_spec(*market_dispatcher_.find_market_spec(entry.market_id), entry.price, entry.quantity))
+            {
+                results[i] = std::unexpected(*error);
+                continue;
+            }
+
+            const std::optional<Quantity> amount =
+                (entry.side == Side::Buy) ? vertex::core::checked_notional(entry.price, entry.quantity) : entry.quantity;
+            if (!amount)
+            {
+                results[i] = std::unexpected(PlaceOrderError::NotionalOverflow);
+                continue;
+            }
+
+            Account *account = get_account(entry.user_id);
+            if (account == nullptr)
+            {
+                results[i] = std::unexpected(PlaceOrderError::UserNotFound);
+                continue;
+            }
+
+            const bool sub_ledger = market_dispatcher_.has_sub_ledger(entry.market_id);
+            checked[i] = Checked{
+                .account = account,
+                .market = market,
+                .asset = (entry.side == Side::Buy) ? market->quote() : market->base(),
+                .amount = *amount,
+                .sub_ledger = sub_ledger,
+                .ready = sub_ledger,
+            };
+            if (!sub_ledger)
+                to_reserve.push_back(i);
+        }
+
+        // One wallet visit per account; within it orders reserve in input order.
+        std::ranges::stable_sort(to_reserve, std::less<>{}, [&checked](std::size_t i)
+                                 { return checked[i]->account; });
+        for (auto run = to_reserve.begin(); run != to_reserve.end();)
+        {
+            Account &account = *checked[*run]->account;
+            const auto run_end = std::find_if(run, to_reserve.end(), [&](std::size_t i)
+                                              { return checked[i]->account != &account; });
+            with_wallet(
+                account,
+                [&](auto &wallet)
+                {
+                    for (auto it = run; it != run_end; ++it)
+                    {
+                        Checked &order = *checked[*it];
+                        auto reserved = wallet.reserve(order.asset, order.amount);
+                        if (!reserved)
+                            continue;
+                        order.reservation = reserved.value();
+                        order.ready = true;
+                    }
+                });
+            for (auto it = run; it != run_end; ++it)
+            {
+                if (!checked[*it]->ready)
+                    results[*it] = std::unexpected(PlaceOrderError::InsufficientFunds);
+            }
+            run = run_end;
+        }
+
+        struct MarketBatch
+        {
+            MarketId market_id;
+            std::vector<std::size_t> slots{};
+            std::vector<OrderRequest> requests{};
+            std::future<SubmitBatchResult> matched{};
+            // Set instead of matched on a market with a settlement stage.
+            std::future<void> settled{};
+        };
+
+        // A batch spans a handful of markets, so a linear lookup is enough.
+        std::vector<std::optional<PreparedLimitOrder>> prepared(orders.size());
+        std::vector<MarketBatch> batches;
+        for (std::size_t i = 0; i < orders.size(); ++i)
+        {
+            if (!checked[i] || !checked[i]->ready)
+                continue;
+
+            const Checked &order = *checked[i];
+            const LimitOrderEntry &entry = orders[i];
+            PreparedLimitOrder prepared_order = build_limit_order(
+                *order.account,
+                order.reservation,
+                entry.user_id,
+                entry.market_id,
+                *order.market,
+                entry.side,
+                entry.price,
+                entry.quantity,
+                order.sub_ledger);
+
+            if (!order_meta_store_.try_insert(prepared_order.id, std::move(prepared_order.meta)))
+            {
+                if (!order.sub_ledger)
+                {
+                    rollback_release_or_assert(
+                        *order.account,
+                        order.reservation,
+                        "Invariant violated: rollback release failed after limit submit error");
+                }
+                results[i] = std::unexpected(PlaceOrderError::OrderIdCollision);
+                continue;
+            }
+
+            auto batch = std::ranges::find(batches, entry.market_id, &MarketBatch::market_id);
+            if (batch == batches.end())
+                batch = batches.insert(batches.end(), MarketBatch{.market_id = entry.market_id});
+            batch->slots.push_back(i);
+            batch->requests.emplace_back(prepared_order.order_request);
+            prepared[i] = std::move(prepared_order);
+        }
+
+        // Results come back in request order, which is the order the worker
+        // matched them in; settling in that order keeps a batch order that
+        // rested and was then hit by a later one consistent.
+        const auto finish_batch = [this, &prepared, &results](const std::vector<std::size_t> &slots, SubmitBatchResult matched)
+        {
+            assert(matched.size() == slots.size() && "Invariant violated: batch result size mismatch");
+            for (std::size_t k = 0; k < slots.size(); ++k)
+                results[slots[k]] = finish_limit_order(*prepared[slots[k]], std::move(matched[k]));
+        };
+
+        // Launch every market before waiting on any, so they match in parallel.
+        for (MarketBatch &batch : batches)
+        {
+            if (!market_dispatcher_.has_settlement_stage(batch.market_id))
+            {
+                batch.matched = market_dispatcher_.submit_batch(batch.market_id, std::move(batch.requests));
+                continue;
+            }
+
+            std::promise<void> settled;
+            batch.settled = settled.get_future();
+            market_dispatcher_.submit_batch(
+                batch.market_id,
+                std::move(batch.requests),
+                [&finish_batch, &slots = batch.slots, settled = std::move(settled)](SubmitBatchResult matched) mutable
+                {
+                    finish_batch(slots, std::move(matched));
+                    settled.set_value();
+                });
+        }
+
+        for (MarketBatch &batch : batches)
+        {
+            if (batch.settled.valid())
+                batch.settled.wait();
+            else
+                finish_batch(batch.slots, batch.matched.get());
+        }
+
+        return results;
+    }
+
+    PlaceOrderAwaitable Exchange::place_limit_order_async(
+        IoThreadPool &io_pool,
+        const UserId user_id,
+        const Market &market,
+        const Side side,
+        const Price price,
+        const Quantity quantity)
+    {
+        return place_limit_order_async(
+            io_pool, user_id, market_dispatcher_.find_market_id(market).value_or(MarketId{}), side, price, quantity);
+    }
+
+    PlaceOrderAwaitable Exchange::place_limit_order_async(
+        IoThreadPool &io_pool,
+        const UserId user_id,
+        const MarketId market_id,
+        const Side side,
+        const Price price,
+        const Quantity quantity)
+    {
+        auto pending = begin_limit_order(user_id, market_id, side, price, quantity);
+        if (!pending)
+            return PlaceOrderAwaitable{std::unexpected(pending.error())};
+
+        auto [order, order_request] = std::move(pending.value());
+
+        return PlaceOrderAwaitable{
+            io_pool,
+            [this, order_request = std::move(order_request)](vertex::engine::SubmitCompletion on_done) mutable
+            {
+                market_dispatcher_.submit(std::move(order_request), std::move(on_done));
+            },
+            [this, order = std::move(order)](SubmitResult matching_result)
+            {
+                return finish_limit_order(order, std::move(matching_result));
+            },
+            market_dispatcher_.has_settlement_stage(market_id)};
+    }
+
+    std::expected<std::pair<Exchange::PreparedLimitOrder, OrderRequest>, PlaceOrderError> Exchange::begin_limit_order(
+        const UserId user_id,
+        const MarketId market_id,
+        const Side side,
+        const Price price,
+        const Quantity quantity)
+    {
+        const Market *market = market_dispatcher_.find_market(market_id);
         auto order_validation_error = validate_order(user_id, market, price, quantity);
         if (order_validation_error)
             return std::unexpected(order_validation_error.value());
 
-        auto prepared_limit_order = prepare_and_reserve_limit_order(user_id, market, side, price, quantity);
+        auto spec_error = check_market_spec(*market_dispatcher_.find_market_spec(market_id), price, quantity);
+        if (spec_error)
+            return std::unexpected(spec_error.value());
+
+        auto prepared_limit_order = prepare_and_reserve_limit_order(user_id, market_id, *market, side, price, quantity);
         if (!prepared_limit_order)
             return std::unexpected(prepared_limit_order.error());
 
-        Asset asset_to_reserve = std::move(prepared_limit_order->asset_to_reserve);
-        Quantity quantity_to_reserve = prepared_limit_order->quantity_to_reserve;
-        std::shared_ptr<Account> account = std::move(prepared_limit_order->account);
-        OrderId order_id = prepared_limit_order->id;
-        LimitOrderRequest limit_order_request = std::move(prepared_limit_order->order_request);
+        if (!order_meta_store_.try_insert(prepared_limit_order->id, std::move(prepared_limit_order->meta)))
+        {
+            if (!prepared_limit_order->sub_ledger)
+            {
+                rollback_release_or_assert(
+                    *prepared_limit_order->account,
+                    prepared_limit_order->reservation,
+                    "Invariant violated: rollback release failed after limit submit error");
+            }
+            return std::unexpected(PlaceOrderError::OrderIdCollision);
+        }
+
+        OrderRequest order_request = std::move(prepared_limit_order->order_request);
+        return std::pair{std::move(prepared_limit_order.value()), std::move(order_request)};
+    }
+
+    std::expected<OrderPlacementResult, PlaceOrderError> Exchange::finish_limit_order(
+        const PreparedLimitOrder &order,
+        SubmitResult matching_result)
+    {
+        const Market &market = *order.market;
+
+        if (!matching_result)
+        {
+            if (!order.sub_ledger)
+            {
+                rollback_release_or_assert(
+                    *order.account,
+                    order.reservation,
+                    "Invariant violated: rollback release failed after limit submit error");
+            }
+            order_meta_store_.erase(order.id);
+            return std::unexpected(map_to_place_order_error(matching_result.error()));
+        }
 
         OrderPlacementResult order_result;
-        order_result.order_id = limit_order_request.id;
-        order_result.remaining_quantity = quantity;
+        order_result.order_id = order.id;
+        order_result.remaining_quantity = order.base_quantity;
         order_result.filled_quantity = 0;
 
-        if (!order_meta_store_.try_insert(order_id, std::move(prepared_limit_order->meta)))
+        // Settle before any record is written. A remainder that rested is
+        // visible to other threads already and may have been filled or
+        // canceled and its meta closed; the closed meta still holds this
+        // share until it is drawn here. A sub-ledger market's worker has
+        // settled already.
+        SettlementBatch settlement{.taker_side = order.order_request.side};
+        if (!order.sub_ledger)
         {
-            rollback_release_or_assert(
-                *account,
-                asset_to_reserve,
-                quantity_to_reserve,
-                "Invariant violated: rollback release failed after limit submit error");
-            return std::unexpected(PlaceOrderError::OrderIdCollision);
+            for (const Execution &execution : matching_result.value())
+                add_fill(settlement, execution);
         }
 
-        auto matching_result = market_dispatcher_.submit(std::move(limit_order_request)).get();
-        if (!matching_result)
+        if (!settlement.counterparties.empty())
         {
-            rollback_release_or_assert(
-                *account,
-                asset_to_reserve,
-                quantity_to_reserve,
-                "Invariant violated: rollback release failed after limit submit error");
-            order_meta_store_.erase(order_id);
-            return std::unexpected(map_to_place_order_error(matching_result.error()));
+            auto taker_funds = order_meta_store_.draw_reservation(order.id, settlement.taker_draw);
+            assert(taker_funds && "Invariant violated: filled order has no reservation");
+            settle_batch(*order.account, *taker_funds, settlement, market);
         }
 
         for (const Execution &execution : matching_result.value())
         {
             OrderId buyer_order_id = execution.buy_order_id;
             OrderId seller_order_id = execution.sell_order_id;
-
-            auto buyer_order_meta = order_meta_store_.find(buyer_order_id);
-            assert(buyer_order_meta != std::nullopt);
-            UserId buyer_user_id = buyer_order_meta->owner;
-
-            auto seller_order_meta = order_meta_store_.find(seller_order_id);
-            assert(seller_order_meta != std::nullopt);
-            UserId seller_user_id = seller_order_meta->owner;
-
-            auto [buyer, seller] = get_accounts(buyer_user_id, seller_user_id);
-            assert((buyer != nullptr && seller != nullptr) && "Invariant violated: buyer or seller not exist");
-
-            settle_trade(*buyer, *seller, execution, market);
+            UserId buyer_user_id = execution.buy_owner;
+            UserId seller_user_id = execution.sell_owner;
 
             order_result.remaining_quantity -= execution.quantity;
             order_result.filled_quantity += execution.quantity;
 
-            TradeId trade_id;
-            {
-                std::lock_guard lock(trade_id_generator_mu_);
-                trade_id = trade_id_generator_.next();
-            }
+            const TradeId trade_id = execution.trade_id;
+            assert(trade_id.is_valid() && "Invariant violated: execution without a trade id");
 
             Trade trade{
                 trade_id,
@@ -160,14 +497,14 @@ namespace vertex::application
 
             if (execution.buy_fully_filled)
             {
-                auto record = order_meta_store_.close_and_extract(execution.buy_order_id, OrderStatus::Filled);
+                auto record = order_meta_store_.close_and_extract(execution.buy_order_id, OrderStatus::Filled, market);
                 if (record)
                     order_history_.try_insert(std::move(record.value()));
             }
 
             if (execution.sell_fully_filled)
             {
-                auto record = order_meta_store_.close_and_extract(execution.sell_order_id, OrderStatus::Filled);
+                auto record = order_meta_store_.close_and_extract(execution.sell_order_id, OrderStatus::Filled, market);
                 if (record)
                     order_history_.try_insert(std::move(record.value()));
             }
@@ -182,110 +519,211 @@ namespace vertex::application
         const Side side,
         const Quantity order_quantity)
     {
-        auto order_validation_error = validate_order(user_id, market, std::nullopt, order_quantity);
-        if (order_validation_error)
-            return std::unexpected(order_validation_error.value());
-
-        Asset asset_to_reserve = (side == Side::Buy) ? market.quote() : market.base();
+        return execute_market_order(user_id, market_dispatcher_.find_market_id(market).value_or(MarketId{}), side, order_quantity);
+    }
 
-        std::shared_ptr<Account> account = get_account(user_id);
-        if (account == nullptr)
-            return std::unexpected(PlaceOrderError::UserNotFound);
+    std::expected<OrderPlacementResult, PlaceOrderError> Exchange::execute_market_order(
+        const UserId user_id,
+        const MarketId market_id,
+        const Side side,
+        const Quantity order_quantity)
+    {
+        auto pending = begin_market_order(user_id, market_id, side, order_quantity);
+        if (!pending)
+            return std::unexpected(pending.error());
 
-        std::expected<void, WalletError> reserve_result;
+        auto [order, order_request] = std::move(pending.value());
+        if (market_dispatcher_.has_settlement_stage(market_id))
         {
-            std::lock_guard lock(account->mu);
-            reserve_result = account->wallet.reserve(asset_to_reserve, order_quantity);
+            return finish_in_completion<SubmitResult>(
+                [this, &order_request](vertex::engine::SubmitCompletion on_done)
+                {
+                    market_dispatcher_.submit(std::move(order_request), std::move(on_done));
+                },
+                [this, &order](SubmitResult matching_result)
+                {
+                    return finish_market_order(order, std::move(matching_result));
+                });
         }
-        if (!reserve_result)
-            return std::unexpected(PlaceOrderError::InsufficientFunds);
 
-        std::expected<OrderPlacementResult, PlaceOrderError> order_result;
-        if (side == Side::Buy)
-            order_result = execute_market_buy_by_quote(user_id, market, order_quantity);
-        else
-            order_result = execute_market_sell_by_base(user_id, market, order_quantity);
+        auto matching_result = market_dispatcher_.submit(std::move(order_request)).get();
+        return finish_market_order(order, std::move(matching_result));
+    }
 
-        if (!order_result)
-        {
-            rollback_release_or_assert(
-                *account,
-                asset_to_reserve,
-                order_quantity,
-                "Invariant violated: rollback release failed after market submit error");
-        }
+    PlaceOrderAwaitable Exchange::execute_market_order_async(
+        IoThreadPool &io_pool,
+        const UserId user_id,
+        const Market &market,
+        const Side side,
+        const Quantity order_quantity)
+    {
+        return execute_market_order_async(
+            io_pool, user_id, market_dispatcher_.find_market_id(market).value_or(MarketId{}), side, order_quantity);
+    }
 
-        return order_result;
+    PlaceOrderAwaitable Exchange::execute_market_order_async(
+        IoThreadPool &io_pool,
+        const UserId user_id,
+        const MarketId market_id,
+        const Side side,
+        const Quantity order_quantity)
+    {
+        auto pending = begin_market_order(user_id, market_id, side, order_quantity);
+        if (!pending)
+            return PlaceOrderAwaitable{std::unexpected(pending.error())};
+
+        auto [order, order_request] = std::move(pending.value());
+
+        return PlaceOrderAwaitable{
+            io_pool,
+            [this, order_request = std::move(order_request)](vertex::engine::SubmitCompletion on_done) mutable
+            {
+                market_dispatcher_.submit(std::move(order_request), std::move(on_done));
+            },
+            [this, order = std::move(order)](SubmitResult matching_result)
+            {
+                return finish_market_order(order, std::move(matching_result));
+            },
+            market_dispatcher_.has_settlement_stage(market_id)};
     }
 
-    std::expected<OrderPlacementResult, PlaceOrderError> Exchange::execute_market_buy_by_quote(
+    std::expected<std::pair<Exchange::PendingMarketOrder, OrderRequest>, PlaceOrderError> Exchange::begin_market_order(
         const UserId user_id,
-        const Market &market,
+        const MarketId market_id,
+        const Side side,
         const Quantity order_quantity)
     {
-        OrderPlacementResult order_result;
+        const Market *market = market_dispatcher_.find_market(market_id);
+        auto order_validation_error = validate_order(user_id, market, std::nullopt, order_quantity);
+        if (order_validation_error)
+            return std::unexpected(order_validation_error.value());
+
+        // A market buy sizes its quote budget, so only a sell is lot-checked.
+        std::optional<Quantity> base_quantity;
+        if (side == Side::Sell)
+            base_quantity = order_quantity;
+        auto spec_error = check_market_spec(*market_dispatcher_.find_market_spec(market_id), std::nullopt, base_quantity);
+        if (spec_error)
+            return std::unexpected(spec_error.value());
 
-        OrderId order_id;
+        Asset asset_to_reserve = (side == Side::Buy) ? market->quote() : market->base();
+
+        Account *account = get_account(user_id);
+        if (account == nullptr)
+            return std::unexpected(PlaceOrderError::UserNotFound);
+
+        const bool sub_ledger = market_dispatcher_.has_sub_ledger(market_id);
+        Reservation reservation{};
+        if (!sub_ledger)
         {
-            std::lock_guard lock(order_id_generator_mu_);
-            order_id = order_id_generator_.next();
+            const auto reserve_result = with_wallet(
+                *account,
+                [&](auto &wallet)
+                {
+                    return wallet.reserve(asset_to_reserve, order_quantity);
+                });
+            if (!reserve_result)
+                return std::unexpected(PlaceOrderError::InsufficientFunds);
+            reservation = reserve_result.value();
         }
 
-        MarketBuyByQuoteRequest order_request{
+        const OrderId order_id = order_id_generator_.next_local();
+
+        OrderRequest order_request = side == Side::Buy
+                                         ? OrderRequest{MarketBuyByQuoteRequest{
+                                               .id = order_id,
+                                               .user_id = user_id,
+                                               .market = market_id,
+                                               .quote_budget = order_quantity,
+                                           }}
+                                         : OrderRequest{MarketSellByBaseRequest{
+                                               .id = order_id,
+                                               .user_id = user_id,
+                                               .market = market_id,
+                                               .base_quantity = order_quantity,
+                                           }};
+
+        PendingMarketOrder order{
+            .account = account,
+            .reservation = reservation,
             .id = order_id,
-            .user_id = user_id,
             .market = market,
-            .quote_budget = order_quantity,
+            .side = side,
+            .order_quantity = order_quantity,
+            .sub_ledger = sub_ledger,
         };
 
-        order_result.order_id = order_request.id;
-        order_result.remaining_quantity = order_quantity;
-        order_result.filled_quantity = 0;
+        return std::pair{std::move(order), std::move(order_request)};
+    }
 
-        auto execution_result_expected = market_dispatcher_.submit(std::move(order_request)).get();
-        if (!execution_result_expected)
-            return std::unexpected(map_to_place_order_error(execution_result_expected.error()));
+    std::expected<OrderPlacementResult, PlaceOrderError> Exchange::finish_market_order(
+        const PendingMarketOrder &order,
+        SubmitResult matching_result)
+    {
+        if (!matching_result)
+        {
+            if (!order.sub_ledger)
+            {
+                rollback_release_or_assert(
+                    *order.account,
+                    order.reservation,
+                    "Invariant violated: rollback release failed after market submit error");
+            }
+            return std::unexpected(map_to_place_order_error(matching_result.error()));
+        }
 
-        std::vector<Execution> execution_result = execution_result_expected.value();
+        if (order.side == Side::Buy)
+            return settle_market_buy_by_quote(order, matching_result.value());
 
-        std::shared_ptr<Account> buyer = get_account(user_id);
-        if (buyer == nullptr)
-            return std::unexpected(PlaceOrderError::UserNotFound);
+        return settle_market_sell_by_base(order, matching_result.value());
+    }
+
+    OrderPlacementResult Exchange::settle_market_buy_by_quote(
+        const PendingMarketOrder &order,
+        const std::vector<Execution> &execution_result)
+    {
+        const UserId user_id = order.account->id;
+        const Market &market = *order.market;
+        Account &buyer = *order.account;
+        Reservation budget = order.reservation;
+
+        OrderPlacementResult order_result;
+        order_result.order_id = order.id;
+        order_result.remaining_quantity = order.order_quantity;
+        order_result.filled_quantity = 0;
 
         OrderRecord taker_record{
             .id = order_result.order_id,
-            .user_id = buyer->user.id(),
+            .user_id = user_id,
             .market = market,
             .side = Side::Buy,
             .type = OrderType::MarketOrder,
             .status = OrderStatus::Filled,
-            .requested_quote_budget = order_quantity,
+            .requested_quote_budget = order.order_quantity,
         };
 
+        if (!order.sub_ledger)
+        {
+            SettlementBatch settlement{.taker_side = Side::Buy};
+            for (const Execution &execution : execution_result)
+                add_fill(settlement, execution);
+            settle_batch(buyer, budget.split(settlement.taker_draw), settlement, market);
+        }
+
         for (const Execution &execution : execution_result)
         {
             OrderId seller_order_id = execution.sell_order_id;
-            auto seller_order_meta = order_meta_store_.find(seller_order_id);
-            assert(seller_order_meta != std::nullopt);
-            UserId seller_user_id = seller_order_meta->owner;
-
-            std::shared_ptr<Account> seller = get_account(seller_user_id);
-            assert(seller != nullptr && "Invariant violated: seller not exist");
-
-            settle_trade(*buyer, *seller, execution, market);
+            UserId seller_user_id = execution.sell_owner;
 
-            order_result.remaining_quantity -= execution.quantity * execution.execution_price;
-            order_result.filled_quantity += execution.quantity * execution.execution_price;
+            order_result.remaining_quantity -= vertex::core::notional(execution.execution_price, execution.quantity);
+            order_result.filled_quantity += vertex::core::notional(execution.execution_price, execution.quantity);
 
             taker_record.executed_base_qty += execution.quantity;
-            taker_record.executed_quote_qty += execution.quantity * execution.execution_price;
+            taker_record.executed_quote_qty += vertex::core::notional(execution.execution_price, execution.quantity);
             taker_record.fill_count += 1;
 
-            TradeId trade_id;
-            {
-                std::lock_guard lock(trade_id_generator_mu_);
-                trade_id = trade_id_generator_.next();
-            }
+            const TradeId trade_id = execution.trade_id;
+            assert(trade_id.is_valid() && "Invariant violated: execution without a trade id");
 
             Trade trade{
                 trade_id,
@@ -305,13 +743,14 @@ namespace vertex::application
 
             if (execution.sell_fully_filled)
             {
-                auto record = order_meta_store_.close_and_extract(execution.sell_order_id, OrderStatus::Filled);
+                auto record = order_meta_store_.close_and_extract(execution.sell_order_id, OrderStatus::Filled, market);
                 if (record)
                     order_history_.try_insert(std::move(record.value()));
             }
         }
 
         taker_record.avg_price = compute_avg_price(taker_record.executed_base_qty, taker_record.executed_quote_qty);
+        assert((order.sub_ledger || budget.remaining == order_result.remaining_quantity) && "Invariant violated: market buy budget accounting drifted");
 
         if (order_result.remaining_quantity > 0)
         {
@@ -320,9 +759,16 @@ namespace vertex::application
             else
                 taker_record.status = OrderStatus::PartiallyFilled;
 
-            std::lock_guard lock(buyer->mu);
-            const auto taker_release_result = buyer->wallet.release(market.quote(), order_result.remaining_quantity);
-            assert(taker_release_result && "Invariant violated: taker release failed after market buy");
+            if (!order.sub_ledger)
+            {
+                const auto taker_release_result = with_wallet(
+                    buyer,
+                    [&](auto &wallet)
+                    {
+                        return wallet.release(budget, order_result.remaining_quantity);
+                    });
+                assert(taker_release_result && "Invariant violated: taker release failed after market buy");
+            }
         }
 
         order_history_.try_insert(std::move(taker_record));
@@ -330,75 +776,52 @@ namespace vertex::application
         return order_result;
     }
 
-    std::expected<OrderPlacementResult, PlaceOrderError> Exchange::execute_market_sell_by_base(
-        const UserId user_id,
-        const Market &market,
-        const Quantity order_quantity)
+    OrderPlacementResult Exchange::settle_market_sell_by_base(
+        const PendingMarketOrder &order,
+        const std::vector<Execution> &execution_result)
     {
-        OrderPlacementResult order_result;
+        const UserId user_id = order.account->id;
+        const Market &market = *order.market;
+        Account &seller = *order.account;
+        Reservation base_held = order.reservation;
 
-        OrderId order_id;
-        {
-            std::lock_guard lock(order_id_generator_mu_);
-            order_id = order_id_generator_.next();
-        }
-
-        MarketSellByBaseRequest order_request{
-            .id = order_id,
-            .user_id = user_id,
-            .market = market,
-            .base_quantity = order_quantity,
-        };
-
-        order_result.order_id = order_request.id;
-        order_result.remaining_quantity = order_quantity;
+        OrderPlacementResult order_result;
+        order_result.order_id = order.id;
+        order_result.remaining_quantity = order.order_quantity;
         order_result.filled_quantity = 0;
 
-        auto execution_result_expected = market_dispatcher_.submit(std::move(order_request)).get();
-        if (!execution_result_expected)
-            return std::unexpected(map_to_place_order_error(execution_result_expected.error()));
-
-        std::vector<Execution> execution_result = execution_result_expected.value();
-
-        std::shared_ptr<Account> seller = get_account(user_id);
-        if (seller == nullptr)
-            return std::unexpected(PlaceOrderError::UserNotFound);
-
         OrderRecord taker_record{
             .id = order_result.order_id,
-            .user_id = seller->user.id(),
+            .user_id = user_id,
             .market = market,
             .side = Side::Sell,
             .type = OrderType::MarketOrder,
             .status = OrderStatus::Filled,
-            .requested_base_qty = order_quantity,
+            .requested_base_qty = order.order_quantity,
         };
 
+        if (!order.sub_ledger)
+        {
+            SettlementBatch settlement{.taker_side = Side::Sell};
+            for (const Execution &execution : execution_result)
+                add_fill(settlement, execution);
+            settle_batch(seller, base_held.split(settlement.taker_draw), settlement, market);
+        }
+
         for (const Execution &execution : execution_result)
         {
             OrderId buyer_order_id = execution.buy_order_id;
-
-            auto buyer_order_meta = order_meta_store_.find(buyer_order_id);
-            assert(buyer_order_meta != std::nullopt);
-            UserId buyer_user_id = buyer_order_meta->owner;
-
-            std::shared_ptr<Account> buyer = get_account(buyer_user_id);
-            assert(buyer != nullptr && "Invariant violated: buyer not exist");
-
-            settle_trade(*buyer, *seller, execution, market);
+            UserId buyer_user_id = execution.buy_owner;
 
             order_result.remaining_quantity -= execution.quantity;
             order_result.filled_quantity += execution.quantity;
 
             taker_record.executed_base_qty += execution.quantity;
-            taker_record.executed_quote_qty += execution.quantity * execution.execution_price;
+            taker_record.executed_quote_qty += vertex::core::notional(execution.execution_price, execution.quantity);
             taker_record.fill_count += 1;
 
-            TradeId trade_id;
-            {
-                std::lock_guard lock(trade_id_generator_mu_);
-                trade_id = trade_id_generator_.next();
-            }
+            const TradeId trade_id = execution.trade_id;
+            assert(trade_id.is_valid() && "Invariant violated: execution without a trade id");
 
             Trade trade{
                 trade_id,
@@ -418,13 +841,14 @@ namespace vertex::application
 
             if (execution.buy_fully_filled)
             {
-                auto record = order_meta_store_.close_and_extract(execution.buy_order_id, OrderStatus::Filled);
+                auto record = order_meta_store_.close_and_extract(execution.buy_order_id, OrderStatus::Filled, market);
                 if (record)
                     order_history_.try_insert(std::move(record.value()));
             }
         }
 
         taker_record.avg_price = compute_avg_price(taker_record.executed_base_qty, taker_record.executed_quote_qty);
+        assert((order.sub_ledger || base_held.remaining == order_result.remaining_quantity) && "Invariant violated: market sell reservation accounting drifted");
 
         if (order_result.remaining_quantity > 0)
         {
@@ -433,9 +857,16 @@ namespace vertex::application
             else
                 taker_record.status = OrderStatus::PartiallyFilled;
 
-            std::lock_guard lock(seller->mu);
-            const auto taker_release_result = seller->wallet.release(market.base(), order_result.remaining_quantity);
-            assert(taker_release_result && "Invariant violated: taker release failed after market sell");
+            if (!order.sub_ledger)
+            {
+                const auto taker_release_result = with_wallet(
+                    seller,
+                    [&](auto &wallet)
+                    {
+                        return wallet.release(base_held, order_result.remaining_quantity);
+                    });
+                assert(taker_release_result && "Invariant violated: taker release failed after market sell");
+            }
         }
 
         order_history_.try_insert(std::move(taker_record));
@@ -445,20 +876,75 @@ namespace vertex::application
 
     std::expected<CancelOrderResult, CancelOrderError> Exchange::cancel_order(const UserId user_id, const OrderId order_id)
     {
+        auto pending = begin_cancel(user_id, order_id);
+        if (!pending)
+            return std::unexpected(pending.error());
+
+        const MarketId market_id = pending->order.market;
+        if (market_dispatcher_.has_settlement_stage(market_id))
         {
-            std::shared_lock lock(accounts_mu_);
-            if (accounts_.find(user_id) == accounts_.end())
-                return std::unexpected(CancelOrderError::UserNotFound);
+            return finish_in_completion<CancelResultEx>(
+                [this, market_id, order_id](vertex::engine::CancelCompletion on_done)
+                {
+                    market_dispatcher_.cancel(market_id, order_id, std::move(on_done));
+                },
+                [this, &pending](CancelResultEx cancel_result)
+                {
+                    return finish_cancel(*pending, std::move(cancel_result));
+                });
         }
 
-        const auto order = order_meta_store_.find(order_id);
+        auto cancel_result = market_dispatcher_.cancel(market_id, order_id).get();
+        return finish_cancel(*pending, std::move(cancel_result));
+    }
+
+    CancelOrderAwaitable Exchange::cancel_order_async(IoThreadPool &io_pool, const UserId user_id, const OrderId order_id)
+    {
+        auto pending = begin_cancel(user_id, order_id);
+        if (!pending)
+            return CancelOrderAwaitable{std::unexpected(pending.error())};
+
+        const MarketId market_id = pending->order.market;
+
+        return CancelOrderAwaitable{
+            io_pool,
+            [this, market_id, order_id](vertex::engine::CancelCompletion on_done) mutable
+            {
+                market_dispatcher_.cancel(market_id, order_id, std::move(on_done));
+            },
+            [this, cancel = std::move(*pending)](CancelResultEx cancel_result)
+            {
+                return finish_cancel(cancel, std::move(cancel_result));
+            },
+            market_dispatcher_.has_settlement_stage(market_id)};
+    }
+
+    std::expected<Exchange::PendingCancel, CancelOrderError> Exchange::begin_cancel(const UserId user_id, const OrderId order_id)
+    {
+        Account *account = get_account(user_id);
+        if (account == nullptr)
+            return std::unexpected(CancelOrderError::UserNotFound);
+
+        auto order = order_meta_store_.find(order_id);
         if (order == std::nullopt)
             return std::unexpected(CancelOrderError::OrderNotFound);
 
         if (order->owner != user_id)
             return std::unexpected(CancelOrderError::NotOrderOwner);
 
-        auto cancel_result_expected = market_dispatcher_.cancel(order->market, order_id).get();
+        const bool sub_ledger = market_dispatcher_.has_sub_ledger(order->market);
+        return PendingCancel{
+            .account = account,
+            .order_id = order_id,
+            .order = std::move(order.value()),
+            .sub_ledger = sub_ledger,
+        };
+    }
+
+    std::expected<CancelOrderResult, CancelOrderError> Exchange::finish_cancel(
+        const PendingCancel &cancel,
+        CancelResultEx cancel_result_expected)
+    {
         if (!cancel_result_expected)
             return std::unexpected(map_to_cancel_order_error(cancel_result_expected.error()));
 
@@ -466,68 +952,96 @@ namespace vertex::application
         if (cancel_result == std::nullopt)
             return std::unexpected(CancelOrderError::OrderNotFound);
 
-        std::shared_ptr<Account> account = get_account(user_id);
-        if (account == nullptr)
-            return std::unexpected(CancelOrderError::UserNotFound);
+        Account &account = *cancel.account;
+        const OrderMeta &order = cancel.order;
+        const Market *market = market_dispatcher_.find_market(order.market);
+        assert(market != nullptr && "Invariant violated: resting order on unknown market");
 
-        CancelOrderResult result;
-        if (cancel_result->side == Side::Buy)
+        // Whatever is still in the book goes back; fills settled elsewhere draw
+        // their own share, even once the close below has run. A sub-ledger
+        // market's worker released it already.
+        if (!cancel.sub_ledger)
         {
-            std::lock_guard lock(account->mu);
-            const auto buyer_release_result =
-                account->wallet.release(order->market.quote(), cancel_result->remaining_quantity * cancel_result->price);
-            assert(buyer_release_result && "Invariant violated: buyer release failed");
-            result.side = Side::Buy;
-        }
-        else
-        {
-            std::lock_guard lock(account->mu);
-            const auto seller_release_result = account->wallet.release(order->market.base(), cancel_result->remaining_quantity);
-            assert(seller_release_result && "Invariant violated: seller release failed");
-            result.side = Side::Sell;
+            const Quantity unfilled_reserved = cancel_result->side == Side::Buy
+                                                   ? vertex::core::notional(cancel_result->price, cancel_result->remaining_quantity)
+                                                   : cancel_result->remaining_quantity;
+            auto held = order_meta_store_.draw_reservation(cancel.order_id, unfilled_reserved);
+            assert(held && "Invariant violated: canceled order has no reservation");
+
+            const auto release_result = with_wallet(
+                account,
+                [&](auto &wallet)
+                {
+                    return wallet.release(*held, unfilled_reserved);
+                });
+            assert(release_result && "Invariant violated: cancel release failed");
         }
 
-        auto record = order_meta_store_.close_and_extract(order_id, OrderStatus::Canceled);
+        CancelOrderResult result;
+        result.side = cancel_result->side;
+
+        auto record = order_meta_store_.close_and_extract(cancel.order_id, OrderStatus::Canceled, *market);
         if (record)
             order_history_.try_insert(std::move(record.value()));
 
-        result.id = order_id;
+        result.id = cancel.order_id;
         result.remaining_quantity = cancel_result->remaining_quantity;
         return result;
     }
 
     std::expected<Exchange::PreparedLimitOrder, PlaceOrderError> Exchange::prepare_and_reserve_limit_order(
         const UserId &user_id,
+        const MarketId market_id,
         const Market &market,
         const Side &side,
         const Price &price,
         const Quantity &quantity)
     {
         Asset asset_to_reserve = (side == Side::Buy) ? market.quote() : market.base();
-        Quantity quantity_to_reserve = (side == Side::Buy) ? price * quantity : quantity;
+        const std::optional<Quantity> quantity_to_reserve =
+            (side == Side::Buy) ? vertex::core::checked_notional(price, quantity) : quantity;
+        if (!quantity_to_reserve)
+            return std::unexpected(PlaceOrderError::NotionalOverflow);
 
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(PlaceOrderError::UserNotFound);
 
-        std::expected<void, WalletError> reserve_result;
+        const bool sub_ledger = market_dispatcher_.has_sub_ledger(market_id);
+        Reservation reservation{};
+        if (!sub_ledger)
         {
-            std::lock_guard lock(account->mu);
-            reserve_result = account->wallet.reserve(asset_to_reserve, quantity_to_reserve);
+            const auto reserve_result = with_wallet(
+                *account,
+                [&](auto &wallet)
+                {
+                    return wallet.reserve(asset_to_reserve, *quantity_to_reserve);
+                });
+            if (!reserve_result)
+                return std::unexpected(PlaceOrderError::InsufficientFunds);
+            reservation = reserve_result.value();
         }
-        if (!reserve_result)
-            return std::unexpected(PlaceOrderError::InsufficientFunds);
 
-        OrderId id;
-        {
-            std::lock_guard lock(order_id_generator_mu_);
-            id = order_id_generator_.next();
-        }
+        return build_limit_order(*account, reservation, user_id, market_id, market, side, price, quantity, sub_ledger);
+    }
+
+    Exchange::PreparedLimitOrder Exchange::build_limit_order(
+        Account &account,
+        Reservation reservation,
+        const UserId user_id,
+        const MarketId market_id,
+        const Market &market,
+        const Side side,
+        const Price price,
+        const Quantity quantity,
+        const bool sub_ledger)
+    {
+        const OrderId id = order_id_generator_.next_local();
 
         LimitOrderRequest limit_order_request{
             .id = id,
             .user_id = user_id,
-            .market = market,
+            .market = market_id,
             .side = side,
             .limit_price = price,
             .base_quantity = quantity,
@@ -535,19 +1049,22 @@ namespace vertex::application
 
         OrderMeta meta{
             .owner = user_id,
-            .market = market,
+            .market = market_id,
             .side = side,
             .price = price,
             .requested_base_qty = quantity,
+            .reservation = reservation,
         };
 
         return PreparedLimitOrder{
-            .account = std::move(account),
-            .asset_to_reserve = std::move(asset_to_reserve),
-            .quantity_to_reserve = quantity_to_reserve,
+            .account = &account,
+            .reservation = reservation,
             .id = id,
+            .market = &market,
+            .base_quantity = quantity,
             .order_request = std::move(limit_order_request),
             .meta = std::move(meta),
+            .sub_ledger = sub_ledger,
         };
     }
 
@@ -1,5 +1,7 @@
 #include "vertex/application/exchange.hpp"
+#include "vertex/core/notional.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 
@@ -36,74 +38,175 @@ namespace vertex::application
 
             return locks;
         }
-    } // namespace
-
-    void Exchange::settle_trade(Account &buyer, Account &seller, const Execution &execution, const Market &market)
-    {
-        auto locks = lock_two_accounts(buyer.user.id(), buyer, seller.user.id(), seller);
-
-        const auto buyer_consume_result = buyer.wallet.consume_reserved(market.quote(), execution.execution_price * execution.quantity);
-        assert(buyer_consume_result && "Invariant violated: buyer reserved quote must cover executed notional");
 
-        if (execution.buy_order_limit_price)
+        // Each leg touches one wallet only, so a partitioned ledger can run
+        // them on different threads. The caller provides exclusion for
+        // Wallet, AtomicWallet needs none.
+        template <typename WalletT>
+        void settle_buyer_leg(
+            WalletT &buyer,
+            Reservation &buyer_funds,
+            const Quantity base_quantity,
+            const Quantity quote_quantity,
+            const Asset &base)
         {
-            Quantity refund =
-                execution.buy_order_limit_price.value() * execution.quantity - execution.execution_price * execution.quantity;
-            if (0 < refund)
+            const auto buyer_consume_result = buyer.consume_reserved(buyer_funds, quote_quantity);
+            assert(buyer_consume_result && "Invariant violated: buyer reserved quote must cover executed notional");
+
+            if (0 < buyer_funds.remaining)
             {
-                const auto buyer_release_result = buyer.wallet.release(market.quote(), refund);
+                const auto buyer_release_result = buyer.release(buyer_funds, buyer_funds.remaining);
                 assert(buyer_release_result && "Invariant violated: buyer refund release failed");
             }
+
+            const auto buyer_deposit_result = buyer.deposit(base, base_quantity);
+            assert(buyer_deposit_result && "Invariant violated: buyer base deposit failed");
         }
 
-        const auto buyer_deposit_result = buyer.wallet.deposit(market.base(), execution.quantity);
-        assert(buyer_deposit_result && "Invariant violated: buyer base deposit failed");
+        template <typename WalletT>
+        void settle_seller_leg(
+            WalletT &seller,
+            Reservation &seller_funds,
+            const Quantity base_quantity,
+            const Quantity quote_quantity,
+            const Asset &quote)
+        {
+            const auto seller_consume_result = seller.consume_reserved(seller_funds, base_quantity);
+            assert(seller_consume_result && "Invariant violated: seller reserved base must cover executed quantity");
+            assert(seller_funds.remaining == 0 && "Invariant violated: seller drew more than the executed quantity");
 
-        const auto seller_consume_result = seller.wallet.consume_reserved(market.base(), execution.quantity);
-        assert(seller_consume_result && "Invariant violated: seller reserved base must cover executed quantity");
+            const auto seller_deposit_result = seller.deposit(quote, quote_quantity);
+            assert(seller_deposit_result && "Invariant violated: seller quote deposit failed");
+        }
 
-        const auto seller_deposit_result = seller.wallet.deposit(market.quote(), execution.execution_price * execution.quantity);
-        assert(seller_deposit_result && "Invariant violated: seller quote deposit failed");
-    }
+        template <typename WalletT>
+        void apply_settlement(
+            WalletT &buyer,
+            Reservation &buyer_funds,
+            WalletT &seller,
+            Reservation &seller_funds,
+            const Quantity base_quantity,
+            const Quantity quote_quantity,
+            const Market &market)
+        {
+            settle_buyer_leg(buyer, buyer_funds, base_quantity, quote_quantity, market.base());
+            settle_seller_leg(seller, seller_funds, base_quantity, quote_quantity, market.quote());
+        }
+    } // namespace
 
-    std::shared_ptr<Account> Exchange::get_account(UserId id) const
+    void Exchange::add_fill(SettlementBatch &batch, const Execution &execution)
     {
-        std::shared_lock lock(accounts_mu_);
-        auto account_it = accounts_.find(id);
-        if (account_it == accounts_.end())
-            return nullptr;
+        const bool taker_buys = batch.taker_side == Side::Buy;
+        const UserId counterparty_id = taker_buys ? execution.sell_owner : execution.buy_owner;
+        const OrderId counterparty_order_id = taker_buys ? execution.sell_order_id : execution.buy_order_id;
+
+        // The buyer reserved at its limit price (a market buy at the execution price).
+        const Quantity buyer_draw = vertex::core::notional(execution.buy_order_limit_price.value_or(execution.execution_price), execution.quantity);
+        const Quantity quote_quantity = vertex::core::notional(execution.execution_price, execution.quantity);
+
+        auto entry = std::find_if(
+            batch.counterparties.begin(),
+            batch.counterparties.end(),
+            [&](const CounterpartyFills &fills)
+            {
+                return fills.user_id == counterparty_id;
+            });
+        if (entry == batch.counterparties.end())
+        {
+            Account *account = get_account(counterparty_id);
+            assert(account != nullptr && "Invariant violated: counterparty not exist");
+            entry = batch.counterparties.insert(
+                batch.counterparties.end(),
+                CounterpartyFills{.user_id = counterparty_id, .account = account, .funds = {}});
+        }
 
-        return account_it->second;
+        auto funds = order_meta_store_.draw_reservation(counterparty_order_id, taker_buys ? execution.quantity : buyer_draw);
+        assert(funds && "Invariant violated: filled order has no reservation");
+        entry->funds.absorb(*funds);
+
+        const Quantity taker_draw = taker_buys ? buyer_draw : execution.quantity;
+        entry->taker_draw += taker_draw;
+        entry->base_quantity += execution.quantity;
+        entry->quote_quantity += quote_quantity;
+        batch.taker_draw += taker_draw;
     }
 
-    std::pair<std::shared_ptr<Account>, std::shared_ptr<Account>> Exchange::get_accounts(UserId id_1, UserId id_2) const
+    void Exchange::settle_batch(Account &taker, Reservation taker_funds, SettlementBatch &batch, const Market &market)
     {
-        std::pair<std::shared_ptr<Account>, std::shared_ptr<Account>> result;
+        assert(taker_funds.remaining == batch.taker_draw && "Invariant violated: taker funds do not match the batch");
+        const bool taker_buys = batch.taker_side == Side::Buy;
 
-        std::shared_lock lock(accounts_mu_);
+        for (CounterpartyFills &fills : batch.counterparties)
+        {
+            Reservation taker_share = taker_funds.split(fills.taker_draw);
+            Account &buyer = taker_buys ? taker : *fills.account;
+            Account &seller = taker_buys ? *fills.account : taker;
+            Reservation &buyer_funds = taker_buys ? taker_share : fills.funds;
+            Reservation &seller_funds = taker_buys ? fills.funds : taker_share;
 
-        auto account_it_1 = accounts_.find(id_1);
-        if (account_it_1 != accounts_.end())
-            result.first = account_it_1->second;
+            if (ledger_)
+            {
+                // Wallets are only touched on their ledger thread; each leg
+                // lands behind anything already queued for that user.
+                ledger_->post(
+                    ledger_->partition_of(buyer.id),
+                    [&wallet = std::get<Wallet>(buyer.wallet), funds = buyer_funds, base = fills.base_quantity, quote = fills.quote_quantity, asset = market.base()]() mutable
+                    {
+                        settle_buyer_leg(wallet, funds, base, quote, asset);
+                    });
+                ledger_->post(
+                    ledger_->partition_of(seller.id),
+                    [&wallet = std::get<Wallet>(seller.wallet), funds = seller_funds, base = fills.base_quantity, quote = fills.quote_quantity, asset = market.quote()]() mutable
+                    {
+                        settle_seller_leg(wallet, funds, base, quote, asset);
+                    });
+                continue;
+            }
 
-        auto account_it_2 = accounts_.find(id_2);
-        if (account_it_2 != accounts_.end())
-            result.second = account_it_2->second;
+            if (wallet_mode_ == WalletMode::Atomic)
+            {
+                apply_settlement(
+                    std::get<AtomicWallet>(buyer.wallet),
+                    buyer_funds,
+                    std::get<AtomicWallet>(seller.wallet),
+                    seller_funds,
+                    fills.base_quantity,
+                    fills.quote_quantity,
+                    market);
+                continue;
+            }
 
-        return result;
+            auto locks = lock_two_accounts(buyer.id, buyer, seller.id, seller);
+            apply_settlement(
+                std::get<Wallet>(buyer.wallet),
+                buyer_funds,
+                std::get<Wallet>(seller.wallet),
+                seller_funds,
+                fills.base_quantity,
+                fills.quote_quantity,
+                market);
+        }
+    }
+
+    Account *Exchange::get_account(UserId id) const noexcept
+    {
+        if (!id.is_valid())
+            return nullptr;
+
+        return accounts_.find(id.get_value() - 1);
     }
 
     void Exchange::rollback_release_or_assert(
         Account &account,
-        const Asset &asset,
-        const Quantity quantity,
-        const std::string &context)
+        Reservation reservation,
+        [[maybe_unused]] const std::string &context)
     {
-        std::expected<void, WalletError> rollback_release_result;
-        {
-            std::lock_guard lock(account.mu);
-            rollback_release_result = account.wallet.release(asset, quantity);
-        }
+        [[maybe_unused]] const auto rollback_release_result = with_wallet(
+            account,
+            [&](auto &wallet)
+            {
+                return wallet.release(reservation, reservation.remaining);
+            });
 
         assert(rollback_release_result && context.c_str());
     }
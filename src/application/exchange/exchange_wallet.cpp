@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <exception>
+#include <optional>
 
 namespace vertex::application
 {
@@ -17,11 +18,41 @@ namespace vertex::application
                 return WalletOperationError::InsufficientFunds;
             case vertex::domain::WalletError::InvalidAmount:
                 return WalletOperationError::InvalidQuantity;
+            case vertex::domain::WalletError::BalanceOverflow:
+                return WalletOperationError::BalanceOverflow;
             default:
                 assert(false && "Unexpected WalletError in release");
                 std::terminate();
             }
         }
+
+        WalletOperationError map_ledger_error(EngineAsyncError error)
+        {
+            switch (error)
+            {
+            case EngineAsyncError::InsufficientFunds:
+                return WalletOperationError::InsufficientFunds;
+            case EngineAsyncError::BalanceOverflow:
+                return WalletOperationError::BalanceOverflow;
+            case EngineAsyncError::WorkerStopped:
+                return WalletOperationError::WorkerStopped;
+            case EngineAsyncError::MarketNotFound:
+            case EngineAsyncError::NoSubLedger:
+                return WalletOperationError::MarketNotFound;
+            default:
+                assert(false && "Unexpected EngineAsyncError in sub-ledger mapping");
+                return WalletOperationError::WorkerStopped;
+            }
+        }
+
+        std::optional<vertex::engine::LedgerAsset> ledger_asset_of(const Market &market, const Asset &asset)
+        {
+            if (asset == market.base())
+                return vertex::engine::LedgerAsset::Base;
+            if (asset == market.quote())
+                return vertex::engine::LedgerAsset::Quote;
+            return std::nullopt;
+        }
     } // namespace
 
     std::expected<void, WalletOperationError> Exchange::deposit(
@@ -29,15 +60,16 @@ namespace vertex::application
         const Asset &asset,
         const Quantity quantity)
     {
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(WalletOperationError::UserNotFound);
 
-        std::expected<void, WalletError> result;
-        {
-            std::lock_guard lock(account->mu);
-            result = account->wallet.deposit(asset, quantity);
-        }
+        const auto result = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.deposit(asset, quantity);
+            });
 
         if (!result)
             return std::unexpected(map_to_wallet_error(result.error()));
@@ -50,15 +82,16 @@ namespace vertex::application
         const Asset &asset,
         const Quantity quantity)
     {
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(WalletOperationError::UserNotFound);
 
-        std::expected<void, WalletError> result;
-        {
-            std::lock_guard lock(account->mu);
-            result = account->wallet.withdraw(asset, quantity);
-        }
+        const auto result = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.withdraw(asset, quantity);
+            });
 
         if (!result)
             return std::unexpected(map_to_wallet_error(result.error()));
@@ -71,15 +104,16 @@ namespace vertex::application
         const Asset &asset,
         const Quantity quantity)
     {
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(WalletOperationError::UserNotFound);
 
-        std::expected<void, WalletError> result;
-        {
-            std::lock_guard lock(account->mu);
-            result = account->wallet.reserve(asset, quantity);
-        }
+        const auto result = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.reserve(asset, quantity);
+            });
 
         if (!result)
             return std::unexpected(map_to_wallet_error(result.error()));
@@ -92,15 +126,16 @@ namespace vertex::application
         const Asset &asset,
         const Quantity quantity)
     {
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(WalletOperationError::UserNotFound);
 
-        std::expected<void, WalletError> result;
-        {
-            std::lock_guard lock(account->mu);
-            result = account->wallet.release(asset, quantity);
-        }
+        const auto result = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.release(asset, quantity);
+            });
 
         if (!result)
             return std::unexpected(map_to_wallet_error(result.error()));
@@ -110,22 +145,139 @@ namespace vertex::application
 
     std::expected<Quantity, WalletOperationError> Exchange::free_balance(const UserId user_id, const Asset &asset) const
     {
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(WalletOperationError::UserNotFound);
 
-        std::lock_guard lock(account->mu);
-        return account->wallet.free_balance(asset);
+        return with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.free_balance(asset);
+            });
     }
 
     std::expected<Quantity, WalletOperationError> Exchange::reserved_balance(const UserId user_id, const Asset &asset) const
     {
-        std::shared_ptr<Account> account = get_account(user_id);
+        Account *account = get_account(user_id);
+        if (account == nullptr)
+            return std::unexpected(WalletOperationError::UserNotFound);
+
+        return with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.reserved_balance(asset);
+            });
+    }
+
+    std::expected<void, WalletOperationError> Exchange::allocate_to_market(
+        const UserId user_id,
+        const MarketId market_id,
+        const Asset &asset,
+        const Quantity quantity)
+    {
+        Account *account = get_account(user_id);
         if (account == nullptr)
             return std::unexpected(WalletOperationError::UserNotFound);
 
-        std::lock_guard lock(account->mu);
-        return account->wallet.reserved_balance(asset);
+        if (!market_dispatcher_.has_sub_ledger(market_id))
+            return std::unexpected(WalletOperationError::MarketNotFound);
+
+        const auto ledger_asset = ledger_asset_of(*market_dispatcher_.find_market(market_id), asset);
+        if (!ledger_asset)
+            return std::unexpected(WalletOperationError::AssetNotInMarket);
+
+        if (quantity <= 0)
+            return std::unexpected(WalletOperationError::InvalidQuantity);
+
+        // Held as reserved, still counted in the wallet, until the sub-ledger
+        // takes it; a refused credit then only releases the hold, which
+        // cannot fail the way a refund deposit could.
+        auto held = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.reserve(asset, quantity);
+            });
+        if (!held)
+            return std::unexpected(map_to_wallet_error(held.error()));
+
+        const auto credited = market_dispatcher_.transfer(market_id, user_id, *ledger_asset, quantity, vertex::engine::LedgerTransfer::Credit).get();
+        [[maybe_unused]] const auto settled = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return credited ? wallet.consume_reserved(*held, quantity) : wallet.release(*held, quantity);
+            });
+        assert(settled && "Invariant violated: sub-ledger allocation hold did not settle");
+
+        if (!credited)
+            return std::unexpected(map_ledger_error(credited.error()));
+
+        return {};
+    }
+
+    std::expected<void, WalletOperationError> Exchange::return_from_market(
+        const UserId user_id,
+        const MarketId market_id,
+        const Asset &asset,
+        const Quantity quantity)
+    {
+        Account *account = get_account(user_id);
+        if (account == nullptr)
+            return std::unexpected(WalletOperationError::UserNotFound);
+
+        if (!market_dispatcher_.has_sub_ledger(market_id))
+            return std::unexpected(WalletOperationError::MarketNotFound);
+
+        const auto ledger_asset = ledger_asset_of(*market_dispatcher_.find_market(market_id), asset);
+        if (!ledger_asset)
+            return std::unexpected(WalletOperationError::AssetNotInMarket);
+
+        if (quantity <= 0)
+            return std::unexpected(WalletOperationError::InvalidQuantity);
+
+        // Held in the sub-ledger's reserved balance until the wallet takes it,
+        // so a refused deposit releases the hold instead of re-crediting,
+        // which a concurrent allocation could have made overflow.
+        const auto held = market_dispatcher_.transfer(market_id, user_id, *ledger_asset, quantity, vertex::engine::LedgerTransfer::Hold).get();
+        if (!held)
+            return std::unexpected(map_ledger_error(held.error()));
+
+        const auto deposited = with_wallet(
+            *account,
+            [&](auto &wallet)
+            {
+                return wallet.deposit(asset, quantity);
+            });
+
+        // Only a worker stopped in between refuses this, and its sub-ledger
+        // goes with it.
+        const auto direction = deposited ? vertex::engine::LedgerTransfer::DebitHeld : vertex::engine::LedgerTransfer::ReleaseHold;
+        [[maybe_unused]] const auto settled = market_dispatcher_.transfer(market_id, user_id, *ledger_asset, quantity, direction).get();
+        assert((settled || settled.error() == EngineAsyncError::WorkerStopped) &&
+               "Invariant violated: sub-ledger return hold did not settle");
+
+        if (!deposited)
+            return std::unexpected(map_to_wallet_error(deposited.error()));
+
+        return {};
+    }
+
+    std::expected<SubLedgerBalance, WalletOperationError> Exchange::market_balance(const UserId user_id, const MarketId market_id)
+    {
+        if (get_account(user_id) == nullptr)
+            return std::unexpected(WalletOperationError::UserNotFound);
+
+        if (!market_dispatcher_.has_sub_ledger(market_id))
+            return std::unexpected(WalletOperationError::MarketNotFound);
+
+        auto balance = market_dispatcher_.ledger_balance(market_id, user_id).get();
+        if (!balance)
+            return std::unexpected(map_ledger_error(balance.error()));
+
+        return *balance;
     }
 
 } // namespace vertex::application
@@ -0,0 +1,70 @@
+#include "vertex/application/io_thread_pool.hpp"
+
+#include <cassert>
+
+namespace vertex::application
+{
+    IoThreadPool::IoThreadPool(std::size_t thread_count)
+    {
+        assert(thread_count > 0);
+
+        threads_.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads_.emplace_back([this]
+                                  { run(); });
+        }
+    }
+
+    IoThreadPool::~IoThreadPool()
+    {
+        stop();
+        for (auto &thread : threads_)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    void IoThreadPool::post(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard lock(mu_);
+            // Resumptions are accepted during shutdown so in-flight sessions can
+            // finish; they are drained before the pool threads exit.
+            ready_.push(handle);
+        }
+        cv_.notify_one();
+    }
+
+    void IoThreadPool::stop()
+    {
+        {
+            std::lock_guard lock(mu_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void IoThreadPool::run()
+    {
+        while (true)
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock lock(mu_);
+                cv_.wait(lock, [this]
+                         { return stopping_ || !ready_.empty(); });
+
+                if (stopping_ && ready_.empty())
+                    return;
+
+                handle = ready_.front();
+                ready_.pop();
+            }
+
+            handle.resume();
+        }
+    }
+
+} // namespace vertex::application
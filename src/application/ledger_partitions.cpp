@@ -0,0 +1,78 @@
+#include "vertex/application/ledger_partitions.hpp"
+
+#include <cassert>
+
+namespace vertex::application
+{
+    LedgerPartitions::LedgerPartitions(std::size_t partition_count)
+    {
+        assert(partition_count > 0);
+
+        partitions_.reserve(partition_count);
+        for (std::size_t i = 0; i < partition_count; ++i)
+            partitions_.push_back(std::make_unique<Partition>());
+
+        for (auto &partition : partitions_)
+        {
+            partition->thread = std::thread([this, &partition = *partition]
+                                            { run(partition); });
+        }
+    }
+
+    LedgerPartitions::~LedgerPartitions()
+    {
+        for (auto &partition : partitions_)
+        {
+            {
+                std::lock_guard lock(partition->mu);
+                partition->stopping = true;
+            }
+            partition->cv.notify_one();
+        }
+
+        for (auto &partition : partitions_)
+        {
+            if (partition->thread.joinable())
+                partition->thread.join();
+        }
+    }
+
+    void LedgerPartitions::post(std::size_t partition, Job job)
+    {
+        assert(partition < partitions_.size() && "Invariant violated: ledger partition out of range");
+
+        Partition &target = *partitions_[partition];
+        {
+            std::lock_guard lock(target.mu);
+            target.jobs.push(std::move(job));
+        }
+        target.cv.notify_one();
+    }
+
+    bool LedgerPartitions::on_partition_thread(std::size_t partition) const noexcept
+    {
+        return partitions_[partition]->thread.get_id() == std::this_thread::get_id();
+    }
+
+    void LedgerPartitions::run(Partition &partition)
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(partition.mu);
+                partition.cv.wait(lock, [&partition]
+                                  { return partition.stopping || !partition.jobs.empty(); });
+
+                if (partition.stopping && partition.jobs.empty())
+                    return;
+
+                job = std::move(partition.jobs.front());
+                partition.jobs.pop();
+            }
+
+            job();
+        }
+    }
+
+} // namespace vertex::application
@@ -1,5 +1,7 @@
 #include "vertex/application/order_meta_store.hpp"
 
+#include "vertex/core/notional.hpp"
+
 namespace vertex::application
 {
     std::size_t OrderMetaStore::shard_index(OrderId id) const
@@ -36,7 +38,7 @@ namespace vertex::application
         {
             std::lock_guard lock(shard.mu_);
             auto meta = shard.data.find(id);
-            if (meta == shard.data.end())
+            if (meta == shard.data.end() || meta->second.closed)
                 return std::nullopt;
             return meta->second;
         }
@@ -56,19 +58,29 @@ namespace vertex::application
         }
     }
 
-    std::optional<OrderRecord> OrderMetaStore::close_and_extract(OrderId id, OrderStatus status)
+    std::optional<OrderRecord> OrderMetaStore::close_and_extract(OrderId id, OrderStatus status, const Market &market)
     {
         Shard &shard = shard_for(id);
 
         std::unique_lock lock(shard.mu_);
 
         auto meta = shard.data.find(id);
-        if (meta == shard.data.end())
+        if (meta == shard.data.end() || meta->second.closed)
             return std::nullopt;
 
         OrderMeta order = std::move(meta->second);
 
-        shard.data.erase(meta);
+        // A fill matched before the close may not have drawn its share yet;
+        // keep the funds reachable until it has.
+        if (order.reservation.remaining == 0)
+        {
+            shard.data.erase(meta);
+        }
+        else
+        {
+            meta->second.reservation = order.reservation;
+            meta->second.closed = true;
+        }
 
         lock.unlock();
 
@@ -80,7 +92,7 @@ namespace vertex::application
 
         return OrderRecord{.id = id,
                            .user_id = order.owner,
-                           .market = order.market,
+                           .market = market,
                            .side = order.side,
                            .type = OrderType::LimitOrder,
                            .status = status,
@@ -102,18 +114,45 @@ namespace vertex::application
 
             auto it = shard.data.find(id);
 
-            if (it == shard.data.end())
+            if (it == shard.data.end() || it->second.closed)
             {
                 return false;
             }
 
             OrderMeta &meta = it->second;
             meta.executed_base_qty += qty;
-            meta.executed_quote_qty += qty * price;
+            meta.executed_quote_qty += vertex::core::notional(price, qty);
             meta.fill_count += 1;
             meta.trade_ids.push_back(trade_id);
 
             return true;
         }
     }
-}
\ No newline at end of file
+
+    std::optional<Reservation> OrderMetaStore::draw_reservation(OrderId id, Quantity amount)
+    {
+        Shard &shard = shard_for(id);
+
+        std::lock_guard lock(shard.mu_);
+        auto it = shard.data.find(id);
+        if (it == shard.data.end())
+            return std::nullopt;
+
+        Reservation drawn = it->second.reservation.split(amount);
+        if (it->second.closed && it->second.reservation.remaining == 0)
+            shard.data.erase(it);
+        return drawn;
+    }
+
+    std::optional<Quantity> OrderMetaStore::reserved_remaining(OrderId id) const
+    {
+        const Shard &shard = shard_for(id);
+
+        std::lock_guard lock(shard.mu_);
+        auto it = shard.data.find(id);
+        if (it == shard.data.end())
+            return std::nullopt;
+
+        return it->second.reservation.remaining;
+    }
+}
@@ -0,0 +1,222 @@
+#include "vertex/domain/atomic_wallet.hpp"
+
+#include <cassert>
+#include <mutex>
+
+#include "vertex/core/notional.hpp"
+
+namespace vertex::domain
+{
+    namespace
+    {
+        // Subtracts amount unless that would take the counter below zero.
+        bool try_debit(std::atomic<Quantity> &counter, const Quantity amount) noexcept
+        {
+            Quantity current = counter.load(std::memory_order_relaxed);
+            while (amount <= current)
+            {
+                if (counter.compare_exchange_weak(current, current - amount, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    return true;
+            }
+            return false;
+        }
+    } // namespace
+
+    AtomicBalance *AtomicWallet::find(const Asset &asset) noexcept
+    {
+        const std::uint64_t id = asset.id().get_value();
+        for (std::size_t probe = 0; probe < kInlineAssets; ++probe)
+        {
+            InlineSlot &slot = inline_slots_[(id + probe) % kInlineAssets];
+            const std::uint64_t owner = slot.asset.load(std::memory_order_acquire);
+            if (owner == id)
+                return &slot.balance;
+            if (owner == 0)
+                return nullptr;
+        }
+
+        // Slots are heap-allocated and never erased, so the pointer outlives the lock
+        std::shared_lock lock(spilled_mu_);
+        auto it_asset = spilled_balances_.find(asset.id());
+        return it_asset != spilled_balances_.end() ? it_asset->second.get() : nullptr;
+    }
+
+    const AtomicBalance *AtomicWallet::find(const Asset &asset) const noexcept
+    {
+        return const_cast<AtomicWallet *>(this)->find(asset);
+    }
+
+    AtomicBalance &AtomicWallet::find_or_create(const Asset &asset)
+    {
+        const std::uint64_t id = asset.id().get_value();
+        for (std::size_t probe = 0; probe < kInlineAssets; ++probe)
+        {
+            InlineSlot &slot = inline_slots_[(id + probe) % kInlineAssets];
+            std::uint64_t owner = 0;
+            // On failure owner is the id that won the slot, possibly this one
+            if (slot.asset.compare_exchange_strong(owner, id, std::memory_order_acq_rel, std::memory_order_acquire) || owner == id)
+                return slot.balance;
+        }
+
+        if (AtomicBalance *balance = find(asset))
+            return *balance;
+
+        std::lock_guard lock(spilled_mu_);
+        auto &slot = spilled_balances_[asset.id()];
+        if (slot == nullptr)
+            slot = std::make_unique<AtomicBalance>();
+        return *slot;
+    }
+
+    std::expected<void, WalletError> AtomicWallet::deposit(const Asset &asset, const Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance &balance = find_or_create(asset);
+
+        // Bound the total before crediting free, so free + reserved never outruns it
+        Quantity current = balance.held.load(std::memory_order_relaxed);
+        do
+        {
+            if (!vertex::core::checked_add(current, amount))
+                return std::unexpected(WalletError::BalanceOverflow);
+        } while (!balance.held.compare_exchange_weak(current, current + amount, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        balance.free.fetch_add(amount, std::memory_order_acq_rel);
+
+        return {};
+    }
+
+    std::expected<void, WalletError> AtomicWallet::withdraw(const Asset &asset, const Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance *balance = find(asset);
+
+        // Asset missing or not enough free balance
+        if (balance == nullptr || !try_debit(balance->free, amount))
+            return std::unexpected(WalletError::InsufficientFunds);
+
+        balance->held.fetch_sub(amount, std::memory_order_acq_rel);
+
+        return {};
+    }
+
+    std::expected<Reservation, WalletError> AtomicWallet::reserve(const Asset &asset, const Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance *balance = find(asset);
+
+        // Asset missing or not enough free balance
+        if (balance == nullptr || !try_debit(balance->free, amount))
+            return std::unexpected(WalletError::InsufficientFunds);
+
+        balance->reserved.fetch_add(amount, std::memory_order_acq_rel);
+
+        return Reservation{balance, amount};
+    }
+
+    std::expected<void, WalletError> AtomicWallet::release(const Asset &asset, const Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance *balance = find(asset);
+
+        // Asset missing or not enough reserved balance
+        if (balance == nullptr || !try_debit(balance->reserved, amount))
+            return std::unexpected(WalletError::InsufficientReserved);
+
+        balance->free.fetch_add(amount, std::memory_order_acq_rel);
+
+        return {};
+    }
+
+    std::expected<void, WalletError> AtomicWallet::consume_reserved(const Asset &asset, Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance *balance = find(asset);
+
+        // Asset missing or not enough reserved balance
+        if (balance == nullptr || !try_debit(balance->reserved, amount))
+            return std::unexpected(WalletError::InsufficientReserved);
+
+        balance->held.fetch_sub(amount, std::memory_order_acq_rel);
+
+        return {};
+    }
+
+    std::expected<void, WalletError> AtomicWallet::release(Reservation &reservation, const Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance **slot = std::get_if<AtomicBalance *>(&reservation.slot);
+        assert(slot != nullptr && "Invariant violated: reservation was not issued by an AtomicWallet");
+        AtomicBalance *balance = *slot;
+
+        // More than this handle holds, or the slot was drained by asset
+        if (reservation.remaining < amount || !try_debit(balance->reserved, amount))
+            return std::unexpected(WalletError::InsufficientReserved);
+
+        balance->free.fetch_add(amount, std::memory_order_acq_rel);
+        reservation.remaining -= amount;
+
+        return {};
+    }
+
+    std::expected<void, WalletError> AtomicWallet::consume_reserved(Reservation &reservation, Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        AtomicBalance **slot = std::get_if<AtomicBalance *>(&reservation.slot);
+        assert(slot != nullptr && "Invariant violated: reservation was not issued by an AtomicWallet");
+        AtomicBalance *balance = *slot;
+
+        // More than this handle holds, or the slot was drained by asset
+        if (reservation.remaining < amount || !try_debit(balance->reserved, amount))
+            return std::unexpected(WalletError::InsufficientReserved);
+
+        balance->held.fetch_sub(amount, std::memory_order_acq_rel);
+        reservation.remaining -= amount;
+
+        return {};
+    }
+
+    Quantity AtomicWallet::free_balance(const Asset &asset) const
+    {
+        const AtomicBalance *balance = find(asset);
+
+        // asset not exist in wallet balance return 0;
+        if (balance == nullptr)
+            return 0;
+
+        return balance->free.load(std::memory_order_acquire);
+    }
+
+    Quantity AtomicWallet::reserved_balance(const Asset &asset) const
+    {
+        const AtomicBalance *balance = find(asset);
+
+        // asset not exist in wallet balance return 0;
+        if (balance == nullptr)
+            return 0;
+
+        return balance->reserved.load(std::memory_order_acquire);
+    }
+
+} // namespace vertex::domain
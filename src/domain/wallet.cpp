@@ -1,26 +1,62 @@
 #include "vertex/domain/wallet.hpp"
 
+#include <cassert>
+
+#include "vertex/core/notional.hpp"
+
 namespace vertex::domain
 {
+    Balance *Wallet::find(const Asset &asset) noexcept
+    {
+        const std::size_t start = asset.id().get_value() % kInlineAssets;
+        for (std::size_t probe = 0; probe < kInlineAssets; ++probe)
+        {
+            InlineSlot &slot = inline_slots_[(start + probe) % kInlineAssets];
+            if (slot.asset == asset.id())
+                return &slot.balance;
+            if (!slot.asset.is_valid())
+                return nullptr;
+        }
+
+        // Inline slots are all taken; only then can the asset have spilled
+        auto it_asset = spilled_balances_.find(asset.id());
+        return it_asset != spilled_balances_.end() ? &it_asset->second : nullptr;
+    }
+
+    const Balance *Wallet::find(const Asset &asset) const noexcept
+    {
+        return const_cast<Wallet *>(this)->find(asset);
+    }
+
+    Balance &Wallet::find_or_create(const Asset &asset)
+    {
+        const std::size_t start = asset.id().get_value() % kInlineAssets;
+        for (std::size_t probe = 0; probe < kInlineAssets; ++probe)
+        {
+            InlineSlot &slot = inline_slots_[(start + probe) % kInlineAssets];
+            if (!slot.asset.is_valid())
+                slot.asset = asset.id();
+            if (slot.asset == asset.id())
+                return slot.balance;
+        }
+
+        return spilled_balances_[asset.id()];
+    }
+
     std::expected<void, WalletError> Wallet::deposit(const Asset &asset, const Quantity amount)
     {
         // Invalid amount
         if (amount <= 0)
             return std::unexpected(WalletError::InvalidAmount);
 
-        auto it_asset = balances_.find(asset);
+        // Inline slot, or spilled entry, claimed on first deposit
+        Balance &balance = find_or_create(asset);
 
-        // Asset found in wallet balances
-        if (it_asset != balances_.end())
-        {
-            it_asset->second.free += amount;
-        }
-        // Asset not fount in wallet balances, create it
-        else
-        {
+        // Keep free + reserved in range so later release/consume cannot wrap
+        if (!vertex::core::checked_add(balance.free + balance.reserved, amount))
+            return std::unexpected(WalletError::BalanceOverflow);
 
-            balances_.emplace(asset, Balance{amount, 0});
-        }
+        balance.free += amount;
 
         return {};
     }
@@ -31,41 +67,41 @@ namespace vertex::domain
         if (amount <= 0)
             return std::unexpected(WalletError::InvalidAmount);
 
-        auto it_asset = balances_.find(asset);
+        Balance *balance = find(asset);
 
         // Asset not exists in wallet
-        if (it_asset == balances_.end())
+        if (balance == nullptr)
             return std::unexpected(WalletError::InsufficientFunds);
 
         // Not enought free balance quantity of asset to withdraw in wallet
-        if (it_asset->second.free < amount)
+        if (balance->free < amount)
             return std::unexpected(WalletError::InsufficientFunds);
 
-        it_asset->second.free -= amount;
+        balance->free -= amount;
 
         return {};
     }
 
-    std::expected<void, WalletError> Wallet::reserve(const Asset &asset, const Quantity amount)
+    std::expected<Reservation, WalletError> Wallet::reserve(const Asset &asset, const Quantity amount)
     {
         // Invalid amount
         if (amount <= 0)
             return std::unexpected(WalletError::InvalidAmount);
 
-        auto it_asset = balances_.find(asset);
+        Balance *balance = find(asset);
 
         // Asset not exists in wallet
-        if (it_asset == balances_.end())
+        if (balance == nullptr)
             return std::unexpected(WalletError::InsufficientFunds);
 
         // Not enought free balance of asset to reserve in wallet
-        if (it_asset->second.free < amount)
+        if (balance->free < amount)
             return std::unexpected(WalletError::InsufficientFunds);
 
-        it_asset->second.free -= amount;
-        it_asset->second.reserved += amount;
+        balance->free -= amount;
+        balance->reserved += amount;
 
-        return {};
+        return Reservation{balance, amount};
     }
 
     std::expected<void, WalletError> Wallet::release(const Asset &asset, const Quantity amount)
@@ -74,18 +110,18 @@ namespace vertex::domain
         if (amount <= 0)
             return std::unexpected(WalletError::InvalidAmount);
 
-        auto it_asset = balances_.find(asset);
+        Balance *balance = find(asset);
 
         // Asset not exists in wallet
-        if (it_asset == balances_.end())
+        if (balance == nullptr)
             return std::unexpected(WalletError::InsufficientReserved);
 
         // Not enought reserve balance of asset to release in wallet
-        if (it_asset->second.reserved < amount)
+        if (balance->reserved < amount)
             return std::unexpected(WalletError::InsufficientReserved);
 
-        it_asset->second.reserved -= amount;
-        it_asset->second.free += amount;
+        balance->reserved -= amount;
+        balance->free += amount;
 
         return {};
     }
@@ -95,42 +131,82 @@ namespace vertex::domain
         if (amount <= 0)
             return std::unexpected(WalletError::InvalidAmount);
 
-        auto it_asset = balances_.find(asset);
+        Balance *balance = find(asset);
 
         // Asset not exists in wallet
-        if (it_asset == balances_.end())
+        if (balance == nullptr)
             return std::unexpected(WalletError::InsufficientReserved);
 
         // Not enought reserve balance of asset to release in wallet
-        if (it_asset->second.reserved < amount)
+        if (balance->reserved < amount)
             return std::unexpected(WalletError::InsufficientReserved);
 
-        it_asset->second.reserved -= amount;
+        balance->reserved -= amount;
 
         return {};
     }
 
-    Quantity Wallet::free_balance(const Asset &asset) const
+    std::expected<void, WalletError> Wallet::release(Reservation &reservation, const Quantity amount)
     {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        Balance **slot = std::get_if<Balance *>(&reservation.slot);
+        assert(slot != nullptr && "Invariant violated: reservation was not issued by a Wallet");
+        Balance *balance = *slot;
+
+        // More than this handle holds, or the slot was drained by asset
+        if (reservation.remaining < amount || balance->reserved < amount)
+            return std::unexpected(WalletError::InsufficientReserved);
+
+        balance->reserved -= amount;
+        balance->free += amount;
+        reservation.remaining -= amount;
 
-        auto it_asset = balances_.find(asset);
+        return {};
+    }
+
+    std::expected<void, WalletError> Wallet::consume_reserved(Reservation &reservation, Quantity amount)
+    {
+        // Invalid amount
+        if (amount <= 0)
+            return std::unexpected(WalletError::InvalidAmount);
+
+        Balance **slot = std::get_if<Balance *>(&reservation.slot);
+        assert(slot != nullptr && "Invariant violated: reservation was not issued by a Wallet");
+        Balance *balance = *slot;
+
+        // More than this handle holds, or the slot was drained by asset
+        if (reservation.remaining < amount || balance->reserved < amount)
+            return std::unexpected(WalletError::InsufficientReserved);
+
+        balance->reserved -= amount;
+        reservation.remaining -= amount;
+
+        return {};
+    }
+
+    Quantity Wallet::free_balance(const Asset &asset) const
+    {
+        const Balance *balance = find(asset);
 
         //asset not exist in wallet balance return 0;
-        if (it_asset == balances_.end())
+        if (balance == nullptr)
             return 0;
 
-        return it_asset->second.free;
+        return balance->free;
     }
 
     Quantity Wallet::reserved_balance(const Asset &asset) const
     {
-        auto it_asset = balances_.find(asset);
+        const Balance *balance = find(asset);
 
         //asset not exist in wallet balance return 0;
-        if(it_asset == balances_.end())
+        if(balance == nullptr)
         return 0;
 
-        return it_asset->second.reserved;
+        return balance->reserved;
     }
 
 } // namespace vertex::domain
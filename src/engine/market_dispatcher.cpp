@@ -1,5 +1,8 @@
 #include "vertex/engine/market_dispatcher.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 namespace vertex::engine
 {
     template <class... Ts>
@@ -9,150 +12,314 @@ namespace vertex::engine
     };
     template <class... Ts>
     Overloaded(Ts...) -> Overloaded<Ts...>;
-    std::expected<void, EngineAsyncError> MarketDispatcher::register_market(const Market &market)
+
+    MarketDispatcher::MarketDispatcher(MarketDispatcherConfig config)
+    {
+        if (config.pool_threads > 0)
+            pool_ = std::make_unique<MarketWorkerPool>(config.pool_threads, config.pool_batch_size, config.pool_steal_threshold);
+    }
+
+    std::expected<MarketId, EngineAsyncError> MarketDispatcher::register_market(const Market &market, MarketWorkerConfig config)
+    {
+        return register_market(market, MarketSpec{}, config);
+    }
+
+    std::expected<MarketId, EngineAsyncError> MarketDispatcher::register_market(const Market &market, const MarketSpec &spec, MarketWorkerConfig config)
     {
-        bool result = false;
+        if (!spec.is_valid())
+            return std::unexpected(EngineAsyncError::InvalidMarketSpec);
+
+        std::lock_guard lock(workers_mutex_);
+        if (stopping_.load(std::memory_order_relaxed))
         {
-            std::lock_guard lock(workers_mutex_);
-            if (stopping_)
-            {
-                return std::unexpected(EngineAsyncError::WorkerStopped);
-            }
-            result = workers_.try_emplace(market, std::make_shared<MarketWorker>(market)).second;
+            return std::unexpected(EngineAsyncError::WorkerStopped);
         }
-
-        if (!result)
+        // Checked first so a duplicate does not spin up (and tear down) a worker.
+        if (routes_.find(market).is_valid())
             return std::unexpected(EngineAsyncError::MarketAlreadyRegistered);
+        if (markets_.size() >= decltype(markets_)::kCapacity)
+            return std::unexpected(EngineAsyncError::CapacityExhausted);
+
+        auto worker = pool_ ? std::make_unique<MarketWorker>(market, spec, config, *pool_, &trade_ids_)
+                            : std::make_unique<MarketWorker>(market, spec, config, &trade_ids_);
+        const auto index = markets_.emplace_back(MarketSlot{market, spec, std::move(worker)});
+        if (!index)
+            return std::unexpected(EngineAsyncError::CapacityExhausted);
+
+        const MarketId market_id{*index + 1};
+        routes_.insert(market, market_id);
 
-        return {};
+        return market_id;
     }
 
     bool MarketDispatcher::has_market(const Market &market) const noexcept
     {
-        std::shared_lock lock(workers_mutex_);
+        return routes_.find(market).is_valid();
+    }
+
+    bool MarketDispatcher::has_market(MarketId market_id) const noexcept
+    {
+        return find_market(market_id) != nullptr;
+    }
+
+    std::optional<MarketId> MarketDispatcher::find_market_id(const Market &market) const noexcept
+    {
+        const MarketId market_id = routes_.find(market);
+        if (!market_id.is_valid())
+            return std::nullopt;
+
+        return market_id;
+    }
+
+    const Market *MarketDispatcher::find_market(MarketId market_id) const noexcept
+    {
+        if (!market_id.is_valid())
+            return nullptr;
+
+        const MarketSlot *slot = markets_.find(market_id.get_value() - 1);
+        return slot != nullptr ? &slot->market : nullptr;
+    }
+
+    const MarketSpec *MarketDispatcher::find_market_spec(MarketId market_id) const noexcept
+    {
+        if (!market_id.is_valid())
+            return nullptr;
+
+        const MarketSlot *slot = markets_.find(market_id.get_value() - 1);
+        return slot != nullptr ? &slot->spec : nullptr;
+    }
+
+    bool MarketDispatcher::has_settlement_stage(MarketId market_id) const noexcept
+    {
+        if (!market_id.is_valid())
+            return false;
 
-        return workers_.find(market) != workers_.end();
+        const MarketSlot *slot = markets_.find(market_id.get_value() - 1);
+        return slot != nullptr && slot->worker->has_settlement_stage();
+    }
+
+    bool MarketDispatcher::has_sub_ledger(MarketId market_id) const noexcept
+    {
+        if (!market_id.is_valid())
+            return false;
+
+        const MarketSlot *slot = markets_.find(market_id.get_value() - 1);
+        return slot != nullptr && slot->worker->has_sub_ledger();
+    }
+
+    std::optional<MarketWorkerPoolStats> MarketDispatcher::pool_stats() const
+    {
+        if (!pool_)
+            return std::nullopt;
+
+        return pool_->stats();
     }
 
     std::future<std::expected<std::vector<Execution>, EngineAsyncError>> MarketDispatcher::submit(OrderRequest &&order_request)
     {
+        std::promise<SubmitResult> p;
+        auto f = p.get_future();
+        submit(std::move(order_request), complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<SubmitBatchResult> MarketDispatcher::submit_batch(MarketId market_id, std::vector<OrderRequest> &&order_requests)
+    {
+        std::promise<SubmitBatchResult> p;
+        auto f = p.get_future();
+        submit_batch(market_id, std::move(order_requests), complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<std::expected<std::optional<CancelResult>, EngineAsyncError>> MarketDispatcher::cancel(MarketId market_id, OrderId order_id)
+    {
+        std::promise<CancelResultEx> p;
+        auto f = p.get_future();
+        cancel(market_id, order_id, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<std::expected<std::optional<CancelResult>, EngineAsyncError>> MarketDispatcher::cancel(const Market &market, OrderId order_id)
+    {
+        std::promise<CancelResultEx> p;
+        auto f = p.get_future();
+        cancel(market, order_id, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<std::expected<std::optional<Price>, EngineAsyncError>> MarketDispatcher::best_bid(const Market &market)
+    {
+        std::promise<PriceResult> p;
+        auto f = p.get_future();
+        best_bid(market, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<std::expected<std::optional<Price>, EngineAsyncError>> MarketDispatcher::best_ask(const Market &market)
+    {
+        std::promise<PriceResult> p;
+        auto f = p.get_future();
+        best_ask(market, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<LedgerResult> MarketDispatcher::transfer(MarketId market_id, UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction)
+    {
+        std::promise<LedgerResult> p;
+        auto f = p.get_future();
+        transfer(market_id, user_id, asset, amount, direction, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<LedgerBalanceResult> MarketDispatcher::ledger_balance(MarketId market_id, UserId user_id)
+    {
+        std::promise<LedgerBalanceResult> p;
+        auto f = p.get_future();
+        ledger_balance(market_id, user_id, complete_promise(std::move(p)));
+        return f;
+    }
 
-        std::shared_ptr<MarketWorker> worker;
-        Market market = market_of(order_request);
+    void MarketDispatcher::submit(OrderRequest &&order_request, SubmitCompletion on_done)
+    {
+        auto worker = find_worker(market_of(order_request));
+        if (!worker)
         {
-            std::shared_lock lock(workers_mutex_);
-            if (stopping_)
-                return make_ready_future_error<std::vector<Execution>>(EngineAsyncError::WorkerStopped);
-            auto worker_it = workers_.find(market);
-
-            if (worker_it == workers_.end())
-            {
-                return make_ready_future_error<std::vector<Execution>>(EngineAsyncError::MarketNotFound);
-            }
-            worker = worker_it->second;
+            on_done(std::unexpected(worker.error()));
+            return;
         }
-        return worker->submit(std::move(order_request));
+
+        (*worker)->submit(std::move(order_request), std::move(on_done));
     }
 
-    std::future<std::expected<std::optional<CancelResult>, EngineAsyncError>> MarketDispatcher::cancel(const Market &market, OrderId order_id)
+    void MarketDispatcher::submit_batch(MarketId market_id, std::vector<OrderRequest> &&order_requests, SubmitBatchCompletion on_done)
     {
+        assert(std::ranges::all_of(order_requests,
+                                   [market_id](const OrderRequest &request)
+                                   { return market_of(request) == market_id; }) &&
+               "Invariant violated: batched request routed to another market");
 
-        std::shared_ptr<MarketWorker> worker;
+        auto worker = find_worker(market_id);
+        if (!worker)
         {
-            std::shared_lock lock(workers_mutex_);
-            if (stopping_)
-                return make_ready_future_error<std::optional<CancelResult>>(EngineAsyncError::WorkerStopped);
-            auto worker_it = workers_.find(market);
-
-            if (worker_it == workers_.end())
-            {
-                return make_ready_future_error<std::optional<CancelResult>>(EngineAsyncError::MarketNotFound);
-            }
-            worker = worker_it->second;
+            on_done(SubmitBatchResult(order_requests.size(), SubmitResult{std::unexpected(worker.error())}));
+            return;
         }
 
-        return worker->cancel(order_id);
+        (*worker)->submit_batch(std::move(order_requests), std::move(on_done));
     }
 
-    std::future<std::expected<std::optional<Price>, EngineAsyncError>> MarketDispatcher::best_bid(const Market &market)
+    void MarketDispatcher::cancel(MarketId market_id, OrderId order_id, CancelCompletion on_done)
     {
-        std::shared_ptr<MarketWorker> worker;
+        auto worker = find_worker(market_id);
+        if (!worker)
         {
-            std::shared_lock lock(workers_mutex_);
-            if (stopping_)
-                return make_ready_future_error<std::optional<Price>>(EngineAsyncError::WorkerStopped);
-            auto worker_it = workers_.find(market);
-
-            if (worker_it == workers_.end())
-            {
-                return make_ready_future_error<std::optional<Price>>(EngineAsyncError::MarketNotFound);
-            }
-            worker = worker_it->second;
+            on_done(std::unexpected(worker.error()));
+            return;
         }
 
-        return worker->best_bid();
+        (*worker)->cancel(order_id, std::move(on_done));
     }
 
-    std::future<std::expected<std::optional<Price>, EngineAsyncError>> MarketDispatcher::best_ask(const Market &market)
+    void MarketDispatcher::cancel(const Market &market, OrderId order_id, CancelCompletion on_done)
     {
-        std::shared_ptr<MarketWorker> worker;
+        auto worker = find_worker(market);
+        if (!worker)
         {
-            std::shared_lock lock(workers_mutex_);
-            if (stopping_)
-                return make_ready_future_error<std::optional<Price>>(EngineAsyncError::WorkerStopped);
-            auto worker_it = workers_.find(market);
-
-            if (worker_it == workers_.end())
-            {
-                return make_ready_future_error<std::optional<Price>>(EngineAsyncError::MarketNotFound);
-            }
-            worker = worker_it->second;
+            on_done(std::unexpected(worker.error()));
+            return;
         }
 
-        return worker->best_ask();
+        (*worker)->cancel(order_id, std::move(on_done));
     }
 
-    MarketDispatcher::~MarketDispatcher()
+    void MarketDispatcher::best_bid(const Market &market, PriceCompletion on_done)
     {
-        stop_all();
+        auto worker = find_worker(market);
+        if (!worker)
+        {
+            on_done(std::unexpected(worker.error()));
+            return;
+        }
+
+        (*worker)->best_bid(std::move(on_done));
     }
 
-    void MarketDispatcher::stop_all()
+    void MarketDispatcher::best_ask(const Market &market, PriceCompletion on_done)
     {
-        std::vector<std::shared_ptr<MarketWorker>> workers;
+        auto worker = find_worker(market);
+        if (!worker)
+        {
+            on_done(std::unexpected(worker.error()));
+            return;
+        }
+
+        (*worker)->best_ask(std::move(on_done));
+    }
 
+    void MarketDispatcher::transfer(MarketId market_id, UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction, LedgerCompletion on_done)
+    {
+        auto worker = find_worker(market_id);
+        if (!worker)
         {
-            std::lock_guard lock(workers_mutex_);
-            stopping_ = true;
-            workers.reserve(workers_.size());
-
-            for (auto &worker : workers_)
-            {
-                workers.push_back(worker.second);
-            }
+            on_done(std::unexpected(worker.error()));
+            return;
         }
 
-        for (auto &worker : workers)
+        (*worker)->transfer(user_id, asset, amount, direction, std::move(on_done));
+    }
+
+    void MarketDispatcher::ledger_balance(MarketId market_id, UserId user_id, LedgerBalanceCompletion on_done)
+    {
+        auto worker = find_worker(market_id);
+        if (!worker)
         {
-            worker->stop();
+            on_done(std::unexpected(worker.error()));
+            return;
         }
+
+        (*worker)->ledger_balance(user_id, std::move(on_done));
     }
 
-    Market MarketDispatcher::market_of(const OrderRequest &order_request)
+    MarketDispatcher::~MarketDispatcher()
+    {
+        stop_all();
+    }
+
+    void MarketDispatcher::stop_all()
+    {
+        std::lock_guard lock(workers_mutex_);
+        stopping_.store(true, std::memory_order_release);
+
+        const std::size_t count = markets_.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            markets_.find(i)->worker->stop();
+        }
+    }
+
+    MarketId MarketDispatcher::market_of(const OrderRequest &order_request) noexcept
     {
         return std::visit(
-            [](const auto &req) -> const Market &
+            [](const auto &req)
             { return req.market; },
             order_request);
     }
 
-    template <typename T>
-    std::future<std::expected<T, EngineAsyncError>> MarketDispatcher::make_ready_future_error(EngineAsyncError error)
+    std::expected<MarketWorker *, EngineAsyncError> MarketDispatcher::find_worker(MarketId market_id) const noexcept
     {
-        std::promise<std::expected<T, EngineAsyncError>> p;
-        auto f = p.get_future();
-        p.set_value(std::unexpected(error));
-        return f;
+        if (stopping_.load(std::memory_order_acquire))
+            return std::unexpected(EngineAsyncError::WorkerStopped);
+
+        const MarketSlot *slot = market_id.is_valid() ? markets_.find(market_id.get_value() - 1) : nullptr;
+        if (slot == nullptr)
+            return std::unexpected(EngineAsyncError::MarketNotFound);
+
+        return slot->worker.get();
+    }
+
+    std::expected<MarketWorker *, EngineAsyncError> MarketDispatcher::find_worker(const Market &market) const noexcept
+    {
+        return find_worker(routes_.find(market));
     }
 
 }
\ No newline at end of file
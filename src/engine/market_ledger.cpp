@@ -0,0 +1,141 @@
+#include "vertex/engine/market_ledger.hpp"
+
+#include <cassert>
+#include "vertex/core/notional.hpp"
+
+namespace vertex::engine
+{
+    namespace
+    {
+        Quantity &free_of(SubLedgerBalance &balance, LedgerAsset asset) noexcept
+        {
+            return asset == LedgerAsset::Base ? balance.base_free : balance.quote_free;
+        }
+
+        Quantity &reserved_of(SubLedgerBalance &balance, LedgerAsset asset) noexcept
+        {
+            return asset == LedgerAsset::Base ? balance.base_reserved : balance.quote_reserved;
+        }
+
+        // Same rule as Wallet::deposit: keep free + reserved in range, so a
+        // later release or surplus return (which only moves reserved funds
+        // back to free) cannot overflow.
+        bool can_credit(SubLedgerBalance &balance, LedgerAsset asset, Quantity amount) noexcept
+        {
+            return vertex::core::checked_add(free_of(balance, asset) + reserved_of(balance, asset), amount).has_value();
+        }
+
+        void consume_reserved(SubLedgerBalance &balance, LedgerAsset asset, Quantity amount)
+        {
+            Quantity &reserved = reserved_of(balance, asset);
+            assert(amount <= reserved && "Invariant violated: sub-ledger debit exceeds reservation");
+            reserved -= amount;
+        }
+    } // namespace
+
+    std::expected<void, EngineAsyncError> MarketLedger::transfer(UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction)
+    {
+        assert(amount > 0 && "Invariant violated: sub-ledger transfer of a non-positive amount");
+
+        Quantity &total = total_of(asset);
+        switch (direction)
+        {
+        case LedgerTransfer::Credit:
+        {
+            // The user's free + reserved is part of the total, so it fits too.
+            const auto raised = vertex::core::checked_add(total, amount);
+            if (!raised)
+                return std::unexpected(EngineAsyncError::BalanceOverflow);
+            total = *raised;
+            free_of(balances_[user_id], asset) += amount;
+            return {};
+        }
+        case LedgerTransfer::Debit:
+        {
+            auto it = balances_.find(user_id);
+            if (it == balances_.end() || free_of(it->second, asset) < amount)
+                return std::unexpected(EngineAsyncError::InsufficientFunds);
+            free_of(it->second, asset) -= amount;
+            total -= amount;
+            return {};
+        }
+        case LedgerTransfer::Hold:
+            if (!reserve(user_id, asset, amount))
+                return std::unexpected(EngineAsyncError::InsufficientFunds);
+            return {};
+        case LedgerTransfer::DebitHeld:
+            consume_reserved(balances_[user_id], asset, amount);
+            total -= amount;
+            return {};
+        case LedgerTransfer::ReleaseHold:
+            release(user_id, asset, amount);
+            return {};
+        }
+
+        assert(false && "Unexpected LedgerTransfer direction");
+        return std::unexpected(EngineAsyncError::InsufficientFunds);
+    }
+
+    Quantity &MarketLedger::total_of(LedgerAsset asset) noexcept
+    {
+        return asset == LedgerAsset::Base ? base_total_ : quote_total_;
+    }
+
+    SubLedgerBalance MarketLedger::balance(UserId user_id) const
+    {
+        auto it = balances_.find(user_id);
+        return it != balances_.end() ? it->second : SubLedgerBalance{};
+    }
+
+    bool MarketLedger::reserve(UserId user_id, LedgerAsset asset, Quantity amount)
+    {
+        if (amount <= 0)
+            return false;
+
+        auto it = balances_.find(user_id);
+        if (it == balances_.end() || free_of(it->second, asset) < amount)
+            return false;
+
+        free_of(it->second, asset) -= amount;
+        reserved_of(it->second, asset) += amount;
+        return true;
+    }
+
+    void MarketLedger::release(UserId user_id, LedgerAsset asset, Quantity amount)
+    {
+        SubLedgerBalance &balance = balances_[user_id];
+        Quantity &reserved = reserved_of(balance, asset);
+        assert(amount <= reserved && "Invariant violated: sub-ledger release exceeds reservation");
+        reserved -= amount;
+        free_of(balance, asset) += amount;
+    }
+
+    bool MarketLedger::settle(const Execution &execution)
+    {
+        const Quantity quote_quantity = vertex::core::notional(execution.execution_price, execution.quantity);
+        const Quantity buyer_draw = vertex::core::notional(execution.buy_order_limit_price.value_or(execution.execution_price), execution.quantity);
+
+        // Map nodes are stable, so both references survive the second insert.
+        SubLedgerBalance &buyer = balances_[execution.buy_owner];
+        SubLedgerBalance &seller = balances_[execution.sell_owner];
+
+        // Unreachable while the ledger totals fit (see transfer). The matched
+        // quantity is off the book already, so its funds must not stay
+        // reserved where nothing can release them.
+        if (!can_credit(buyer, LedgerAsset::Base, execution.quantity) ||
+            !can_credit(seller, LedgerAsset::Quote, quote_quantity))
+        {
+            release(execution.buy_owner, LedgerAsset::Quote, buyer_draw);
+            release(execution.sell_owner, LedgerAsset::Base, execution.quantity);
+            return false;
+        }
+
+        consume_reserved(buyer, LedgerAsset::Quote, buyer_draw);
+        buyer.quote_free += buyer_draw - quote_quantity;
+        buyer.base_free += execution.quantity;
+
+        consume_reserved(seller, LedgerAsset::Base, execution.quantity);
+        seller.quote_free += quote_quantity;
+        return true;
+    }
+} // namespace vertex::engine
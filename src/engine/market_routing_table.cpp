@@ -0,0 +1,85 @@
+#include "vertex/engine/market_routing_table.hpp"
+
+#include <functional>
+
+namespace vertex::engine
+{
+    MarketRoutingTable::Table::Table(std::size_t capacity)
+        : mask(capacity - 1), slots(std::make_unique<std::atomic<const Entry *>[]>(capacity))
+    {
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    MarketRoutingTable::MarketRoutingTable()
+    {
+        tables_.push_back(std::make_unique<Table>(kInitialCapacity));
+        table_.store(tables_.back().get(), std::memory_order_release);
+    }
+
+    vertex::core::MarketId MarketRoutingTable::find(const vertex::core::Market &market) const noexcept
+    {
+        const Table *table = table_.load(std::memory_order_acquire);
+        const std::size_t hash = std::hash<vertex::core::Market>{}(market);
+
+        for (std::size_t i = hash & table->mask;; i = (i + 1) & table->mask)
+        {
+            const Entry *entry = table->slots[i].load(std::memory_order_acquire);
+            if (entry == nullptr)
+                return {};
+
+            if (entry->hash == hash && entry->market == market)
+                return entry->id;
+        }
+    }
+
+    bool MarketRoutingTable::insert(const vertex::core::Market &market, vertex::core::MarketId id)
+    {
+        if (find(market).is_valid())
+            return false;
+
+        entries_.push_back(std::make_unique<Entry>(Entry{
+            .market = market,
+            .hash = std::hash<vertex::core::Market>{}(market),
+            .id = id,
+        }));
+        const Entry *entry = entries_.back().get();
+
+        const Table *current = table_.load(std::memory_order_relaxed);
+        const std::size_t capacity = current->mask + 1;
+
+        // Keep load factor <= 1/2 so probe sequences stay short.
+        if ((size_ + 1) * 2 > capacity)
+        {
+            auto grown = std::make_unique<Table>(capacity * 2);
+            for (const auto &existing : entries_)
+            {
+                place(*grown, existing.get());
+            }
+            tables_.push_back(std::move(grown));
+            table_.store(tables_.back().get(), std::memory_order_release);
+        }
+        else
+        {
+            place(*current, entry);
+        }
+
+        ++size_;
+        return true;
+    }
+
+    void MarketRoutingTable::place(const Table &table, const Entry *entry) noexcept
+    {
+        for (std::size_t i = entry->hash & table.mask;; i = (i + 1) & table.mask)
+        {
+            if (table.slots[i].load(std::memory_order_relaxed) == nullptr)
+            {
+                table.slots[i].store(entry, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+}
@@ -1,4 +1,5 @@
 #include "vertex/engine/market_worker.hpp"
+#include "vertex/core/notional.hpp"
 
 namespace vertex::engine
 {
@@ -11,86 +12,236 @@ namespace vertex::engine
     template <class... Ts>
     Overloaded(Ts...) -> Overloaded<Ts...>;
 
-    MarketWorker::MarketWorker(Market market) : order_book_(OrderBook{market})
+    MarketWorker::MarketWorker(Market market, MarketWorkerConfig config) : MarketWorker(market, MarketSpec{}, config)
     {
+    }
+
+    MarketWorker::MarketWorker(Market market, const MarketSpec &spec, MarketWorkerConfig config, TradeIdGenerator *trade_ids)
+        : config_(config), order_book_(OrderBook{market, spec}), trade_ids_(trade_ids != nullptr ? *trade_ids : own_trade_ids_)
+    {
+        if (config_.settlement_stage)
+        {
+            own_stage_ = std::make_unique<SettlementStage>(config_.settlement_stage_capacity);
+            stage_ = own_stage_.get();
+        }
+        if (config_.sub_ledger)
+            ledger_ = std::make_unique<MarketLedger>();
         worker_thread_ = std::thread([this]
                                      { run(); });
     }
 
+    MarketWorker::MarketWorker(Market market, MarketWorkerConfig config, MarketWorkerPool &pool)
+        : MarketWorker(market, MarketSpec{}, config, pool)
+    {
+    }
+
+    MarketWorker::MarketWorker(Market market, const MarketSpec &spec, MarketWorkerConfig config, MarketWorkerPool &pool, TradeIdGenerator *trade_ids)
+        : config_(config), order_book_(OrderBook{market, spec}), pool_(&pool), home_(pool.assign_home()),
+          trade_ids_(trade_ids != nullptr ? *trade_ids : own_trade_ids_)
+    {
+        // Keyed by the first home: stealing must not split the market's
+        // completions across two stages.
+        if (config_.settlement_stage)
+            stage_ = &pool.settlement_stage(home_.load(std::memory_order_relaxed), config_.settlement_stage_capacity);
+        if (config_.sub_ledger)
+            ledger_ = std::make_unique<MarketLedger>();
+    }
+
     MarketWorker::~MarketWorker()
     {
         stop();
+        if (pool_ != nullptr)
+        {
+            // Queued tasks are still drained by the pool; wait until it lets go of us.
+            std::unique_lock lock(queue_mutex_);
+            queue_cv_.wait(lock, [this]
+                           { return !scheduled_; });
+        }
         if (worker_thread_.joinable())
             worker_thread_.join();
+        // Runs the completions still queued on the stage. A shared stage
+        // stays with the pool; wait for this market's jobs on it instead.
+        if (own_stage_ != nullptr)
+        {
+            own_stage_.reset();
+        }
+        else if (stage_ != nullptr)
+        {
+            std::promise<void> drained;
+            auto done = drained.get_future();
+            stage_->post([&drained]
+                         { drained.set_value(); });
+            done.wait();
+        }
     }
 
     std::future<SubmitResult> MarketWorker::submit(OrderRequest request)
     {
         std::promise<SubmitResult> p;
         auto f = p.get_future();
+        submit(std::move(request), complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<SubmitBatchResult> MarketWorker::submit_batch(std::vector<OrderRequest> requests)
+    {
+        std::promise<SubmitBatchResult> p;
+        auto f = p.get_future();
+        submit_batch(std::move(requests), complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<CancelResultEx> MarketWorker::cancel(OrderId order_id)
+    {
+        std::promise<CancelResultEx> p;
+        auto f = p.get_future();
+        cancel(order_id, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<PriceResult> MarketWorker::best_bid()
+    {
+        std::promise<PriceResult> p;
+        auto f = p.get_future();
+        best_bid(complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<PriceResult> MarketWorker::best_ask()
+    {
+        std::promise<PriceResult> p;
+        auto f = p.get_future();
+        best_ask(complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<LedgerResult> MarketWorker::transfer(UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction)
+    {
+        std::promise<LedgerResult> p;
+        auto f = p.get_future();
+        transfer(user_id, asset, amount, direction, complete_promise(std::move(p)));
+        return f;
+    }
+
+    std::future<LedgerBalanceResult> MarketWorker::ledger_balance(UserId user_id)
+    {
+        std::promise<LedgerBalanceResult> p;
+        auto f = p.get_future();
+        ledger_balance(user_id, complete_promise(std::move(p)));
+        return f;
+    }
 
+    void MarketWorker::submit(OrderRequest request, SubmitCompletion on_done)
+    {
         SubmitTask task = SubmitTask{
             .request = std::move(request),
-            .done = std::move(p)};
+            .done = std::move(on_done)};
 
-        if (!try_enqueue(std::move(task)))
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
         {
-            // Safe: try_enqueue returns false only before queue push(std::move(task)),
-            // so 'task' still owns a valid promise and we can resolve it here.
-            task.done.set_value(std::unexpected(EngineAsyncError::WorkerStopped));
+            // Safe: try_enqueue fails only before queue push(std::move(task)),
+            // so 'task' still owns a valid continuation and we can resolve it here.
+            task.done(std::unexpected(enqueued.error()));
         }
+    }
 
-        return f;
+    void MarketWorker::submit_into(OrderRequest request, ExecutionBuffer &out, SubmitIntoCompletion on_done)
+    {
+        SubmitIntoTask task = SubmitIntoTask{
+            .request = std::move(request),
+            .out = &out,
+            .done = std::move(on_done)};
+
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
+        {
+            // Same as submit: the task was not queued, so the worker never saw out.
+            out.clear();
+            task.done(std::unexpected(enqueued.error()));
+        }
     }
 
-    std::future<CancelResultEx> MarketWorker::cancel(OrderId order_id)
+    void MarketWorker::submit_batch(std::vector<OrderRequest> requests, SubmitBatchCompletion on_done)
     {
-        std::promise<CancelResultEx> p;
-        auto f = p.get_future();
+        const std::size_t count = requests.size();
+        SubmitBatchTask task = SubmitBatchTask{
+            .requests = std::move(requests),
+            .done = std::move(on_done)};
+
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
+        {
+            // Same rule as submit(): on false path task was not moved into queue.
+            task.done(SubmitBatchResult(count, SubmitResult{std::unexpected(enqueued.error())}));
+        }
+    }
 
+    void MarketWorker::cancel(OrderId order_id, CancelCompletion on_done)
+    {
         CancelTask task = CancelTask{
             .order_id = order_id,
-            .done = std::move(p)};
+            .done = std::move(on_done)};
 
-        if (!try_enqueue(std::move(task)))
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
         {
             // Same rule as submit(): on false path task was not moved into queue.
-            task.done.set_value(std::unexpected(EngineAsyncError::WorkerStopped));
+            task.done(std::unexpected(enqueued.error()));
         }
-
-        return f;
     }
 
-    std::future<PriceResult> MarketWorker::best_bid()
+    void MarketWorker::best_bid(PriceCompletion on_done)
     {
-        std::promise<PriceResult> p;
-        auto f = p.get_future();
-
-        BestBidTask task = BestBidTask{.done = std::move(p)};
+        BestBidTask task = BestBidTask{.done = std::move(on_done)};
 
-        if (!try_enqueue(std::move(task)))
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
         {
-            // On enqueue failure we still own the promise in local 'task'.
-            task.done.set_value(std::unexpected(EngineAsyncError::WorkerStopped));
+            // On enqueue failure we still own the continuation in local 'task'.
+            task.done(std::unexpected(enqueued.error()));
         }
-
-        return f;
     }
 
-    std::future<PriceResult> MarketWorker::best_ask()
+    void MarketWorker::best_ask(PriceCompletion on_done)
     {
-        std::promise<PriceResult> p;
-        auto f = p.get_future();
+        BestAskTask task = BestAskTask{.done = std::move(on_done)};
 
-        BestAskTask task = BestAskTask{.done = std::move(p)};
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
+        {
+            // On enqueue failure we still own the continuation in local 'task'.
+            task.done(std::unexpected(enqueued.error()));
+        }
+    }
 
-        if (!try_enqueue(std::move(task)))
+    void MarketWorker::transfer(UserId user_id, LedgerAsset asset, Quantity amount, LedgerTransfer direction, LedgerCompletion on_done)
+    {
+        LedgerTransferTask task = LedgerTransferTask{
+            .user_id = user_id,
+            .asset = asset,
+            .amount = amount,
+            .direction = direction,
+            .done = std::move(on_done)};
+
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
         {
-            // On enqueue failure we still own the promise in local 'task'.
-            task.done.set_value(std::unexpected(EngineAsyncError::WorkerStopped));
+            // On enqueue failure we still own the continuation in local 'task'.
+            task.done(std::unexpected(enqueued.error()));
         }
+    }
 
-        return f;
+    void MarketWorker::ledger_balance(UserId user_id, LedgerBalanceCompletion on_done)
+    {
+        LedgerBalanceTask task = LedgerBalanceTask{.user_id = user_id, .done = std::move(on_done)};
+
+        auto enqueued = try_enqueue(std::move(task));
+        if (!enqueued)
+        {
+            // On enqueue failure we still own the continuation in local 'task'.
+            task.done(std::unexpected(enqueued.error()));
+        }
     }
 
     void MarketWorker::stop()
@@ -104,6 +255,7 @@ namespace vertex::engine
 
     void MarketWorker::run()
     {
+        WorkerArena arena{arena_upstream_allocations_};
 
         while (true)
         {
@@ -111,86 +263,257 @@ namespace vertex::engine
             {
                 std::unique_lock lock(queue_mutex_);
                 queue_cv_.wait(lock, [this]
-                               { return stopping_ || !task_queue_.empty(); });
+                               { return stopping_ || !task_queue_.empty() || !priority_queue_.empty(); });
 
-                if (stopping_ && task_queue_.empty())
+                if (stopping_ && task_queue_.empty() && priority_queue_.empty())
                     return;
 
-                task.emplace(std::move(task_queue_.front()));
-                task_queue_.pop();
+                task.emplace(pop_next_task());
             }
 
-            std::visit(
-                Overloaded{
-                    [this](SubmitTask &req) -> void
-                    {
-                        req.done.set_value(SubmitResult{handle_submit(req.request)});
-                    },
-                    [this](CancelTask &req) -> void
+            {
+                ExecutionBuffer scratch{arena.resource()};
+                run_task(*task, scratch);
+            }
+            arena.reset();
+        }
+    }
+
+    MarketWorker::BatchResult MarketWorker::run_batch(std::size_t max_tasks, std::pmr::memory_resource *arena)
+    {
+        // One scratch buffer per batch; clear() keeps its capacity between tasks.
+        ExecutionBuffer scratch{arena};
+        BatchResult result;
+        for (; result.tasks_run < max_tasks; ++result.tasks_run)
+        {
+            std::optional<MarketTask> task;
+            {
+                std::lock_guard lock(queue_mutex_);
+                if (task_queue_.empty() && priority_queue_.empty())
+                    break;
+
+                task.emplace(pop_next_task());
+            }
+
+            run_task(*task, scratch);
+        }
+
+        std::lock_guard lock(queue_mutex_);
+        result.has_more = !task_queue_.empty() || !priority_queue_.empty();
+        if (!result.has_more)
+        {
+            scheduled_ = false;
+            // Notify under the lock: once it is released the destructor may run.
+            queue_cv_.notify_all();
+        }
+        return result;
+    }
+
+    void MarketWorker::run_task(MarketTask &task, ExecutionBuffer &scratch)
+    {
+        std::visit(
+            Overloaded{
+                [this, &scratch](SubmitTask &req) -> void
+                {
+                    complete(req.done, run_submit(req.request, scratch));
+                },
+                [this](SubmitIntoTask &req) -> void
+                {
+                    complete(req.done, run_submit_into(req.request, *req.out));
+                },
+                [this, &scratch](SubmitBatchTask &req) -> void
+                {
+                    SubmitBatchResult results;
+                    results.reserve(req.requests.size());
+                    for (const OrderRequest &request : req.requests)
+                        results.push_back(run_submit(request, scratch));
+                    complete(req.done, std::move(results));
+                },
+                [this](CancelTask &req) -> void
+                {
+                    auto canceled = order_book_.cancel(req.order_id);
+                    if (ledger_ && canceled)
                     {
-                        req.done.set_value(CancelResultEx{order_book_.cancel(req.order_id)});
-                    },
-                    [this](BestBidTask &req) -> void
+                        if (canceled->side == Side::Buy)
+                        {
+                            // Part of the notional checked in reserve_in_ledger, so it fits.
+                            const auto quote = vertex::core::checked_notional(canceled->price, canceled->remaining_quantity);
+                            if (quote)
+                                ledger_->release(canceled->owner, LedgerAsset::Quote, *quote);
+                        }
+                        else
+                            ledger_->release(canceled->owner, LedgerAsset::Base, canceled->remaining_quantity);
+                    }
+                    complete(req.done, CancelResultEx{canceled});
+                },
+                [this](BestBidTask &req) -> void
+                {
+                    complete(req.done, PriceResult{order_book_.best_bid()});
+                },
+                [this](BestAskTask &req) -> void
+                {
+                    complete(req.done, PriceResult{order_book_.best_ask()});
+                },
+                [this](LedgerTransferTask &req) -> void
+                {
+                    if (!ledger_)
                     {
-                        req.done.set_value(PriceResult{order_book_.best_bid()});
-                    },
-                    [this](BestAskTask &req) -> void
+                        complete(req.done, LedgerResult{std::unexpected(EngineAsyncError::NoSubLedger)});
+                        return;
+                    }
+                    complete(req.done, ledger_->transfer(req.user_id, req.asset, req.amount, req.direction));
+                },
+                [this](LedgerBalanceTask &req) -> void
+                {
+                    if (!ledger_)
                     {
-                        req.done.set_value(PriceResult{order_book_.best_ask()});
-                    }},
-                *task);
+                        complete(req.done, LedgerBalanceResult{std::unexpected(EngineAsyncError::NoSubLedger)});
+                        return;
+                    }
+                    complete(req.done, LedgerBalanceResult{ledger_->balance(req.user_id)});
+                }},
+            task);
+    }
+
+    template <typename Result>
+    void MarketWorker::complete(Completion<Result> &done, Result result)
+    {
+        if (stage_ == nullptr)
+        {
+            done(std::move(result));
+            return;
         }
+
+        stage_->post([done = std::move(done), result = std::move(result)]() mutable
+                     { done(std::move(result)); });
     }
 
-    std::vector<Execution> MarketWorker::handle_submit(const OrderRequest &req)
+    MarketTask MarketWorker::pop_next_task()
     {
-        return std::visit(
+        // Called with queue_mutex_ held and at least one lane non-empty.
+        const bool burst_exhausted = config_.max_priority_burst != 0 && priority_burst_ >= config_.max_priority_burst;
+        const bool take_priority = !priority_queue_.empty() && (task_queue_.empty() || !burst_exhausted);
+
+        TaskQueue &lane = take_priority ? priority_queue_ : task_queue_;
+        priority_burst_ = take_priority ? priority_burst_ + 1 : 0;
+
+        MarketTask task = std::move(lane.front());
+        lane.pop();
+        return task;
+    }
+
+    SubmitIntoResult MarketWorker::run_submit_into(const OrderRequest &req, ExecutionBuffer &out)
+    {
+        out.clear();
+        if (ledger_ && !reserve_in_ledger(req))
+            return std::unexpected(EngineAsyncError::InsufficientFunds);
+
+        handle_submit(req, out);
+        for (Execution &execution : out)
+        {
+            execution.trade_id = trade_ids_.next();
+        }
+        if (ledger_)
+            settle_in_ledger(req, out);
+        return {};
+    }
+
+    SubmitResult MarketWorker::run_submit(const OrderRequest &req, ExecutionBuffer &scratch)
+    {
+        auto matched = run_submit_into(req, scratch);
+        if (!matched)
+            return std::unexpected(matched.error());
+
+        // The result outlives the arena, so hand out an exact-size copy.
+        return SubmitResult{std::in_place, scratch.begin(), scratch.end()};
+    }
+
+    void MarketWorker::handle_submit(const OrderRequest &req, ExecutionBuffer &out)
+    {
+        std::visit(
             Overloaded{
-                [this](const LimitOrderRequest &req) -> std::vector<Execution>
+                [this, &out](const LimitOrderRequest &req)
                 {
-                    return handle_limit_request(req);
+                    handle_limit_request(req, out);
                 },
-                [this](const MarketBuyByQuoteRequest &req) -> std::vector<Execution>
+                [this, &out](const MarketBuyByQuoteRequest &req)
                 {
-                    return handle_market_buy_by_quote(req);
+                    handle_market_buy_by_quote(req, out);
                 },
-                [this](const MarketSellByBaseRequest &req) -> std::vector<Execution>
+                [this, &out](const MarketSellByBaseRequest &req)
                 {
-                    return handle_market_sell_by_base(req);
+                    handle_market_sell_by_base(req, out);
                 }},
             req);
     }
 
-    std::vector<Execution> MarketWorker::handle_limit_request(const LimitOrderRequest &req)
+    void MarketWorker::handle_limit_request(const LimitOrderRequest &req, ExecutionBuffer &out)
     {
 
         Quantity remaining = req.base_quantity;
 
-        std::vector<Execution> executions = req.side == Side::Buy
-                                                ? order_book_.match_limit_buy_against_asks(req.id, req.limit_price, remaining)
-                                                : order_book_.match_limit_sell_against_bids(req.id, req.limit_price, remaining);
+        if (req.side == Side::Buy)
+            order_book_.match_limit_buy_against_asks(req.id, req.user_id, req.limit_price, remaining, out);
+        else
+            order_book_.match_limit_sell_against_bids(req.id, req.user_id, req.limit_price, remaining, out);
 
         if (remaining > 0)
-        {
-            RestingOrder ro{
-                .id = req.id,
-                .limit_price = req.limit_price,
-                .initial_base_quantity = req.base_quantity,
-                .remaining_base_quantity = remaining};
-            order_book_.insert_resting(req.side, std::move(ro));
-        }
+            order_book_.insert_resting(req, remaining);
+    }
 
-        return executions;
+    void MarketWorker::handle_market_buy_by_quote(const MarketBuyByQuoteRequest &req, ExecutionBuffer &out)
+    {
+        order_book_.match_market_buy_by_quote_against_asks(req.id, req.user_id, req.quote_budget, out);
     }
 
-    std::vector<Execution> MarketWorker::handle_market_buy_by_quote(const MarketBuyByQuoteRequest &req)
+    void MarketWorker::handle_market_sell_by_base(const MarketSellByBaseRequest &req, ExecutionBuffer &out)
     {
-        return order_book_.match_market_buy_by_quote_against_asks(req.id, req.quote_budget);
+        order_book_.match_market_sell_by_base_against_bids(req.id, req.user_id, req.base_quantity, out);
     }
 
-    std::vector<Execution> MarketWorker::handle_market_sell_by_base(const MarketSellByBaseRequest &req)
+    bool MarketWorker::reserve_in_ledger(const OrderRequest &req)
     {
-        return order_book_.match_market_sell_by_base_against_bids(req.id, req.base_quantity);
+        return std::visit(
+            Overloaded{
+                [this](const LimitOrderRequest &req)
+                {
+                    if (req.side == Side::Sell)
+                        return ledger_->reserve(req.user_id, LedgerAsset::Base, req.base_quantity);
+
+                    // Callers other than Exchange are not validated; an
+                    // unrepresentable notional cannot be funded.
+                    const auto quote = vertex::core::checked_notional(req.limit_price, req.base_quantity);
+                    return quote && ledger_->reserve(req.user_id, LedgerAsset::Quote, *quote);
+                },
+                [this](const MarketBuyByQuoteRequest &req)
+                {
+                    return ledger_->reserve(req.user_id, LedgerAsset::Quote, req.quote_budget);
+                },
+                [this](const MarketSellByBaseRequest &req)
+                {
+                    return ledger_->reserve(req.user_id, LedgerAsset::Base, req.base_quantity);
+                }},
+            req);
+    }
+
+    void MarketWorker::settle_in_ledger(const OrderRequest &req, const ExecutionBuffer &executions)
+    {
+        Quantity spent_quote = 0;
+        Quantity sold_base = 0;
+        for (const Execution &execution : executions)
+        {
+            // Its funds went back to free; the count flags the market for review.
+            if (!ledger_->settle(execution))
+                unsettled_ledger_executions_.fetch_add(1, std::memory_order_relaxed);
+            spent_quote += vertex::core::notional(execution.execution_price, execution.quantity);
+            sold_base += execution.quantity;
+        }
+
+        // A limit order's unfilled part rests and keeps its reservation.
+        if (const auto *buy = std::get_if<MarketBuyByQuoteRequest>(&req); buy != nullptr && spent_quote < buy->quote_budget)
+            ledger_->release(buy->user_id, LedgerAsset::Quote, buy->quote_budget - spent_quote);
+        if (const auto *sell = std::get_if<MarketSellByBaseRequest>(&req); sell != nullptr && sold_base < sell->base_quantity)
+            ledger_->release(sell->user_id, LedgerAsset::Base, sell->base_quantity - sold_base);
     }
 
 } // namespace vertex::engine
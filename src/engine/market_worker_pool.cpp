@@ -0,0 +1,174 @@
+#include "vertex/engine/market_worker_pool.hpp"
+
+#include <cassert>
+
+#include "vertex/engine/market_worker.hpp"
+
+namespace vertex::engine
+{
+    MarketWorkerPool::MarketWorkerPool(std::size_t thread_count, std::size_t batch_size, std::size_t steal_threshold)
+        : batch_size_(batch_size), steal_threshold_(steal_threshold), started_at_(std::chrono::steady_clock::now())
+    {
+        assert(thread_count > 0);
+        assert(batch_size > 0);
+
+        stages_.resize(thread_count);
+        run_queues_.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            run_queues_.push_back(std::make_unique<RunQueue>());
+        }
+
+        threads_.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads_.emplace_back([this, i]
+                                  { run(i); });
+        }
+    }
+
+    MarketWorkerPool::~MarketWorkerPool()
+    {
+        for (auto &queue : run_queues_)
+        {
+            {
+                std::lock_guard lock(queue->mu);
+                queue->stopping = true;
+            }
+            queue->cv.notify_all();
+        }
+
+        for (auto &thread : threads_)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    MarketWorkerPoolStats MarketWorkerPool::stats() const
+    {
+        MarketWorkerPoolStats stats;
+        stats.elapsed_ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started_at_).count());
+        stats.migrations = migrations_.load(std::memory_order_relaxed);
+        stats.threads.reserve(run_queues_.size());
+        for (const auto &queue : run_queues_)
+        {
+            stats.threads.push_back(MarketWorkerPoolThreadStats{
+                .busy_ns = queue->busy_ns.load(std::memory_order_relaxed),
+                .tasks_run = queue->tasks_run.load(std::memory_order_relaxed),
+                .batches_run = queue->batches_run.load(std::memory_order_relaxed),
+                .arena_upstream_allocations = queue->arena_upstream_allocations.load(std::memory_order_relaxed),
+            });
+        }
+        return stats;
+    }
+
+    std::size_t MarketWorkerPool::assign_home() noexcept
+    {
+        return next_home_.fetch_add(1, std::memory_order_relaxed) % run_queues_.size();
+    }
+
+    SettlementStage &MarketWorkerPool::settlement_stage(std::size_t lane, std::size_t capacity)
+    {
+        std::lock_guard lock(stages_mu_);
+        std::unique_ptr<SettlementStage> &stage = stages_[lane];
+        if (stage == nullptr)
+            stage = std::make_unique<SettlementStage>(capacity, true);
+        return *stage;
+    }
+
+    void MarketWorkerPool::schedule(MarketWorker *worker, std::size_t home)
+    {
+        RunQueue &queue = *run_queues_[home];
+        {
+            std::lock_guard lock(queue.mu);
+            queue.ready.push_back(worker);
+        }
+        queue.cv.notify_one();
+    }
+
+    void MarketWorkerPool::run(std::size_t index)
+    {
+        RunQueue &queue = *run_queues_[index];
+        WorkerArena arena{queue.arena_upstream_allocations};
+        auto has_work = [&queue]
+        { return queue.stopping || !queue.ready.empty(); };
+
+        while (true)
+        {
+            MarketWorker *worker = nullptr;
+            {
+                std::unique_lock lock(queue.mu);
+                // With stealing enabled an idle thread wakes periodically to
+                // look at the other run queues.
+                if (steal_threshold_ == 0)
+                    queue.cv.wait(lock, has_work);
+                else
+                    queue.cv.wait_for(lock, kStealPollInterval, has_work);
+
+                if (queue.stopping && queue.ready.empty())
+                    return;
+
+                if (!queue.ready.empty())
+                {
+                    worker = queue.ready.front();
+                    queue.ready.pop_front();
+                }
+            }
+
+            if (worker == nullptr)
+            {
+                worker = try_steal(index);
+                if (worker == nullptr)
+                    continue;
+            }
+
+            const auto batch_start = std::chrono::steady_clock::now();
+            const MarketWorker::BatchResult batch = worker->run_batch(batch_size_, arena.resource());
+            arena.reset();
+            const auto batch_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - batch_start);
+
+            queue.busy_ns.fetch_add(static_cast<std::uint64_t>(batch_ns.count()), std::memory_order_relaxed);
+            queue.tasks_run.fetch_add(batch.tasks_run, std::memory_order_relaxed);
+            queue.batches_run.fetch_add(1, std::memory_order_relaxed);
+
+            // A market that still has work after its batch goes to the back of
+            // the run queue, so one hot market cannot starve the others.
+            if (batch.has_more)
+            {
+                std::lock_guard lock(queue.mu);
+                queue.ready.push_back(worker);
+            }
+        }
+    }
+
+    MarketWorker *MarketWorkerPool::try_steal(std::size_t thief)
+    {
+        const std::size_t thread_count = run_queues_.size();
+
+        for (std::size_t offset = 1; offset < thread_count; ++offset)
+        {
+            RunQueue &victim = *run_queues_[(thief + offset) % thread_count];
+            MarketWorker *worker = nullptr;
+            {
+                std::lock_guard lock(victim.mu);
+                if (victim.ready.empty() || victim.ready.size() < steal_threshold_)
+                    continue;
+
+                // Take from the back: the front is what the victim runs next.
+                worker = victim.ready.back();
+                victim.ready.pop_back();
+            }
+
+            // Safe point: the market is scheduled but not running, and we now
+            // own it, so rehoming cannot race with a batch or a schedule().
+            worker->home_.store(thief, std::memory_order_relaxed);
+            migrations_.fetch_add(1, std::memory_order_relaxed);
+            return worker;
+        }
+
+        return nullptr;
+    }
+
+}
@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <cassert>
+#include <limits>
+#include "vertex/core/notional.hpp"
 #include "vertex/engine/order_book.hpp"
 
 namespace vertex::engine
@@ -7,56 +9,107 @@ namespace vertex::engine
 
     using Side = vertex::core::Side;
 
-    OrderBook::OrderBook(Market market) : market_(market) {}
+    OrderBook::OrderBook(Market market, MarketSpec spec) : market_(market), spec_(spec)
+    {
+        assert(spec_.is_valid() && "Invariant violated: order book built with an invalid market spec");
+    }
+
+    OrderSlot OrderBook::allocate_slot()
+    {
+        if (free_head_ != kNoOrderSlot)
+        {
+            const OrderSlot slot = free_head_;
+            free_head_ = orders_[slot].next;
+            return slot;
+        }
+
+        assert(orders_.size() < kNoOrderSlot && "Invariant violated: order book pool exhausted");
+        orders_.emplace_back();
+        cold_.emplace_back();
+        return static_cast<OrderSlot>(orders_.size() - 1);
+    }
+
+    void OrderBook::free_slot(OrderSlot slot) noexcept
+    {
+        orders_[slot].id = OrderId{};
+        orders_[slot].next = free_head_;
+        free_head_ = slot;
+    }
+
+    void OrderBook::push_back(PriceLevel &level, OrderSlot slot) noexcept
+    {
+        RestingOrder &order = orders_[slot];
+        order.prev = level.tail;
+        order.next = kNoOrderSlot;
+
+        if (level.tail == kNoOrderSlot)
+            level.head = slot;
+        else
+            orders_[level.tail].next = slot;
+        level.tail = slot;
+    }
+
+    void OrderBook::unlink(PriceLevel &level, OrderSlot slot) noexcept
+    {
+        const RestingOrder &order = orders_[slot];
+
+        if (order.prev == kNoOrderSlot)
+            level.head = order.next;
+        else
+            orders_[order.prev].next = order.next;
+
+        if (order.next == kNoOrderSlot)
+            level.tail = order.prev;
+        else
+            orders_[order.next].prev = order.prev;
+    }
 
     std::optional<CancelResult> OrderBook::cancel(OrderId order_id)
     {
         assert(order_id.is_valid());
 
-        auto order_location_it = index_.find(order_id);
+        auto index_it = index_.find(order_id);
 
-        if (order_location_it == index_.end())
+        if (index_it == index_.end())
         {
             return std::nullopt;
         }
 
-        CancelResult result;
-
-        auto order_it = order_location_it->second.it;
+        const OrderSlot slot = index_it->second;
+        const RestingOrder &order = orders_[slot];
 
+        CancelResult result;
         result.id = order_id;
-        result.side = order_location_it->second.side;
-        result.price = order_it->limit_price;
-        result.remaining_quantity = order_it->remaining_base_quantity;
+        result.owner = UserId{order.owner};
+        result.side = order.side;
+        result.price = spec_.to_price(order.limit_ticks);
+        result.remaining_quantity = spec_.to_quantity(order.remaining_lots);
 
-        if (order_location_it->second.side == Side::Buy)
+        if (order.side == Side::Buy)
         {
-            auto level_it = bids_.find(order_it->limit_price);
+            auto level_it = bids_.find(order.limit_ticks);
+            assert(level_it != bids_.end() && "Invariant violated: resting bid without a price level");
 
-            if (level_it != bids_.end())
+            unlink(level_it->second, slot);
+            if (level_it->second.empty())
             {
-                level_it->second.orders.erase(order_it);
-                if (level_it->second.orders.empty())
-                {
-                    bids_.erase(level_it);
-                }
+                bids_.erase(level_it);
             }
         }
         else
         {
-            auto level_it = asks_.find(order_it->limit_price);
+            auto level_it = asks_.find(order.limit_ticks);
+            assert(level_it != asks_.end() && "Invariant violated: resting ask without a price level");
 
-            if (level_it != asks_.end())
+            unlink(level_it->second, slot);
+            if (level_it->second.empty())
             {
-                level_it->second.orders.erase(order_it);
-                if (level_it->second.orders.empty())
-                {
-                    asks_.erase(level_it);
-                }
+                asks_.erase(level_it);
             }
         }
 
-        index_.erase(order_location_it);
+        index_.erase(index_it);
+        free_slot(slot);
         return result;
     }
 
@@ -66,7 +119,7 @@ namespace vertex::engine
         if (bids_.empty())
             return std::nullopt;
 
-        return bids_.begin()->first;
+        return spec_.to_price(bids_.begin()->first);
     }
 
     std::optional<Price> OrderBook::best_ask() const
@@ -75,154 +128,189 @@ namespace vertex::engine
         if (asks_.empty())
             return std::nullopt;
 
-        return asks_.begin()->first;
+        return spec_.to_price(asks_.begin()->first);
     }
 
-    void OrderBook::insert_resting(Side side, RestingOrder &&order)
+    void OrderBook::insert_resting(const LimitOrderRequest &order, Quantity remaining_base_quantity)
     {
-        const Price limit_price = order.limit_price;
-        const OrderId order_id = order.id;
+        assert(remaining_base_quantity > 0 && remaining_base_quantity <= order.base_quantity);
+        assert(order.user_id.get_value() <= std::numeric_limits<OwnerSlot>::max() &&
+               "Invariant violated: owner id does not fit an owner slot");
+
+        const Ticks limit_ticks = spec_.to_ticks(order.limit_price);
+        const OrderSlot slot = allocate_slot();
+
+        RestingOrder &resting = orders_[slot];
+        resting.id = order.id;
+        resting.limit_ticks = limit_ticks;
+        resting.remaining_lots = spec_.to_lots(remaining_base_quantity);
+        resting.owner = static_cast<OwnerSlot>(order.user_id.get_value());
+        resting.side = order.side;
+        cold_[slot] = RestingOrderCold{
+            .initial_lots = spec_.to_lots(order.base_quantity),
+            .sequence = next_sequence_++};
+
+        // try_emplace returns the existing level or a new empty one.
+        PriceLevel &level = order.side == Side::Buy ? bids_.try_emplace(limit_ticks).first->second
+                                                    : asks_.try_emplace(limit_ticks).first->second;
+        push_back(level, slot);
+        index_[order.id] = slot;
+    }
 
-        if (side == Side::Buy)
-        {
-            auto level_it = bids_.find(limit_price);
+    std::optional<RestingOrderInfo> OrderBook::find_resting(OrderId order_id) const
+    {
+        auto index_it = index_.find(order_id);
+        if (index_it == index_.end())
+            return std::nullopt;
 
-            if (level_it == bids_.end())
-            {
-                auto [it, inserted] = bids_.try_emplace(limit_price);
-                auto &orders = it->second.orders;
-                auto order_it = orders.insert(orders.end(), std::move(order));
+        const RestingOrder &order = orders_[index_it->second];
+        const RestingOrderCold &cold = cold_[index_it->second];
+        return RestingOrderInfo{
+            .id = order.id,
+            .owner = UserId{order.owner},
+            .side = order.side,
+            .limit_price = spec_.to_price(order.limit_ticks),
+            .initial_quantity = spec_.to_quantity(cold.initial_lots),
+            .remaining_quantity = spec_.to_quantity(order.remaining_lots),
+            .sequence = cold.sequence};
+    }
 
-                index_[order_id] = {side, limit_price, order_it};
-            }
-            else
-            {
-                auto &orders = level_it->second.orders;
-                auto order_it = orders.insert(orders.end(), std::move(order));
-                index_[order_id] = {side, limit_price, order_it};
-            }
-        }
-        else
-        {
-            auto level_it = asks_.find(limit_price);
+    std::vector<Execution> OrderBook::match_limit_buy_against_asks(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity)
+    {
+        ExecutionBuffer result;
+        match_limit_buy_against_asks(taker_order_id, taker_owner, limit_price, remaining_base_quantity, result);
+        return {result.begin(), result.end()};
+    }
 
-            if (level_it == asks_.end())
-            {
+    std::vector<Execution> OrderBook::match_limit_sell_against_bids(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity)
+    {
+        ExecutionBuffer result;
+        match_limit_sell_against_bids(taker_order_id, taker_owner, limit_price, remaining_base_quantity, result);
+        return {result.begin(), result.end()};
+    }
 
-                auto [it, inserted] = asks_.try_emplace(limit_price);
-                auto &orders = it->second.orders;
-                auto order_it = orders.insert(orders.end(), std::move(order));
+    std::vector<Execution> OrderBook::match_market_buy_by_quote_against_asks(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_quote_budget)
+    {
+        ExecutionBuffer result;
+        match_market_buy_by_quote_against_asks(taker_order_id, taker_owner, remaining_quote_budget, result);
+        return {result.begin(), result.end()};
+    }
 
-                index_[order_id] = {side, limit_price, order_it};
-            }
-            else
-            {
-                auto &orders = level_it->second.orders;
-                auto order_it = orders.insert(orders.end(), std::move(order));
-                index_[order_id] = {side, limit_price, order_it};
-            }
-        }
+    std::vector<Execution> OrderBook::match_market_sell_by_base_against_bids(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_base_quantity)
+    {
+        ExecutionBuffer result;
+        match_market_sell_by_base_against_bids(taker_order_id, taker_owner, remaining_base_quantity, result);
+        return {result.begin(), result.end()};
     }
 
-    std::vector<Execution> OrderBook::match_limit_buy_against_asks(const OrderId taker_order_id, const Price limit_price, Quantity &remaining_base_quantity)
+    void OrderBook::match_limit_buy_against_asks(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity, ExecutionBuffer &result)
     {
-        std::vector<Execution> result;
+        assert(spec_.is_on_lot(remaining_base_quantity) && "Invariant violated: taker quantity is not on a lot boundary");
+        const Ticks limit_ticks = spec_.to_ticks(limit_price);
 
-        while (remaining_base_quantity > 0 && !asks_.empty() && asks_.begin()->first <= limit_price)
+        while (remaining_base_quantity > 0 && !asks_.empty() && asks_.begin()->first <= limit_ticks)
         {
             auto &level = asks_.begin()->second; 
-            Price price = asks_.begin()->first;
+            Price price = spec_.to_price(asks_.begin()->first);
 
-            auto resting_it = level.orders.begin();
-            RestingOrder &resting_order = *resting_it; 
+            const OrderSlot resting_slot = level.head;
+            RestingOrder &resting_order = orders_[resting_slot]; 
 
-            Quantity executed = std::min(remaining_base_quantity, resting_order.remaining_base_quantity);
+            Lots executed_lots = static_cast<Lots>(std::min<Quantity>(remaining_base_quantity / spec_.lot_size, resting_order.remaining_lots));
+            Quantity executed = spec_.to_quantity(executed_lots);
 
-            resting_order.reduce(executed);
+            resting_order.reduce(executed_lots);
             remaining_base_quantity -= executed;
 
             bool taker_fully_filled = remaining_base_quantity == 0 ? true : false;
 
-            result.push_back({taker_order_id, resting_order.id, executed, price, limit_price, taker_fully_filled, resting_order.is_filled()});
+            result.push_back({taker_order_id, resting_order.id, taker_owner, UserId{resting_order.owner}, executed, price, limit_price, taker_fully_filled, resting_order.is_filled()});
 
             if (resting_order.is_filled())
             {
                 index_.erase(resting_order.id);
-                level.orders.erase(resting_it);
+                unlink(level, resting_slot);
+                free_slot(resting_slot);
             }
 
-            if (level.orders.empty())
+            if (level.empty())
             {
                 asks_.erase(asks_.begin());
             }
         }
 
-        return result;
     }
 
-    std::vector<Execution> OrderBook::match_limit_sell_against_bids(const OrderId taker_order_id, const Price limit_price, Quantity &remaining_base_quantity)
+    void OrderBook::match_limit_sell_against_bids(const OrderId taker_order_id, const UserId taker_owner, const Price limit_price, Quantity &remaining_base_quantity, ExecutionBuffer &result)
     {
-        std::vector<Execution> result;
+        assert(spec_.is_on_lot(remaining_base_quantity) && "Invariant violated: taker quantity is not on a lot boundary");
+        const Ticks limit_ticks = spec_.to_ticks(limit_price);
 
-        while (remaining_base_quantity > 0 && !bids_.empty() && bids_.begin()->first >= limit_price)
+        while (remaining_base_quantity > 0 && !bids_.empty() && bids_.begin()->first >= limit_ticks)
         {
             auto &level = bids_.begin()->second;
-            Price price = bids_.begin()->first;
+            Price price = spec_.to_price(bids_.begin()->first);
 
-            auto resting_it = level.orders.begin();
-            RestingOrder &resting_order = *resting_it;
+            const OrderSlot resting_slot = level.head;
+            RestingOrder &resting_order = orders_[resting_slot];
 
-            Quantity executed = std::min(remaining_base_quantity, resting_order.remaining_base_quantity);
+            Lots executed_lots = static_cast<Lots>(std::min<Quantity>(remaining_base_quantity / spec_.lot_size, resting_order.remaining_lots));
+            Quantity executed = spec_.to_quantity(executed_lots);
 
-            resting_order.reduce(executed);
+            resting_order.reduce(executed_lots);
             remaining_base_quantity -= executed;
 
             bool taker_fully_filled = remaining_base_quantity == 0 ? true : false;
 
-            result.push_back({resting_order.id, taker_order_id, executed, price, resting_order.limit_price, resting_order.is_filled(), taker_fully_filled});
+            result.push_back({resting_order.id, taker_order_id, UserId{resting_order.owner}, taker_owner, executed, price, spec_.to_price(resting_order.limit_ticks), resting_order.is_filled(), taker_fully_filled});
 
             if (resting_order.is_filled())
             {
                 index_.erase(resting_order.id);
-                level.orders.erase(resting_it);
+                unlink(level, resting_slot);
+                free_slot(resting_slot);
             }
 
-            if (level.orders.empty())
+            if (level.empty())
             {
                 bids_.erase(bids_.begin());
             }
         }
-        return result;
     }
 
-    std::vector<Execution> OrderBook::match_market_buy_by_quote_against_asks(const OrderId taker_order_id, Quantity remaining_quote_budget)
+    void OrderBook::match_market_buy_by_quote_against_asks(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_quote_budget, ExecutionBuffer &result)
     {
-        std::vector<Execution> result;
-
         while (remaining_quote_budget > 0 && !asks_.empty())
         {
             auto level_it = asks_.begin();
             auto &level = level_it->second;
-            auto resting_it = level.orders.begin();
+            const OrderSlot resting_slot = level.head;
 
-            RestingOrder &resting_order = *resting_it;
-            Price price = level_it->first;
+            RestingOrder &resting_order = orders_[resting_slot];
+            Price price = spec_.to_price(level_it->first);
 
-            auto remaining_quote = remaining_quote_budget; // quote budget remaining
-            auto max_base = remaining_quote / price;       // how much base we can buy at this price
-            auto executed_base = std::min(max_base, resting_order.remaining_base_quantity);
+            // A lot too expensive to represent is also beyond any budget.
+            auto lot_cost = vertex::core::checked_notional(price, spec_.lot_size);
+            if (!lot_cost)
+                break;
+
+            auto max_lots = remaining_quote_budget / *lot_cost; // how many lots we can buy at this price
+            auto executed_lots = static_cast<Lots>(std::min<Quantity>(max_lots, resting_order.remaining_lots));
 
             // math gouard
-            if (executed_base <= 0)
+            if (executed_lots == 0)
                 break;
 
-            resting_order.reduce(executed_base);
-            remaining_quote_budget -= (executed_base * price);
+            auto executed_base = spec_.to_quantity(executed_lots);
+            resting_order.reduce(executed_lots);
+            remaining_quote_budget -= executed_lots * *lot_cost;
 
             bool taker_fully_filled = remaining_quote_budget == 0 ? true : false;
 
             result.push_back({taker_order_id,
                               resting_order.id,
+                              taker_owner,
+                              UserId{resting_order.owner},
                               executed_base,
                               price,
                               std::nullopt,
@@ -232,55 +320,60 @@ namespace vertex::engine
             if (resting_order.is_filled())
             {
                 index_.erase(resting_order.id);
-                level.orders.erase(resting_it);
+                unlink(level, resting_slot);
+                free_slot(resting_slot);
             }
-            if (level.orders.empty())
+            if (level.empty())
             {
                 asks_.erase(level_it);
             }
         }
-        return result;
     }
 
-    std::vector<Execution> OrderBook::match_market_sell_by_base_against_bids(const OrderId taker_order_id, Quantity remaining_base_quantity)
+    void OrderBook::match_market_sell_by_base_against_bids(const OrderId taker_order_id, const UserId taker_owner, Quantity remaining_base_quantity, ExecutionBuffer &result)
     {
-        std::vector<Execution> result;
-
         while (remaining_base_quantity > 0 && !bids_.empty())
         {
             auto level_it = bids_.begin();
             auto &level = level_it->second;
-            auto resting_it = level.orders.begin();
+            const OrderSlot resting_slot = level.head;
 
-            RestingOrder &resting_order = *resting_it;
-            Price price = level_it->first;
+            RestingOrder &resting_order = orders_[resting_slot];
+            Price price = spec_.to_price(level_it->first);
 
-            auto executed_quantity = std::min(remaining_base_quantity, resting_order.remaining_base_quantity);
+            auto executed_lots = static_cast<Lots>(std::min<Quantity>(remaining_base_quantity / spec_.lot_size, resting_order.remaining_lots));
 
-            resting_order.reduce(executed_quantity);
+            // Less than one lot left.
+            if (executed_lots == 0)
+                break;
+
+            auto executed_quantity = spec_.to_quantity(executed_lots);
+            resting_order.reduce(executed_lots);
             remaining_base_quantity -= executed_quantity;
 
             bool taker_fully_filled = remaining_base_quantity == 0 ? true : false;
 
             result.push_back({resting_order.id,
                               taker_order_id,
+                              UserId{resting_order.owner},
+                              taker_owner,
                               executed_quantity,
                               price,
-                              resting_order.limit_price,
+                              spec_.to_price(resting_order.limit_ticks),
                               resting_order.is_filled(),
                               taker_fully_filled});
 
             if (resting_order.is_filled())
             {
                 index_.erase(resting_order.id);
-                level.orders.erase(resting_it);
+                unlink(level, resting_slot);
+                free_slot(resting_slot);
             }
-            if (level.orders.empty())
+            if (level.empty())
             {
                 bids_.erase(level_it);
             }
         }
-        return result;
     }
 
 }
@@ -0,0 +1,46 @@
+#include "vertex/engine/settlement_stage.hpp"
+
+#include <optional>
+#include <utility>
+
+namespace vertex::engine
+{
+    SettlementStage::SettlementStage(std::size_t capacity, bool shared) : queue_(capacity), shared_(shared)
+    {
+        thread_ = std::thread([this]
+                              { run(); });
+    }
+
+    SettlementStage::~SettlementStage()
+    {
+        // An empty job is the stop marker; every producer has finished posting.
+        post(Job{});
+        thread_.join();
+    }
+
+    void SettlementStage::post(Job job)
+    {
+        std::unique_lock<std::mutex> lock;
+        if (shared_)
+            lock = std::unique_lock(producer_mu_);
+        while (!queue_.try_push(std::move(job)))
+            std::this_thread::yield();
+    }
+
+    void SettlementStage::run()
+    {
+        while (true)
+        {
+            std::optional<Job> job = queue_.try_pop();
+            if (!job)
+            {
+                queue_.wait_while_empty();
+                continue;
+            }
+
+            if (!*job)
+                return;
+            (*job)();
+        }
+    }
+} // namespace vertex::engine
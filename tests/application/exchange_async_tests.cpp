@@ -0,0 +1,266 @@
+#include <atomic>
+#include <future>
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "vertex/application/exchange.hpp"
+#include "vertex/application/io_thread_pool.hpp"
+
+namespace
+{
+    using vertex::application::CancelOrderError;
+    using vertex::application::CancelOrderResult;
+    using vertex::application::DetachedTask;
+    using vertex::application::Exchange;
+    using vertex::application::IoThreadPool;
+    using vertex::application::OrderPlacementResult;
+    using vertex::application::PlaceOrderError;
+    using vertex::core::Asset;
+    using vertex::core::Market;
+    using vertex::core::OrderId;
+    using vertex::core::Side;
+    using vertex::core::UserId;
+
+    using PlaceResult = std::expected<OrderPlacementResult, PlaceOrderError>;
+    using CancelResult = std::expected<CancelOrderResult, CancelOrderError>;
+
+    Market btc_usdt()
+    {
+        return Market{Asset{"btc"}, Asset{"usdt"}};
+    }
+
+    DetachedTask place_limit_session(
+        Exchange &exchange,
+        IoThreadPool &pool,
+        UserId user_id,
+        Side side,
+        std::promise<PlaceResult> &out)
+    {
+        co_await pool.schedule();
+        auto result = co_await exchange.place_limit_order_async(pool, user_id, btc_usdt(), side, 100, 2);
+        out.set_value(std::move(result));
+    }
+
+    DetachedTask place_then_cancel_session(
+        Exchange &exchange,
+        IoThreadPool &pool,
+        UserId user_id,
+        std::promise<CancelResult> &out)
+    {
+        co_await pool.schedule();
+        auto placed = co_await exchange.place_limit_order_async(pool, user_id, btc_usdt(), Side::Buy, 10, 5);
+        if (!placed)
+        {
+            out.set_value(std::unexpected(CancelOrderError::OrderNotFound));
+            co_return;
+        }
+        auto canceled = co_await exchange.cancel_order_async(pool, user_id, placed->order_id);
+        out.set_value(std::move(canceled));
+    }
+
+    DetachedTask market_buy_session(
+        Exchange &exchange,
+        IoThreadPool &pool,
+        UserId user_id,
+        std::promise<PlaceResult> &out)
+    {
+        co_await pool.schedule();
+        auto result = co_await exchange.execute_market_order_async(pool, user_id, btc_usdt(), Side::Buy, 250);
+        out.set_value(std::move(result));
+    }
+} // namespace
+
+TEST(IoThreadPoolTest, ScheduleResumesCoroutineOnPoolThread)
+{
+    IoThreadPool pool{2};
+    std::promise<std::thread::id> resumed_on;
+
+    auto session = [&]() -> DetachedTask
+    {
+        co_await pool.schedule();
+        resumed_on.set_value(std::this_thread::get_id());
+    };
+    session();
+
+    EXPECT_NE(resumed_on.get_future().get(), std::this_thread::get_id());
+}
+
+TEST(ExchangeAsyncTest, AsyncLimitOrdersMatchAndSettle)
+{
+    Exchange exchange;
+    IoThreadPool pool{2};
+    ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+
+    const UserId seller = exchange.create_user("seller").value();
+    const UserId buyer = exchange.create_user("buyer").value();
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 2).has_value());
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 200).has_value());
+
+    std::promise<PlaceResult> sell_result;
+    place_limit_session(exchange, pool, seller, Side::Sell, sell_result);
+    auto sell = sell_result.get_future().get();
+    ASSERT_TRUE(sell.has_value());
+    EXPECT_EQ(sell->filled_quantity, 0);
+
+    std::promise<PlaceResult> buy_result;
+    place_limit_session(exchange, pool, buyer, Side::Buy, buy_result);
+    auto buy = buy_result.get_future().get();
+    ASSERT_TRUE(buy.has_value());
+    EXPECT_EQ(buy->filled_quantity, 2);
+    EXPECT_EQ(buy->remaining_quantity, 0);
+
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), 2);
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"usdt"}).value(), 200);
+    EXPECT_EQ(exchange.reserved_balance(seller, Asset{"btc"}).value(), 0);
+}
+
+TEST(ExchangeAsyncTest, AsyncRejectionIsReadyWithoutSuspending)
+{
+    Exchange exchange;
+    IoThreadPool pool{1};
+    ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+    const UserId buyer = exchange.create_user("buyer").value();
+
+    std::promise<PlaceResult> result;
+    place_limit_session(exchange, pool, buyer, Side::Buy, result);
+    auto placed = result.get_future().get();
+
+    ASSERT_FALSE(placed.has_value());
+    EXPECT_EQ(placed.error(), PlaceOrderError::InsufficientFunds);
+}
+
+TEST(ExchangeAsyncTest, AsyncCancelReleasesReservation)
+{
+    Exchange exchange;
+    IoThreadPool pool{2};
+    ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+    const UserId buyer = exchange.create_user("buyer").value();
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 50).has_value());
+
+    std::promise<CancelResult> result;
+    place_then_cancel_session(exchange, pool, buyer, result);
+    auto canceled = result.get_future().get();
+
+    ASSERT_TRUE(canceled.has_value());
+    EXPECT_EQ(canceled->remaining_quantity, 5);
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"usdt"}).value(), 50);
+    EXPECT_EQ(exchange.reserved_balance(buyer, Asset{"usdt"}).value(), 0);
+}
+
+TEST(ExchangeAsyncTest, AsyncMarketBuyReleasesUnusedBudget)
+{
+    Exchange exchange;
+    IoThreadPool pool{2};
+    ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+
+    const UserId seller = exchange.create_user("seller").value();
+    const UserId buyer = exchange.create_user("buyer").value();
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 2).has_value());
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 300).has_value());
+    ASSERT_TRUE(exchange.place_limit_order(seller, btc_usdt(), Side::Sell, 100, 2).has_value());
+
+    std::promise<PlaceResult> result;
+    market_buy_session(exchange, pool, buyer, result);
+    auto bought = result.get_future().get();
+
+    ASSERT_TRUE(bought.has_value());
+    EXPECT_EQ(bought->filled_quantity, 200);
+    EXPECT_EQ(bought->remaining_quantity, 50);
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"usdt"}).value(), 100);
+    EXPECT_EQ(exchange.reserved_balance(buyer, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), 2);
+}
+
+TEST(ExchangeAsyncTest, ManySessionsOnFewThreadsKeepBalancesConsistent)
+{
+    Exchange exchange;
+    IoThreadPool pool{2};
+    ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+
+    const UserId seller = exchange.create_user("seller").value();
+    const UserId buyer = exchange.create_user("buyer").value();
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 2'000).has_value());
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 200'000).has_value());
+
+    constexpr int kSessions = 64;
+    constexpr int kOrdersPerSession = 20;
+    std::latch finished(2 * kSessions);
+    std::atomic<int> failures{0};
+
+    auto session = [&](UserId user_id, Side side) -> DetachedTask
+    {
+        co_await pool.schedule();
+        for (int i = 0; i < kOrdersPerSession; ++i)
+        {
+            auto result = co_await exchange.place_limit_order_async(pool, user_id, btc_usdt(), side, 100, 1);
+            if (!result)
+                failures.fetch_add(1);
+        }
+        finished.count_down();
+    };
+
+    for (int i = 0; i < kSessions; ++i)
+    {
+        session(seller, Side::Sell);
+        session(buyer, Side::Buy);
+    }
+    finished.wait();
+
+    EXPECT_EQ(failures.load(), 0);
+    const auto total_orders = kSessions * kOrdersPerSession;
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), total_orders);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"usdt"}).value(), 100 * total_orders);
+    EXPECT_EQ(exchange.reserved_balance(buyer, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.reserved_balance(seller, Asset{"btc"}).value(), 0);
+}
+
+TEST(ExchangeAsyncTest, SettlementStageSessionsKeepBalancesConsistent)
+{
+    Exchange exchange;
+    IoThreadPool pool{2};
+    ASSERT_TRUE(exchange.register_market(btc_usdt(), vertex::engine::MarketWorkerConfig{.settlement_stage = true}).has_value());
+
+    const UserId seller = exchange.create_user("seller").value();
+    const UserId buyer = exchange.create_user("buyer").value();
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 200).has_value());
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 20'000).has_value());
+
+    constexpr int kSessions = 16;
+    constexpr int kOrdersPerSession = 10;
+    std::latch finished(2 * kSessions);
+    std::atomic<int> failures{0};
+
+    auto session = [&](UserId user_id, Side side) -> DetachedTask
+    {
+        co_await pool.schedule();
+        for (int i = 0; i < kOrdersPerSession; ++i)
+        {
+            auto result = co_await exchange.place_limit_order_async(pool, user_id, btc_usdt(), side, 100, 1);
+            if (!result)
+                failures.fetch_add(1);
+        }
+        finished.count_down();
+    };
+
+    for (int i = 0; i < kSessions; ++i)
+    {
+        session(seller, Side::Sell);
+        session(buyer, Side::Buy);
+    }
+    finished.wait();
+
+    std::promise<CancelResult> canceled_result;
+    place_then_cancel_session(exchange, pool, buyer, canceled_result);
+    ASSERT_TRUE(canceled_result.get_future().get().has_value());
+
+    EXPECT_EQ(failures.load(), 0);
+    const auto total_orders = kSessions * kOrdersPerSession;
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), total_orders);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"usdt"}).value(), 100 * total_orders);
+    EXPECT_EQ(exchange.reserved_balance(buyer, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.reserved_balance(seller, Asset{"btc"}).value(), 0);
+}
@@ -21,9 +21,12 @@
 namespace
 {
     using vertex::application::Exchange;
+    using vertex::application::ExchangeConfig;
     using vertex::application::CancelOrderError;
     using vertex::application::ExchangeTestAccess;
+    using vertex::application::PlaceOrderError;
     using vertex::application::TradeHistory;
+    using vertex::application::WalletMode;
     using vertex::core::Asset;
     using vertex::core::Market;
     using vertex::core::OrderId;
@@ -31,6 +34,7 @@ namespace
     using vertex::core::TradeId;
     using vertex::core::UserId;
     using vertex::domain::Trade;
+    using vertex::engine::MarketWorkerConfig;
 
     class TimeoutAbortGuard
     {
@@ -108,7 +112,8 @@ namespace
         {
             (void)order_id;
             EXPECT_TRUE(exchange.user_exists(meta.owner));
-            const bool market_known = std::find(known_markets.begin(), known_markets.end(), meta.market) != known_markets.end();
+            const bool market_known = std::any_of(known_markets.begin(), known_markets.end(), [&](const Market &market)
+                                                  { return exchange.find_market_id(market) == meta.market; });
             EXPECT_TRUE(market_known);
         }
     }
@@ -544,6 +549,240 @@ TEST(ExchangeConcurrencyTest, PlaceLimitParallelStressDoesNotProduceNegativeBala
     }
 }
 
+namespace
+{
+    // Two users on both sides of one market from many threads; totals must not move.
+    void expect_shared_users_conserve_balances(WalletMode wallet_mode)
+    {
+        constexpr int kThreads = 8;
+        constexpr int kIterations = 800;
+        constexpr int kPrice = 100;
+        constexpr vertex::core::Quantity kInitialQuote = 1'000'000;
+        constexpr vertex::core::Quantity kInitialBase = 10'000;
+
+        for (int repeat = 0; repeat < kScenarioRepeats; ++repeat)
+        {
+            Exchange exchange{ExchangeConfig{.wallet_mode = wallet_mode}};
+            const Market market = btc_usdt();
+            const Asset btc{"btc"};
+            const Asset usdt{"usdt"};
+            ASSERT_TRUE(exchange.register_market(market).has_value());
+
+            std::vector<UserId> users;
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto user = exchange.create_user("shared-" + std::to_string(i));
+                ASSERT_TRUE(user.has_value());
+                users.push_back(*user);
+                ASSERT_TRUE(exchange.deposit(*user, usdt, kInitialQuote).has_value());
+                ASSERT_TRUE(exchange.deposit(*user, btc, kInitialBase).has_value());
+            }
+
+            std::atomic<bool> ok{true};
+            std::vector<std::thread> threads;
+            threads.reserve(kThreads);
+            ThreadStartGate start_gate{kThreads};
+            TimeoutAbortGuard guard(std::chrono::milliseconds(8000));
+
+            for (int t = 0; t < kThreads; ++t)
+            {
+                const UserId user_id = users[static_cast<std::size_t>(t) % users.size()];
+                const Side side = (t / 2) % 2 == 0 ? Side::Buy : Side::Sell;
+                threads.emplace_back([&exchange, &market, &start_gate, &ok, user_id, side]() {
+                    start_gate.worker_ready_and_wait();
+                    for (int i = 0; i < kIterations; ++i)
+                    {
+                        if (!exchange.place_limit_order(user_id, market, side, kPrice, 1).has_value())
+                        {
+                            ok.store(false, std::memory_order_release);
+                            return;
+                        }
+                    }
+                });
+            }
+
+            start_gate.release_workers();
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+            ASSERT_TRUE(ok.load(std::memory_order_acquire));
+
+            vertex::core::Quantity total_quote = 0;
+            vertex::core::Quantity total_base = 0;
+            for (const UserId user_id : users)
+            {
+                for (const Asset &asset : {usdt, btc})
+                {
+                    const auto free = exchange.free_balance(user_id, asset);
+                    const auto reserved = exchange.reserved_balance(user_id, asset);
+                    ASSERT_TRUE(free.has_value());
+                    ASSERT_TRUE(reserved.has_value());
+                    EXPECT_GE(*free, 0);
+                    EXPECT_GE(*reserved, 0);
+                    (asset == usdt ? total_quote : total_base) += *free + *reserved;
+                }
+            }
+            EXPECT_EQ(total_quote, 2 * kInitialQuote);
+            EXPECT_EQ(total_base, 2 * kInitialBase);
+
+            expect_no_orphan_orders(exchange, {market});
+        }
+    }
+} // namespace
+
+TEST(ExchangeConcurrencyTest, AtomicWalletModeConservesBalancesWhenSharedUsersCross)
+{
+    expect_shared_users_conserve_balances(WalletMode::Atomic);
+}
+
+TEST(ExchangeConcurrencyTest, PartitionedLedgerModeConservesBalancesWhenSharedUsersCross)
+{
+    expect_shared_users_conserve_balances(WalletMode::Partitioned);
+}
+
+namespace
+{
+    // A maker cancels its order while takers fill it, and a taker's resting
+    // remainder is filled by another thread while the taker is still
+    // settling. Either close can land before the other thread draws its
+    // fill share; no funds may be lost and no order meta may linger.
+    void expect_fills_racing_closes_settle(WalletMode wallet_mode)
+    {
+        constexpr int kIterations = 2000;
+        constexpr int kPrice = 100;
+        constexpr vertex::core::Quantity kInitialQuote = 2 * kPrice * kIterations;
+        constexpr vertex::core::Quantity kInitialBase = 2 * kIterations + 10;
+
+        Exchange exchange{ExchangeConfig{.wallet_mode = wallet_mode}};
+        const Market market = btc_usdt();
+        const Asset btc{"btc"};
+        const Asset usdt{"usdt"};
+        ASSERT_TRUE(exchange.register_market(market).has_value());
+
+        const auto maker_result = exchange.create_user("maker-close-race");
+        const auto taker_result = exchange.create_user("taker-close-race");
+        const auto crosser_result = exchange.create_user("crosser-close-race");
+        ASSERT_TRUE(maker_result.has_value());
+        ASSERT_TRUE(taker_result.has_value());
+        ASSERT_TRUE(crosser_result.has_value());
+        const UserId maker = *maker_result;
+        const UserId taker = *taker_result;
+        const UserId crosser = *crosser_result;
+        const std::vector<UserId> users{maker, taker, crosser};
+
+        ASSERT_TRUE(exchange.deposit(maker, btc, kInitialBase).has_value());
+        ASSERT_TRUE(exchange.deposit(crosser, btc, kInitialBase).has_value());
+        ASSERT_TRUE(exchange.deposit(taker, usdt, kInitialQuote).has_value());
+
+        std::atomic<bool> ok{true};
+        std::vector<OrderId> taker_orders;
+        std::vector<OrderId> crosser_orders;
+        taker_orders.reserve(kIterations);
+        crosser_orders.reserve(kIterations);
+        ThreadStartGate start_gate{3};
+        TimeoutAbortGuard guard(std::chrono::milliseconds(20000));
+
+        std::thread maker_thread([&]() {
+            start_gate.worker_ready_and_wait();
+            for (int i = 0; i < kIterations; ++i)
+            {
+                const auto placed = exchange.place_limit_order(maker, market, Side::Sell, kPrice, 10);
+                if (!placed.has_value())
+                {
+                    ok.store(false, std::memory_order_release);
+                    return;
+                }
+                const auto canceled = exchange.cancel_order(maker, placed->order_id);
+                if (!canceled.has_value() && canceled.error() != CancelOrderError::OrderNotFound)
+                {
+                    ok.store(false, std::memory_order_release);
+                    return;
+                }
+            }
+        });
+
+        // Buys 2 so that a partly filled taker leaves a remainder on the book.
+        std::thread taker_thread([&]() {
+            start_gate.worker_ready_and_wait();
+            for (int i = 0; i < kIterations; ++i)
+            {
+                const auto placed = exchange.place_limit_order(taker, market, Side::Buy, kPrice, 2);
+                if (!placed.has_value())
+                {
+                    ok.store(false, std::memory_order_release);
+                    return;
+                }
+                taker_orders.push_back(placed->order_id);
+            }
+        });
+
+        std::thread crosser_thread([&]() {
+            start_gate.worker_ready_and_wait();
+            for (int i = 0; i < kIterations; ++i)
+            {
+                const auto placed = exchange.place_limit_order(crosser, market, Side::Sell, kPrice, 1);
+                if (!placed.has_value())
+                {
+                    ok.store(false, std::memory_order_release);
+                    return;
+                }
+                crosser_orders.push_back(placed->order_id);
+            }
+        });
+
+        start_gate.release_workers();
+        maker_thread.join();
+        taker_thread.join();
+        crosser_thread.join();
+        ASSERT_TRUE(ok.load(std::memory_order_acquire));
+
+        for (const auto &[user_id, order_ids] : {std::pair{taker, &taker_orders}, std::pair{crosser, &crosser_orders}})
+        {
+            for (const OrderId order_id : *order_ids)
+            {
+                const auto canceled = exchange.cancel_order(user_id, order_id);
+                if (!canceled.has_value())
+                    EXPECT_EQ(canceled.error(), CancelOrderError::OrderNotFound);
+            }
+        }
+
+        vertex::core::Quantity total_quote = 0;
+        vertex::core::Quantity total_base = 0;
+        for (const UserId user_id : users)
+        {
+            for (const Asset &asset : {usdt, btc})
+            {
+                const auto free = exchange.free_balance(user_id, asset);
+                const auto reserved = exchange.reserved_balance(user_id, asset);
+                ASSERT_TRUE(free.has_value());
+                ASSERT_TRUE(reserved.has_value());
+                EXPECT_GE(*free, 0);
+                EXPECT_EQ(*reserved, 0);
+                (asset == usdt ? total_quote : total_base) += *free + *reserved;
+            }
+        }
+        EXPECT_EQ(total_quote, kInitialQuote);
+        EXPECT_EQ(total_base, 2 * kInitialBase);
+        EXPECT_TRUE(ExchangeTestAccess::order_meta_snapshot(exchange).empty());
+    }
+} // namespace
+
+TEST(ExchangeConcurrencyTest, FillsRacingCancelAndCloseKeepFundsInLockedMode)
+{
+    expect_fills_racing_closes_settle(WalletMode::Locked);
+}
+
+TEST(ExchangeConcurrencyTest, FillsRacingCancelAndCloseKeepFundsInAtomicMode)
+{
+    expect_fills_racing_closes_settle(WalletMode::Atomic);
+}
+
+TEST(ExchangeConcurrencyTest, FillsRacingCancelAndCloseKeepFundsInPartitionedMode)
+{
+    expect_fills_racing_closes_settle(WalletMode::Partitioned);
+}
+
 TEST(ExchangeConcurrencyTest, MarketOrderAndCancelMixedPreservesReserveInvariants)
 {
     constexpr int kInitialOrders = 2000;
@@ -1103,3 +1342,117 @@ TEST(ExchangeConcurrencyTest, HighTrafficOnBtcUsdtDoesNotBreakEthUsdtFlow)
         expect_no_orphan_orders(exchange, {btc_usdt_market, eth_usdt_market});
     }
 }
+
+TEST(ExchangeConcurrencyTest, OverloadedPlacementsReleaseTheirReservations)
+{
+    constexpr int kThreads = 8;
+    constexpr int kOrdersPerThread = 400;
+    constexpr int kDeposit = kOrdersPerThread * 10;
+
+    Exchange exchange;
+    const Market market = btc_usdt();
+    const Asset usdt{"usdt"};
+
+    ASSERT_TRUE(exchange.register_market(market, MarketWorkerConfig{.queue_capacity = 1}).has_value());
+
+    std::vector<UserId> users;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        const auto user = exchange.create_user("bidder-" + std::to_string(t));
+        ASSERT_TRUE(user.has_value());
+        ASSERT_TRUE(exchange.deposit(*user, usdt, kDeposit).has_value());
+        users.push_back(*user);
+    }
+
+    std::atomic<bool> ok{true};
+    std::atomic<int> overloaded{0};
+    std::vector<int> accepted(kThreads, 0);
+    ThreadStartGate start_gate{kThreads};
+    TimeoutAbortGuard guard(std::chrono::milliseconds(8000));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            start_gate.worker_ready_and_wait();
+            for (int i = 0; i < kOrdersPerThread; ++i)
+            {
+                // Bids only: nothing matches, so every accepted order stays reserved.
+                const auto place = exchange.place_limit_order(users[t], market, Side::Buy, 10, 1);
+                if (place.has_value())
+                    ++accepted[t];
+                else if (place.error() == PlaceOrderError::Overloaded)
+                    overloaded.fetch_add(1, std::memory_order_relaxed);
+                else
+                    ok.store(false, std::memory_order_release);
+            }
+        });
+    }
+
+    start_gate.release_workers();
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_TRUE(ok.load(std::memory_order_acquire));
+    for (int t = 0; t < kThreads; ++t)
+    {
+        const auto reserved = exchange.reserved_balance(users[t], usdt);
+        const auto free = exchange.free_balance(users[t], usdt);
+        ASSERT_TRUE(reserved.has_value());
+        ASSERT_TRUE(free.has_value());
+        EXPECT_EQ(*reserved, static_cast<vertex::core::Quantity>(accepted[t] * 10));
+        EXPECT_EQ(*free + *reserved, static_cast<vertex::core::Quantity>(kDeposit));
+    }
+    EXPECT_EQ(
+        ExchangeTestAccess::order_meta_snapshot(exchange).size(),
+        static_cast<std::size_t>(kThreads * kOrdersPerThread - overloaded.load()));
+}
+
+TEST(ExchangeConcurrencyTest, ConcurrentCreateUserIssuesDenseIdsWhileReadersLookUp)
+{
+    constexpr int kThreads = 8;
+    constexpr int kUsersPerThread = 500;
+    Exchange exchange;
+
+    std::atomic<bool> done{false};
+    std::atomic<int> unreadable{0};
+    std::thread reader([&]
+                       {
+                           while (!done.load(std::memory_order_acquire))
+                           {
+                               // Id 1 exists once the first create_user returned; ids past the table are unknown.
+                               if (exchange.user_exists(UserId{1}) && !exchange.get_user_name(UserId{1}).has_value())
+                                   unreadable.fetch_add(1);
+                               EXPECT_FALSE(exchange.user_exists(UserId{kThreads * kUsersPerThread + 1}));
+                           } });
+
+    std::vector<std::vector<UserId>> created(kThreads);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        writers.emplace_back([&, t]
+                             {
+                                 for (int i = 0; i < kUsersPerThread; ++i)
+                                     created[t].push_back(exchange.create_user("user_" + std::to_string(t) + "_" + std::to_string(i)).value());
+                             });
+    }
+    for (auto &writer : writers)
+        writer.join();
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    std::vector<std::uint64_t> ids;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        for (int i = 0; i < kUsersPerThread; ++i)
+        {
+            ids.push_back(created[t][i].get_value());
+            EXPECT_EQ(exchange.get_user_name(created[t][i]).value(), "user_" + std::to_string(t) + "_" + std::to_string(i));
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    for (std::size_t i = 0; i < ids.size(); ++i)
+        EXPECT_EQ(ids[i], i + 1);
+    EXPECT_EQ(unreadable.load(), 0);
+    EXPECT_FALSE(exchange.user_exists(UserId{}));
+}
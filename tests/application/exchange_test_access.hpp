@@ -13,6 +13,11 @@ namespace vertex::application
             return OrderMetaStoreTestAccess::snapshot(exchange.order_meta_store_);
         }
 
+        static std::optional<Quantity> order_reserved_remaining(const Exchange &exchange, OrderId id)
+        {
+            return exchange.order_meta_store_.reserved_remaining(id);
+        }
+
         static std::optional<OrderRecord> order_history_find(const Exchange &exchange, OrderId id)
         {
             return exchange.order_history_.find(id);
@@ -22,5 +27,10 @@ namespace vertex::application
         {
             return exchange.order_history_.find_by_user(user_id);
         }
+
+        static const Account *account(const Exchange &exchange, UserId user_id)
+        {
+            return exchange.get_account(user_id);
+        }
     };
 } // namespace vertex::application
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+
 #include "tests/application/exchange_test_access.hpp"
 #include "vertex/application/exchange.hpp"
 
@@ -16,6 +18,8 @@ namespace
     using vertex::application::WalletOperationError;
     using vertex::core::Asset;
     using vertex::core::Market;
+    using vertex::core::MarketId;
+    using vertex::core::MarketSpec;
     using vertex::core::Side;
     using vertex::core::UserId;
 
@@ -39,6 +43,28 @@ TEST(ExchangeTest, CreateUserAndReadName)
     EXPECT_TRUE(exchange.user_exists(user_id));
 }
 
+TEST(ExchangeTest, AccountsStartOnSeparateCacheLines)
+{
+    constexpr std::size_t kLine = vertex::core::kCacheLineSize;
+    Exchange exchange;
+
+    std::vector<const vertex::application::Account *> accounts;
+    for (int i = 0; i < 8; ++i)
+        accounts.push_back(ExchangeTestAccess::account(exchange, exchange.create_user("user_" + std::to_string(i)).value()));
+
+    for (std::size_t i = 0; i < accounts.size(); ++i)
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(accounts[i]);
+        EXPECT_EQ(address % kLine, 0u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&accounts[i]->mu) / kLine, address / kLine);
+        if (i > 0)
+        {
+            EXPECT_GE(address - reinterpret_cast<std::uintptr_t>(accounts[i - 1]), sizeof(vertex::application::Account));
+        }
+    }
+    EXPECT_EQ(exchange.get_user_name(UserId{8}).value(), "user_7");
+}
+
 TEST(ExchangeTest, CreateUserRejectsEmptyName)
 {
     Exchange exchange;
@@ -97,6 +123,31 @@ TEST(ExchangeTest, RegisterMarketAllowsFirstThenRejectsDuplicate)
     ASSERT_TRUE(first.has_value());
     ASSERT_FALSE(second.has_value());
     EXPECT_EQ(second.error(), RegisterMarketError::AlreadyListed);
+    EXPECT_EQ(exchange.find_market_id(btc_usdt()), *first);
+}
+
+TEST(ExchangeTest, MarketIdOverloadsMatchAndRejectUnknownId)
+{
+    Exchange exchange;
+    const auto market_id = exchange.register_market(btc_usdt());
+    ASSERT_TRUE(market_id.has_value());
+
+    const UserId buyer = *exchange.create_user("buyer");
+    const UserId seller = *exchange.create_user("seller");
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 1000).has_value());
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 10).has_value());
+
+    const auto unknown = exchange.place_limit_order(buyer, MarketId{market_id->get_value() + 1}, Side::Buy, 100, 1);
+    ASSERT_FALSE(unknown.has_value());
+    EXPECT_EQ(unknown.error(), PlaceOrderError::MarketNotListed);
+
+    ASSERT_TRUE(exchange.place_limit_order(seller, *market_id, Side::Sell, 100, 2).has_value());
+    const auto bought = exchange.execute_market_order(buyer, *market_id, Side::Buy, 200);
+    ASSERT_TRUE(bought.has_value());
+    EXPECT_EQ(bought->filled_quantity, 200);
+
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), 2);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"usdt"}).value(), 200);
 }
 
 TEST(ExchangeTest, PlaceLimitOrderValidatesInputs)
@@ -126,6 +177,73 @@ TEST(ExchangeTest, PlaceLimitOrderValidatesInputs)
     EXPECT_EQ(bad_price.error(), PlaceOrderError::InvalidAmount);
 }
 
+TEST(ExchangeTest, PlaceLimitBuyRejectsNotionalOverflowWithoutReserving)
+{
+    Exchange exchange;
+    // Coarse ticks and lots so 10^10 is a legal price and quantity.
+    ASSERT_TRUE(exchange.register_market(btc_usdt(), MarketSpec{.tick_size = 1'000, .lot_size = 1'000, .max_price = 1'000'000'000'000}).has_value());
+    const auto user_result = exchange.create_user("whale");
+    ASSERT_TRUE(user_result.has_value());
+    const UserId user_id = *user_result;
+    ASSERT_TRUE(exchange.deposit(user_id, Asset{"usdt"}, 1'000'000).has_value());
+
+    // 10^10 * 10^10 wraps int64; it must not turn into a small reservation.
+    const auto result = exchange.place_limit_order(user_id, btc_usdt(), Side::Buy, 10'000'000'000, 10'000'000'000);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), PlaceOrderError::NotionalOverflow);
+
+    const auto reserved = exchange.reserved_balance(user_id, Asset{"usdt"});
+    ASSERT_TRUE(reserved.has_value());
+    EXPECT_EQ(*reserved, 0);
+}
+
+TEST(ExchangeTest, OrdersOffTheMarketSpecAreRejectedWithoutReserving)
+{
+    Exchange exchange;
+    const MarketSpec spec{.tick_size = 5, .lot_size = 10, .min_price = 50, .max_price = 500};
+    ASSERT_TRUE(exchange.register_market(btc_usdt(), spec).has_value());
+    const auto user_result = exchange.create_user("dana");
+    ASSERT_TRUE(user_result.has_value());
+    const UserId user_id = *user_result;
+    ASSERT_TRUE(exchange.deposit(user_id, Asset{"usdt"}, 100'000).has_value());
+    ASSERT_TRUE(exchange.deposit(user_id, Asset{"btc"}, 100).has_value());
+
+    const auto off_tick = exchange.place_limit_order(user_id, btc_usdt(), Side::Buy, 102, 10);
+    ASSERT_FALSE(off_tick.has_value());
+    EXPECT_EQ(off_tick.error(), PlaceOrderError::PriceNotOnTick);
+
+    const auto out_of_band = exchange.place_limit_order(user_id, btc_usdt(), Side::Buy, 505, 10);
+    ASSERT_FALSE(out_of_band.has_value());
+    EXPECT_EQ(out_of_band.error(), PlaceOrderError::PriceOutOfBand);
+
+    const auto off_lot = exchange.place_limit_order(user_id, btc_usdt(), Side::Buy, 100, 15);
+    ASSERT_FALSE(off_lot.has_value());
+    EXPECT_EQ(off_lot.error(), PlaceOrderError::QuantityNotOnLot);
+
+    const auto market_sell_off_lot = exchange.execute_market_order(user_id, btc_usdt(), Side::Sell, 15);
+    ASSERT_FALSE(market_sell_off_lot.has_value());
+    EXPECT_EQ(market_sell_off_lot.error(), PlaceOrderError::QuantityNotOnLot);
+
+    EXPECT_EQ(exchange.reserved_balance(user_id, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.reserved_balance(user_id, Asset{"btc"}).value(), 0);
+
+    const auto on_grid = exchange.place_limit_order(user_id, btc_usdt(), Side::Buy, 100, 20);
+    ASSERT_TRUE(on_grid.has_value());
+    EXPECT_EQ(on_grid->remaining_quantity, 20);
+    EXPECT_EQ(exchange.reserved_balance(user_id, Asset{"usdt"}).value(), 2'000);
+}
+
+TEST(ExchangeTest, RegisterMarketRejectsInvalidSpec)
+{
+    Exchange exchange;
+
+    const auto result = exchange.register_market(btc_usdt(), MarketSpec{.tick_size = 5, .max_price = 502});
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), RegisterMarketError::InvalidSpec);
+    EXPECT_FALSE(exchange.find_market_id(btc_usdt()).has_value());
+}
+
 TEST(ExchangeTest, PlaceLimitOrderRejectsWhenInsufficientFunds)
 {
     Exchange exchange;
@@ -405,6 +523,7 @@ TEST(ExchangeTest, CancelAfterPartialFillReleasesOnlyRemainingReservation)
     ASSERT_TRUE(seller_btc_reserved_before_cancel.has_value());
     EXPECT_EQ(*seller_btc_free_before_cancel, 5);
     EXPECT_EQ(*seller_btc_reserved_before_cancel, 3);
+    EXPECT_EQ(ExchangeTestAccess::order_reserved_remaining(exchange, resting_sell->order_id), 3);
 
     const auto cancel_result = exchange.cancel_order(seller_id, resting_sell->order_id);
     ASSERT_TRUE(cancel_result.has_value());
@@ -625,3 +744,273 @@ TEST(ExchangeTest, ExecuteMarketSellSettlesQuoteAndReleasesUnfilledBaseRemainder
     EXPECT_EQ(taker_record->fill_count, 2);
     ASSERT_EQ(taker_record->trade_ids.size(), 2U);
 }
+
+TEST(ExchangeTest, PooledMarketSchedulingMatchesAndSettles)
+{
+    Exchange exchange{vertex::engine::MarketDispatcherConfig{.pool_threads = 2}};
+    const Market eth_usdt{Asset{"eth"}, Asset{"usdt"}};
+    ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+    ASSERT_TRUE(exchange.register_market(eth_usdt).has_value());
+
+    const auto seller_result = exchange.create_user("seller");
+    const auto buyer_result = exchange.create_user("buyer");
+    ASSERT_TRUE(seller_result.has_value());
+    ASSERT_TRUE(buyer_result.has_value());
+    const UserId seller_id = *seller_result;
+    const UserId buyer_id = *buyer_result;
+
+    ASSERT_TRUE(exchange.deposit(seller_id, Asset{"btc"}, 3).has_value());
+    ASSERT_TRUE(exchange.deposit(buyer_id, Asset{"usdt"}, 1000).has_value());
+
+    ASSERT_TRUE(exchange.place_limit_order(seller_id, btc_usdt(), Side::Sell, 100, 3).has_value());
+    const auto buy = exchange.place_limit_order(buyer_id, btc_usdt(), Side::Buy, 100, 2);
+    ASSERT_TRUE(buy.has_value());
+    EXPECT_EQ(buy->filled_quantity, 2);
+    EXPECT_EQ(buy->remaining_quantity, 0);
+
+    const auto eth_bid = exchange.place_limit_order(buyer_id, eth_usdt, Side::Buy, 50, 1);
+    ASSERT_TRUE(eth_bid.has_value());
+    EXPECT_TRUE(exchange.cancel_order(buyer_id, eth_bid->order_id).has_value());
+
+    EXPECT_EQ(exchange.free_balance(buyer_id, Asset{"btc"}).value(), 2);
+    EXPECT_EQ(exchange.free_balance(buyer_id, Asset{"usdt"}).value(), 800);
+    EXPECT_EQ(exchange.reserved_balance(buyer_id, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.free_balance(seller_id, Asset{"usdt"}).value(), 200);
+    EXPECT_EQ(exchange.reserved_balance(seller_id, Asset{"btc"}).value(), 1);
+}
+
+TEST(ExchangeTest, SweepSettlesEachCounterpartyOnceAcrossItsOrders)
+{
+    for (const auto wallet_mode : {vertex::application::WalletMode::Locked,
+                                   vertex::application::WalletMode::Atomic,
+                                   vertex::application::WalletMode::Partitioned})
+    {
+        Exchange exchange{vertex::application::ExchangeConfig{.wallet_mode = wallet_mode}};
+        ASSERT_TRUE(exchange.register_market(btc_usdt()).has_value());
+
+        const UserId maker_a = exchange.create_user("maker_a").value();
+        const UserId maker_b = exchange.create_user("maker_b").value();
+        const UserId taker = exchange.create_user("taker").value();
+        ASSERT_TRUE(exchange.deposit(maker_a, Asset{"btc"}, 3).has_value());
+        ASSERT_TRUE(exchange.deposit(maker_b, Asset{"btc"}, 1).has_value());
+        ASSERT_TRUE(exchange.deposit(maker_b, Asset{"usdt"}, 185).has_value());
+        ASSERT_TRUE(exchange.deposit(taker, Asset{"usdt"}, 1000).has_value());
+
+        ASSERT_TRUE(exchange.place_limit_order(maker_a, btc_usdt(), Side::Sell, 100, 2).has_value());
+        ASSERT_TRUE(exchange.place_limit_order(maker_b, btc_usdt(), Side::Sell, 102, 1).has_value());
+        ASSERT_TRUE(exchange.place_limit_order(maker_a, btc_usdt(), Side::Sell, 101, 1).has_value());
+
+        // Fills 2@100 and 1@101 from maker_a, 1@102 from maker_b; 17 of improvement comes back.
+        const auto buy = exchange.place_limit_order(taker, btc_usdt(), Side::Buy, 105, 4);
+        ASSERT_TRUE(buy.has_value());
+        EXPECT_EQ(buy->filled_quantity, 4);
+
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"usdt"}).value(), 597);
+        EXPECT_EQ(exchange.reserved_balance(taker, Asset{"usdt"}).value(), 0);
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"btc"}).value(), 4);
+        EXPECT_EQ(exchange.free_balance(maker_a, Asset{"usdt"}).value(), 301);
+        EXPECT_EQ(exchange.reserved_balance(maker_a, Asset{"btc"}).value(), 0);
+        EXPECT_EQ(exchange.free_balance(maker_b, Asset{"usdt"}).value(), 287);
+        EXPECT_EQ(exchange.reserved_balance(maker_b, Asset{"btc"}).value(), 0);
+
+        // Two bids of maker_b settle as one pair against a market sell.
+        ASSERT_TRUE(exchange.place_limit_order(maker_b, btc_usdt(), Side::Buy, 90, 1).has_value());
+        ASSERT_TRUE(exchange.place_limit_order(maker_b, btc_usdt(), Side::Buy, 95, 1).has_value());
+        const auto sell = exchange.execute_market_order(taker, btc_usdt(), Side::Sell, 2);
+        ASSERT_TRUE(sell.has_value());
+        EXPECT_EQ(sell->filled_quantity, 2);
+
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"usdt"}).value(), 782);
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"btc"}).value(), 2);
+        EXPECT_EQ(exchange.reserved_balance(taker, Asset{"btc"}).value(), 0);
+        EXPECT_EQ(exchange.free_balance(maker_b, Asset{"btc"}).value(), 2);
+        EXPECT_EQ(exchange.free_balance(maker_b, Asset{"usdt"}).value(), 102);
+        EXPECT_EQ(exchange.reserved_balance(maker_b, Asset{"usdt"}).value(), 0);
+    }
+}
+
+TEST(ExchangeTest, SettlementStageSettlesBlockingOrdersAndCancels)
+{
+    Exchange exchange;
+    const auto market_id = exchange.register_market(btc_usdt(), vertex::engine::MarketWorkerConfig{.settlement_stage = true});
+    ASSERT_TRUE(market_id.has_value());
+
+    const UserId seller = exchange.create_user("seller").value();
+    const UserId buyer = exchange.create_user("buyer").value();
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 5).has_value());
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 1000).has_value());
+
+    const auto ask = exchange.place_limit_order(seller, *market_id, Side::Sell, 100, 3);
+    ASSERT_TRUE(ask.has_value());
+    const auto buy = exchange.place_limit_order(buyer, *market_id, Side::Buy, 110, 2);
+    ASSERT_TRUE(buy.has_value());
+    EXPECT_EQ(buy->filled_quantity, 2);
+
+    const auto market_buy = exchange.execute_market_order(buyer, *market_id, Side::Buy, 150);
+    ASSERT_TRUE(market_buy.has_value());
+    EXPECT_EQ(market_buy->filled_quantity, 100);
+
+    const auto bid = exchange.place_limit_order(buyer, *market_id, Side::Buy, 90, 2);
+    ASSERT_TRUE(bid.has_value());
+    ASSERT_TRUE(exchange.cancel_order(buyer, bid->order_id).has_value());
+
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), 3);
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"usdt"}).value(), 700);
+    EXPECT_EQ(exchange.reserved_balance(buyer, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"usdt"}).value(), 300);
+    EXPECT_EQ(exchange.reserved_balance(seller, Asset{"btc"}).value(), 0);
+}
+
+TEST(ExchangeTest, SubLedgerMarketTradesWithoutTouchingTheMainWallet)
+{
+    Exchange exchange;
+    const auto market_id = exchange.register_market(btc_usdt(), vertex::application::MarketWorkerConfig{.sub_ledger = true});
+    ASSERT_TRUE(market_id.has_value());
+    const MarketId plain_market = exchange.register_market(Market{Asset{"eth"}, Asset{"usdt"}}).value();
+
+    const UserId buyer = exchange.create_user("buyer").value();
+    const UserId seller = exchange.create_user("seller").value();
+    ASSERT_TRUE(exchange.deposit(buyer, Asset{"usdt"}, 1000).has_value());
+    ASSERT_TRUE(exchange.deposit(seller, Asset{"btc"}, 5).has_value());
+
+    EXPECT_EQ(exchange.allocate_to_market(buyer, *market_id, Asset{"eth"}, 1).error(), WalletOperationError::AssetNotInMarket);
+    EXPECT_EQ(exchange.allocate_to_market(buyer, plain_market, Asset{"usdt"}, 1).error(), WalletOperationError::MarketNotFound);
+    EXPECT_EQ(exchange.allocate_to_market(buyer, *market_id, Asset{"usdt"}, 2000).error(), WalletOperationError::InsufficientFunds);
+
+    ASSERT_TRUE(exchange.allocate_to_market(buyer, *market_id, Asset{"usdt"}, 400).has_value());
+    ASSERT_TRUE(exchange.allocate_to_market(seller, *market_id, Asset{"btc"}, 3).has_value());
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"usdt"}).value(), 600);
+
+    // Main-wallet funds do not back orders on this market.
+    EXPECT_EQ(exchange.place_limit_order(buyer, *market_id, Side::Buy, 100, 5).error(), PlaceOrderError::InsufficientFunds);
+
+    const auto resting = exchange.place_limit_order(seller, *market_id, Side::Sell, 100, 3);
+    ASSERT_TRUE(resting.has_value());
+    const auto buy = exchange.place_limit_order(buyer, *market_id, Side::Buy, 110, 2);
+    ASSERT_TRUE(buy.has_value());
+    EXPECT_EQ(buy->filled_quantity, 2);
+
+    const auto bought = exchange.execute_market_order(buyer, *market_id, Side::Buy, 150);
+    ASSERT_TRUE(bought.has_value());
+    EXPECT_EQ(bought->filled_quantity, 100);
+
+    const auto bid = exchange.place_limit_order(buyer, *market_id, Side::Buy, 50, 1);
+    ASSERT_TRUE(bid.has_value());
+    EXPECT_EQ(exchange.market_balance(buyer, *market_id).value().quote_reserved, 50);
+    ASSERT_TRUE(exchange.cancel_order(buyer, bid->order_id).has_value());
+
+    auto buyer_balance = exchange.market_balance(buyer, *market_id).value();
+    EXPECT_EQ(buyer_balance.quote_free, 100);
+    EXPECT_EQ(buyer_balance.quote_reserved, 0);
+    EXPECT_EQ(buyer_balance.base_free, 3);
+    const auto seller_balance = exchange.market_balance(seller, *market_id).value();
+    EXPECT_EQ(seller_balance.quote_free, 300);
+    EXPECT_EQ(seller_balance.base_reserved, 0);
+
+    // Main wallets saw only the allocations.
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"usdt"}).value(), 600);
+    EXPECT_EQ(exchange.reserved_balance(buyer, Asset{"usdt"}).value(), 0);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"btc"}).value(), 2);
+
+    EXPECT_EQ(exchange.return_from_market(buyer, *market_id, Asset{"btc"}, 4).error(), WalletOperationError::InsufficientFunds);
+    ASSERT_TRUE(exchange.return_from_market(buyer, *market_id, Asset{"btc"}, 3).has_value());
+    ASSERT_TRUE(exchange.return_from_market(seller, *market_id, Asset{"usdt"}, 300).has_value());
+    EXPECT_EQ(exchange.free_balance(buyer, Asset{"btc"}).value(), 3);
+    EXPECT_EQ(exchange.free_balance(seller, Asset{"usdt"}).value(), 300);
+    EXPECT_EQ(exchange.market_balance(buyer, *market_id).value().base_free, 0);
+}
+
+TEST(ExchangeTest, SubLedgerMovesThatDoNotFitLeaveTheFundsWhereTheyWere)
+{
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+
+    for (const auto wallet_mode : {vertex::application::WalletMode::Locked,
+                                   vertex::application::WalletMode::Atomic,
+                                   vertex::application::WalletMode::Partitioned})
+    {
+        Exchange exchange{vertex::application::ExchangeConfig{.wallet_mode = wallet_mode}};
+        const auto market_id = exchange.register_market(btc_usdt(), vertex::application::MarketWorkerConfig{.sub_ledger = true});
+        ASSERT_TRUE(market_id.has_value());
+
+        const UserId whale = exchange.create_user("whale").value();
+        const UserId user = exchange.create_user("user").value();
+        ASSERT_TRUE(exchange.deposit(whale, Asset{"usdt"}, kMax).has_value());
+        ASSERT_TRUE(exchange.deposit(user, Asset{"usdt"}, 100).has_value());
+
+        // The market's usdt total has no room left, so the credit is refused.
+        ASSERT_TRUE(exchange.allocate_to_market(whale, *market_id, Asset{"usdt"}, kMax - 50).has_value());
+        EXPECT_EQ(exchange.allocate_to_market(user, *market_id, Asset{"usdt"}, 100).error(), WalletOperationError::BalanceOverflow);
+        EXPECT_EQ(exchange.free_balance(user, Asset{"usdt"}).value(), 100);
+        EXPECT_EQ(exchange.reserved_balance(user, Asset{"usdt"}).value(), 0);
+
+        // The whale's wallet refills to the maximum, so the return cannot land.
+        ASSERT_TRUE(exchange.deposit(whale, Asset{"usdt"}, kMax - 50).has_value());
+        EXPECT_EQ(exchange.return_from_market(whale, *market_id, Asset{"usdt"}, 100).error(), WalletOperationError::BalanceOverflow);
+        const auto whale_balance = exchange.market_balance(whale, *market_id).value();
+        EXPECT_EQ(whale_balance.quote_free, kMax - 50);
+        EXPECT_EQ(whale_balance.quote_reserved, 0);
+        EXPECT_EQ(exchange.free_balance(whale, Asset{"usdt"}).value(), kMax);
+    }
+}
+
+
+TEST(ExchangeTest, PlaceLimitOrdersBatchesPerMarketAndReportsEachOrder)
+{
+    using vertex::application::LimitOrderEntry;
+
+    for (const auto wallet_mode : {vertex::application::WalletMode::Locked,
+                                   vertex::application::WalletMode::Atomic,
+                                   vertex::application::WalletMode::Partitioned})
+    {
+        Exchange exchange{vertex::application::ExchangeConfig{.wallet_mode = wallet_mode}};
+        const MarketId btc = exchange.register_market(btc_usdt()).value();
+        const MarketId eth =
+            exchange.register_market(Market{Asset{"eth"}, Asset{"usdt"}}, vertex::engine::MarketWorkerConfig{.settlement_stage = true}).value();
+
+        const UserId maker = exchange.create_user("maker").value();
+        const UserId taker = exchange.create_user("taker").value();
+        ASSERT_TRUE(exchange.deposit(maker, Asset{"btc"}, 10).has_value());
+        ASSERT_TRUE(exchange.deposit(maker, Asset{"eth"}, 10).has_value());
+        ASSERT_TRUE(exchange.deposit(taker, Asset{"usdt"}, 1000).has_value());
+
+        const std::vector<LimitOrderEntry> orders{
+            {maker, btc, Side::Sell, 100, 2},
+            {maker, btc, Side::Sell, 101, 2},
+            {maker, eth, Side::Sell, 50, 3},
+            // Crosses both earlier asks: 2@100 and 1@101, 2 of improvement freed.
+            {taker, btc, Side::Buy, 101, 3},
+            {taker, btc, Side::Buy, 100, 0},
+            // 1500 against the 697 left after the order above.
+            {taker, eth, Side::Buy, 50, 30},
+            {taker, eth, Side::Buy, 50, 2},
+            {taker, MarketId{99}, Side::Buy, 50, 1},
+        };
+
+        const auto results = exchange.place_limit_orders(orders);
+        ASSERT_EQ(results.size(), orders.size());
+        ASSERT_TRUE(results[0].has_value());
+        EXPECT_EQ(results[0]->remaining_quantity, 2);
+        ASSERT_TRUE(results[2].has_value());
+        ASSERT_TRUE(results[3].has_value());
+        EXPECT_EQ(results[3]->filled_quantity, 3);
+        EXPECT_EQ(results[3]->remaining_quantity, 0);
+        EXPECT_EQ(results[4].error(), PlaceOrderError::InvalidQuantity);
+        EXPECT_EQ(results[5].error(), PlaceOrderError::InsufficientFunds);
+        ASSERT_TRUE(results[6].has_value());
+        EXPECT_EQ(results[6]->filled_quantity, 2);
+        EXPECT_EQ(results[7].error(), PlaceOrderError::MarketNotListed);
+
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"usdt"}).value(), 599);
+        EXPECT_EQ(exchange.reserved_balance(taker, Asset{"usdt"}).value(), 0);
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"btc"}).value(), 3);
+        EXPECT_EQ(exchange.free_balance(taker, Asset{"eth"}).value(), 2);
+        EXPECT_EQ(exchange.free_balance(maker, Asset{"usdt"}).value(), 401);
+        EXPECT_EQ(exchange.reserved_balance(maker, Asset{"btc"}).value(), 1);
+        EXPECT_EQ(exchange.reserved_balance(maker, Asset{"eth"}).value(), 1);
+        EXPECT_EQ(exchange.order_count_by_status(maker, OrderStatus::Filled).value(), 1u);
+        EXPECT_EQ(exchange.order_count_by_status(taker, OrderStatus::Filled).value(), 2u);
+
+        ASSERT_TRUE(exchange.cancel_order(maker, results[1]->order_id).has_value());
+        EXPECT_EQ(exchange.free_balance(maker, Asset{"btc"}).value(), 7);
+    }
+}
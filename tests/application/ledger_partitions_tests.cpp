@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "vertex/application/ledger_partitions.hpp"
+
+using vertex::application::LedgerPartitions;
+using vertex::core::UserId;
+
+TEST(LedgerPartitionsTest, MapsUsersRoundRobinOntoPartitions)
+{
+    LedgerPartitions ledger{3};
+    ASSERT_EQ(ledger.partition_count(), 3u);
+
+    EXPECT_EQ(ledger.partition_of(UserId{1}), 0u);
+    EXPECT_EQ(ledger.partition_of(UserId{3}), 2u);
+    EXPECT_EQ(ledger.partition_of(UserId{4}), 0u);
+}
+
+TEST(LedgerPartitionsTest, RunsPostedJobsInOrderBeforeALaterCall)
+{
+    LedgerPartitions ledger{2};
+    std::vector<int> seen;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ledger.post(1, [&seen, i]
+                    { seen.push_back(i); });
+    }
+    // The call queues behind the posts, so it observes all of them.
+    const auto size = ledger.call(1, [&seen]
+                                  { return seen.size(); });
+
+    EXPECT_EQ(size, 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(seen[static_cast<std::size_t>(i)], i);
+}
+
+TEST(LedgerPartitionsTest, CallRunsOnThePartitionThreadAndInlineFromIt)
+{
+    LedgerPartitions ledger{2};
+
+    const auto partition_thread = ledger.call(0, []
+                                              { return std::this_thread::get_id(); });
+    EXPECT_NE(partition_thread, std::this_thread::get_id());
+
+    // A nested call to the same partition would wait on itself without the inline path.
+    const int nested = ledger.call(0, [&ledger]
+                                   { return ledger.call(0, []
+                                                        { return 7; }); });
+    EXPECT_EQ(nested, 7);
+}
+
+TEST(LedgerPartitionsTest, DestructorDrainsPostedJobs)
+{
+    int ran = 0;
+    {
+        LedgerPartitions ledger{1};
+        for (int i = 0; i < 50; ++i)
+        {
+            ledger.post(0, [&ran]
+                        { ++ran; });
+        }
+    }
+    EXPECT_EQ(ran, 50);
+}
@@ -10,6 +10,7 @@ namespace
     using vertex::application::OrderType;
     using vertex::core::Asset;
     using vertex::core::Market;
+    using vertex::core::MarketId;
     using vertex::core::OrderId;
     using vertex::core::Side;
     using vertex::core::TradeId;
@@ -19,6 +20,8 @@ namespace
     {
         return Market{Asset{"btc"}, Asset{"usdt"}};
     }
+
+    const MarketId kBtcUsdtId{1};
 }
 
 TEST(OrderMetaStoreTest, TryInsertAndFindRoundTrip)
@@ -28,7 +31,7 @@ TEST(OrderMetaStoreTest, TryInsertAndFindRoundTrip)
     const OrderId order_id{1};
     const OrderMeta meta{
         .owner = UserId{10},
-        .market = btc_usdt(),
+        .market = kBtcUsdtId,
         .side = Side::Buy,
         .price = 100,
         .requested_base_qty = 5};
@@ -38,7 +41,7 @@ TEST(OrderMetaStoreTest, TryInsertAndFindRoundTrip)
     const auto found = store.find(order_id);
     ASSERT_TRUE(found.has_value());
     EXPECT_EQ(found->owner, UserId{10});
-    EXPECT_EQ(found->market, btc_usdt());
+    EXPECT_EQ(found->market, kBtcUsdtId);
     EXPECT_EQ(found->side, Side::Buy);
     EXPECT_EQ(found->price, 100);
     ASSERT_TRUE(found->requested_base_qty.has_value());
@@ -56,14 +59,14 @@ TEST(OrderMetaStoreTest, TryInsertDuplicateIdReturnsFalse)
 
     ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
                                              .owner = UserId{11},
-                                             .market = btc_usdt(),
+                                             .market = kBtcUsdtId,
                                              .side = Side::Sell,
                                              .price = 101,
                                              .requested_base_qty = 3}));
 
     EXPECT_FALSE(store.try_insert(order_id, OrderMeta{
                                                 .owner = UserId{12},
-                                                .market = btc_usdt(),
+                                                .market = kBtcUsdtId,
                                                 .side = Side::Buy,
                                                 .price = 102,
                                                 .requested_base_qty = 7}));
@@ -82,7 +85,7 @@ TEST(OrderMetaStoreTest, AppendFillUpdatesAggregatesAndTradeIds)
 
     ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
                                              .owner = UserId{13},
-                                             .market = btc_usdt(),
+                                             .market = kBtcUsdtId,
                                              .side = Side::Buy,
                                              .price = 100,
                                              .requested_base_qty = 10}));
@@ -107,6 +110,31 @@ TEST(OrderMetaStoreTest, AppendFillMissingOrderReturnsFalse)
     EXPECT_FALSE(store.append_fill(OrderId{999}, TradeId{1}, 1, 100));
 }
 
+TEST(OrderMetaStoreTest, DrawReservationSplitsOffStoredHandle)
+{
+    OrderMetaStore store;
+    vertex::domain::Balance slot{.free = 0, .reserved = 500};
+
+    const OrderId order_id{7};
+    ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
+                                               .owner = UserId{10},
+                                               .market = kBtcUsdtId,
+                                               .side = Side::Buy,
+                                               .price = 100,
+                                               .requested_base_qty = 5,
+                                               .reservation = {.slot = &slot, .remaining = 500}}));
+
+    const auto drawn = store.draw_reservation(order_id, 200);
+    ASSERT_TRUE(drawn.has_value());
+    EXPECT_EQ(drawn->remaining, 200);
+    ASSERT_NE(std::get_if<vertex::domain::Balance *>(&drawn->slot), nullptr);
+    EXPECT_EQ(*std::get_if<vertex::domain::Balance *>(&drawn->slot), &slot);
+    EXPECT_EQ(store.reserved_remaining(order_id), 300);
+
+    EXPECT_EQ(store.draw_reservation(OrderId{8}, 1), std::nullopt);
+    EXPECT_EQ(store.reserved_remaining(OrderId{8}), std::nullopt);
+}
+
 TEST(OrderMetaStoreTest, CloseAndExtractReturnsRecordAndErasesMeta)
 {
     OrderMetaStore store;
@@ -114,14 +142,14 @@ TEST(OrderMetaStoreTest, CloseAndExtractReturnsRecordAndErasesMeta)
 
     ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
                                              .owner = UserId{14},
-                                             .market = btc_usdt(),
+                                             .market = kBtcUsdtId,
                                              .side = Side::Sell,
                                              .price = 105,
                                              .requested_base_qty = 8}));
     ASSERT_TRUE(store.append_fill(order_id, TradeId{2001}, 3, 104));
     ASSERT_TRUE(store.append_fill(order_id, TradeId{2002}, 2, 105));
 
-    const auto extracted = store.close_and_extract(order_id, OrderStatus::Filled);
+    const auto extracted = store.close_and_extract(order_id, OrderStatus::Filled, btc_usdt());
     ASSERT_TRUE(extracted.has_value());
 
     EXPECT_EQ(extracted->id, order_id);
@@ -145,7 +173,40 @@ TEST(OrderMetaStoreTest, CloseAndExtractReturnsRecordAndErasesMeta)
     EXPECT_EQ(extracted->trade_ids[1], TradeId{2002});
 
     EXPECT_FALSE(store.find(order_id).has_value());
-    EXPECT_FALSE(store.close_and_extract(order_id, OrderStatus::Filled).has_value());
+    EXPECT_FALSE(store.close_and_extract(order_id, OrderStatus::Filled, btc_usdt()).has_value());
+}
+
+TEST(OrderMetaStoreTest, ClosedMetaKeepsUndrawnReservationUntilDrawn)
+{
+    OrderMetaStore store;
+    vertex::domain::Balance slot{.free = 0, .reserved = 500};
+
+    const OrderId order_id{9};
+    ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
+                                               .owner = UserId{16},
+                                               .market = kBtcUsdtId,
+                                               .side = Side::Buy,
+                                               .price = 100,
+                                               .requested_base_qty = 5,
+                                               .reservation = {.slot = &slot, .remaining = 500}}));
+
+    // Canceled while a 200 fill has not drawn yet.
+    ASSERT_TRUE(store.draw_reservation(order_id, 300).has_value());
+    ASSERT_TRUE(store.close_and_extract(order_id, OrderStatus::Canceled, btc_usdt()).has_value());
+
+    EXPECT_FALSE(store.find(order_id).has_value());
+    EXPECT_FALSE(store.append_fill(order_id, TradeId{3001}, 2, 100));
+    EXPECT_FALSE(store.close_and_extract(order_id, OrderStatus::Filled, btc_usdt()).has_value());
+    EXPECT_EQ(store.reserved_remaining(order_id), 200);
+
+    const auto drawn = store.draw_reservation(order_id, 200);
+    ASSERT_TRUE(drawn.has_value());
+    EXPECT_EQ(drawn->remaining, 200);
+    ASSERT_NE(std::get_if<vertex::domain::Balance *>(&drawn->slot), nullptr);
+    EXPECT_EQ(*std::get_if<vertex::domain::Balance *>(&drawn->slot), &slot);
+
+    EXPECT_EQ(store.reserved_remaining(order_id), std::nullopt);
+    EXPECT_EQ(store.draw_reservation(order_id, 1), std::nullopt);
 }
 
 TEST(OrderMetaStoreTest, CloseAndExtractWithoutFillsHasNoAveragePrice)
@@ -155,12 +216,12 @@ TEST(OrderMetaStoreTest, CloseAndExtractWithoutFillsHasNoAveragePrice)
 
     ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
                                              .owner = UserId{15},
-                                             .market = btc_usdt(),
+                                             .market = kBtcUsdtId,
                                              .side = Side::Buy,
                                              .price = 99,
                                              .requested_base_qty = 4}));
 
-    const auto extracted = store.close_and_extract(order_id, OrderStatus::Canceled);
+    const auto extracted = store.close_and_extract(order_id, OrderStatus::Canceled, btc_usdt());
     ASSERT_TRUE(extracted.has_value());
     EXPECT_EQ(extracted->status, OrderStatus::Canceled);
     EXPECT_EQ(extracted->executed_base_qty, 0);
@@ -177,7 +238,7 @@ TEST(OrderMetaStoreTest, EraseRemovesExistingOrder)
 
     ASSERT_TRUE(store.try_insert(order_id, OrderMeta{
                                              .owner = UserId{16},
-                                             .market = btc_usdt(),
+                                             .market = kBtcUsdtId,
                                              .side = Side::Sell,
                                              .price = 100,
                                              .requested_base_qty = 1}));
@@ -10,6 +10,7 @@ namespace
     using vertex::cli::CliApp;
     using vertex::cli::CreateUser;
     using vertex::cli::DepositDone;
+    using vertex::cli::FreeBalanceRead;
     using vertex::cli::GetUser;
     using vertex::cli::LimitOrderPlaced;
     using vertex::cli::MarketRegistered;
@@ -19,6 +20,7 @@ namespace
     using vertex::cli::UserCreated;
     using vertex::cli::UserRead;
     using vertex::cli::WalletDeposit;
+    using vertex::cli::WalletFreeBalance;
 
     std::uint64_t require_user_id(const vertex::cli::DispatchResult &result)
     {
@@ -115,3 +117,29 @@ TEST(CliAppTest, PlaceAndCancelOrderFlowReturnsExpectedResults)
     EXPECT_EQ(std::get<OrderCanceled>(cancel).order_id, order_id);
     EXPECT_EQ(std::get<OrderCanceled>(cancel).side, "Sell");
 }
+
+TEST(CliAppTest, QueriesOnUnknownAssetsAndMarketsDoNotInternNames)
+{
+    CliApp app;
+    const auto user_id = require_user_id(app.dispatch(CreateUser{.name = "alice"}));
+    const std::size_t interned = vertex::core::AssetRegistry::instance().size();
+
+    const auto balance = app.dispatch(WalletFreeBalance{.user_id = user_id, .asset = "NEVERSEEN"});
+    ASSERT_TRUE(std::holds_alternative<FreeBalanceRead>(balance));
+    EXPECT_EQ(std::get<FreeBalanceRead>(balance).free, 0);
+
+    const auto missing_user = app.dispatch(WalletFreeBalance{.user_id = user_id + 1000, .asset = "NEVERSEEN"});
+    ASSERT_TRUE(std::holds_alternative<AppError>(missing_user));
+    EXPECT_EQ(std::get<AppError>(missing_user).code, AppErrorCode::UserNotFound);
+
+    const auto order = app.dispatch(PlaceLimitOrder{
+        .user_id = user_id,
+        .market = "NOPEA/NOPEB",
+        .side = "buy",
+        .price = 1,
+        .quantity = 1});
+    ASSERT_TRUE(std::holds_alternative<AppError>(order));
+    EXPECT_EQ(std::get<AppError>(order).code, AppErrorCode::MarketNotListed);
+
+    EXPECT_EQ(vertex::core::AssetRegistry::instance().size(), interned);
+}
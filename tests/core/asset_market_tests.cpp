@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "vertex/core/types.hpp"
 
@@ -64,3 +67,78 @@ TEST(MarketTest, HashCanBeUsedInUnorderedSet)
     EXPECT_EQ(markets.size(), 2u);
     EXPECT_TRUE(markets.contains(vertex::core::Market{vertex::core::Asset{"eth"}, vertex::core::Asset{"usdt"}}));
 }
+
+TEST(AssetTest, InternsEachNameOnceWithDenseId)
+{
+    const vertex::core::Asset first{"intern-probe-a"};
+    const vertex::core::Asset again{"INTERN-PROBE-A"};
+    const vertex::core::Asset other{"intern-probe-b"};
+
+    EXPECT_TRUE(first.id().is_valid());
+    EXPECT_EQ(first.id(), again.id());
+    EXPECT_NE(first.id(), other.id());
+    EXPECT_EQ(vertex::core::AssetRegistry::instance().name(other.id()), "INTERN-PROBE-B");
+    EXPECT_LE(other.id().get_value(), vertex::core::AssetRegistry::instance().size());
+}
+
+TEST(AssetTest, OrderingFollowsNameNotInternOrder)
+{
+    const vertex::core::Asset later{"zz-order-probe"};
+    const vertex::core::Asset earlier{"aa-order-probe"};
+
+    EXPECT_LT(earlier, later);
+    EXPECT_GT(later, earlier);
+}
+
+TEST(AssetTest, ConcurrentInterningAgreesOnIds)
+{
+    constexpr int kThreads = 8;
+    constexpr int kNames = 200;
+    std::vector<std::vector<vertex::core::AssetId>> seen(kThreads);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < kNames; ++i)
+                seen[t].push_back(vertex::core::Asset{"concurrent-probe-" + std::to_string(i)}.id()); });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int t = 1; t < kThreads; ++t)
+        EXPECT_EQ(seen[t], seen[0]);
+}
+
+TEST(AssetTest, FindLooksUpWithoutInterning)
+{
+    const std::size_t before = vertex::core::AssetRegistry::instance().size();
+    EXPECT_FALSE(vertex::core::Asset::find("find-probe-unknown").has_value());
+    EXPECT_EQ(vertex::core::AssetRegistry::instance().size(), before);
+
+    const vertex::core::Asset known{"find-probe-known"};
+    const auto found = vertex::core::Asset::find("FIND-PROBE-KNOWN");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, known);
+}
+
+TEST(AssetRegistryTest, ReportsCapacityExhaustedInsteadOfGrowing)
+{
+    vertex::core::AssetRegistry registry{2};
+
+    const auto a = registry.intern("A");
+    const auto b = registry.intern("B");
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+
+    const auto full = registry.intern("C");
+    ASSERT_FALSE(full.has_value());
+    EXPECT_EQ(full.error(), vertex::core::AssetRegistryError::CapacityExhausted);
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_FALSE(registry.find("C").has_value());
+
+    // Known names still resolve once the registry is full.
+    EXPECT_EQ(registry.intern("A").value(), *a);
+    EXPECT_EQ(registry.find("B").value(), *b);
+}
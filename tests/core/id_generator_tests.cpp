@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "vertex/core/id_generator.hpp"
@@ -25,3 +31,76 @@ TEST(IdGeneratorTest, GeneratesValidIds)
     EXPECT_TRUE(id.is_valid());
     EXPECT_GT(id.get_value(), 0u);
 }
+
+TEST(IdGeneratorTest, LeaseReservesConsecutiveBlocks)
+{
+    vertex::core::IdGenerator<vertex::core::TradeId> generator;
+
+    EXPECT_EQ(generator.lease(10), 1u);
+    EXPECT_EQ(generator.lease(5), 11u);
+    EXPECT_EQ(generator.next().get_value(), 16u);
+}
+
+TEST(IdGeneratorTest, IdLeaseIsStrictlyIncreasingAcrossBlocks)
+{
+    using vertex::core::TradeId;
+    vertex::core::IdGenerator<TradeId> generator;
+    vertex::core::IdLease<TradeId> first{generator};
+    vertex::core::IdLease<TradeId> second{generator};
+
+    std::uint64_t previous = 0;
+    for (std::uint64_t i = 0; i < 3 * vertex::core::IdGenerator<TradeId>::kLeaseSize; ++i)
+    {
+        const auto id = first.next();
+        EXPECT_GT(id.get_value(), previous);
+        previous = id.get_value();
+
+        // Interleaved leases never hand out the same id.
+        EXPECT_NE(second.next(), id);
+    }
+}
+
+TEST(IdGeneratorTest, NextLocalIsUniqueAcrossThreadsAndIncreasingPerThread)
+{
+    using vertex::core::OrderId;
+    constexpr int kThreads = 8;
+    constexpr int kIdsPerThread = 10'000;
+    vertex::core::IdGenerator<OrderId> generator;
+
+    std::vector<std::vector<std::uint64_t>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&, t]
+                             {
+            ids[t].reserve(kIdsPerThread);
+            for (int i = 0; i < kIdsPerThread; ++i)
+                ids[t].push_back(generator.next_local().get_value()); });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    std::unordered_set<std::uint64_t> seen;
+    for (const auto &per_thread : ids)
+    {
+        EXPECT_TRUE(std::is_sorted(per_thread.begin(), per_thread.end()));
+        for (std::uint64_t id : per_thread)
+        {
+            EXPECT_NE(id, 0u);
+            EXPECT_TRUE(seen.insert(id).second);
+        }
+    }
+}
+
+TEST(IdGeneratorTest, NextLocalDoesNotShareBlocksBetweenGenerators)
+{
+    using vertex::core::OrderId;
+    vertex::core::IdGenerator<OrderId> first;
+    vertex::core::IdGenerator<OrderId> second;
+
+    EXPECT_EQ(first.next_local().get_value(), 1u);
+    EXPECT_EQ(second.next_local().get_value(), 1u);
+    EXPECT_EQ(second.next_local().get_value(), 2u);
+    // Switching back leases a fresh block from first.
+    EXPECT_EQ(first.next_local().get_value(), vertex::core::IdGenerator<OrderId>::kLeaseSize + 1);
+}
@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "vertex/core/market_spec.hpp"
+
+namespace
+{
+    using vertex::core::MarketSpec;
+    using vertex::core::Price;
+}
+
+TEST(MarketSpecTest, DefaultSpecIsIdentityOverThe32BitTickRange)
+{
+    constexpr MarketSpec spec{};
+    static_assert(spec.is_valid());
+    static_assert(spec.to_ticks(100) == 100u);
+    static_assert(spec.to_quantity(spec.to_lots(7)) == 7);
+
+    EXPECT_EQ(spec.lowest_price(), 1);
+    EXPECT_EQ(spec.highest_price(), static_cast<Price>(MarketSpec::kMaxTicks));
+    EXPECT_FALSE(spec.is_in_band(static_cast<Price>(MarketSpec::kMaxTicks) + 1));
+}
+
+TEST(MarketSpecTest, ScaledSpecConvertsBetweenMinimalUnitsAndCounts)
+{
+    constexpr MarketSpec spec{.tick_size = 5, .lot_size = 100, .min_price = 50, .max_price = 5'000};
+    ASSERT_TRUE(spec.is_valid());
+
+    EXPECT_EQ(spec.to_ticks(105), 21u);
+    EXPECT_EQ(spec.to_price(21), 105);
+    EXPECT_EQ(spec.to_lots(300), 3u);
+    EXPECT_EQ(spec.to_quantity(3), 300);
+
+    EXPECT_FALSE(spec.is_on_tick(102));
+    EXPECT_FALSE(spec.is_in_band(45));
+    EXPECT_FALSE(spec.is_in_band(5'005));
+    EXPECT_FALSE(spec.is_on_lot(150));
+    EXPECT_TRUE(spec.fits_lots(static_cast<std::int64_t>(MarketSpec::kMaxLots) * 100));
+    EXPECT_FALSE(spec.fits_lots(static_cast<std::int64_t>(MarketSpec::kMaxLots) * 100 + 100));
+}
+
+TEST(MarketSpecTest, RejectsSpecsTheBookCannotRepresent)
+{
+    EXPECT_FALSE((MarketSpec{.tick_size = 0}.is_valid()));
+    EXPECT_FALSE((MarketSpec{.lot_size = -1}.is_valid()));
+    // Band edges off the tick grid.
+    EXPECT_FALSE((MarketSpec{.tick_size = 5, .min_price = 7}.is_valid()));
+    EXPECT_FALSE((MarketSpec{.tick_size = 5, .max_price = 502}.is_valid()));
+    EXPECT_FALSE((MarketSpec{.min_price = 10, .max_price = 5}.is_valid()));
+    // More ticks than a 32-bit count holds.
+    EXPECT_FALSE((MarketSpec{.max_price = static_cast<Price>(MarketSpec::kMaxTicks) + 1}.is_valid()));
+    // kMaxLots lots would not fit in a Quantity.
+    EXPECT_FALSE((MarketSpec{.lot_size = std::numeric_limits<std::int64_t>::max() / 2}.is_valid()));
+    // A huge tick still gets a representable default ceiling.
+    EXPECT_TRUE((MarketSpec{.tick_size = std::numeric_limits<std::int64_t>::max() / 4}.is_valid()));
+}
@@ -0,0 +1,40 @@
+#include <cstdint>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "vertex/core/notional.hpp"
+
+namespace
+{
+    using vertex::core::checked_add;
+    using vertex::core::checked_notional;
+    using vertex::core::notional;
+    using vertex::core::Quantity;
+
+    constexpr Quantity kMax = std::numeric_limits<Quantity>::max();
+}
+
+TEST(NotionalTest, ProductInRangeMatchesPlainMultiply)
+{
+    static_assert(notional(100, 5) == 500);
+
+    EXPECT_EQ(checked_notional(123'456'789, 1'000'000), 123'456'789'000'000);
+    EXPECT_EQ(checked_notional(-7, 3), -21);
+    EXPECT_EQ(checked_notional(kMax, 1), kMax);
+}
+
+TEST(NotionalTest, ProductPastInt64IsRejectedInsteadOfWrapping)
+{
+    // 10^10 * 10^10 would wrap to a positive garbage value in int64.
+    EXPECT_EQ(checked_notional(10'000'000'000, 10'000'000'000), std::nullopt);
+    EXPECT_EQ(checked_notional(kMax, 2), std::nullopt);
+    EXPECT_EQ(checked_notional(std::numeric_limits<Quantity>::min(), -1), std::nullopt);
+}
+
+TEST(NotionalTest, CheckedAddRejectsOverflow)
+{
+    EXPECT_EQ(checked_add(kMax - 1, 1), kMax);
+    EXPECT_EQ(checked_add(kMax, 1), std::nullopt);
+    EXPECT_EQ(checked_add(std::numeric_limits<Quantity>::min(), -1), std::nullopt);
+}
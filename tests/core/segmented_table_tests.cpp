@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vertex/core/segmented_table.hpp"
+
+TEST(SegmentedTableTest, AppendsReturnDenseIndicesAndFindsElements)
+{
+    vertex::core::SegmentedTable<std::string, 2> table;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        const auto index = table.emplace_back(std::to_string(i));
+        ASSERT_TRUE(index.has_value());
+        EXPECT_EQ(*index, static_cast<std::size_t>(i));
+    }
+
+    EXPECT_EQ(table.size(), 10u);
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_NE(table.find(i), nullptr);
+        EXPECT_EQ(*table.find(i), std::to_string(i));
+    }
+    EXPECT_EQ(table.find(10), nullptr);
+}
+
+TEST(SegmentedTableTest, ElementsDoNotMoveWhenSegmentsAreAdded)
+{
+    vertex::core::SegmentedTable<int, 2> table;
+    ASSERT_TRUE(table.emplace_back(7).has_value());
+    const int *first = table.find(0);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(table.emplace_back(i).has_value());
+    }
+
+    EXPECT_EQ(table.find(0), first);
+    EXPECT_EQ(*first, 7);
+}
+
+TEST(SegmentedTableTest, RejectsAppendWhenFull)
+{
+    vertex::core::SegmentedTable<int, 1, 2> table;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(table.emplace_back(i).has_value());
+    }
+
+    EXPECT_FALSE(table.emplace_back(4).has_value());
+    EXPECT_EQ(table.size(), 4u);
+}
+
+TEST(SegmentedTableTest, ReadersSeeOnlyFullyConstructedElements)
+{
+    constexpr int kElements = 20000;
+    vertex::core::SegmentedTable<std::vector<int>, 4, 2048> table;
+    std::atomic<bool> done{false};
+    std::atomic<int> wrong{0};
+
+    std::thread reader([&]()
+                       {
+        while (!done.load(std::memory_order_acquire))
+        {
+            const std::size_t size = table.size();
+            if (size == 0)
+                continue;
+            const std::vector<int> *last = table.find(size - 1);
+            if (last == nullptr || last->size() != 3 || (*last)[2] != static_cast<int>(size - 1))
+                wrong.fetch_add(1);
+        } });
+
+    for (int i = 0; i < kElements; ++i)
+    {
+        ASSERT_TRUE(table.emplace_back(std::vector<int>{0, 0, i}).has_value());
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(wrong.load(), 0);
+}
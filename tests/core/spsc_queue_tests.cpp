@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "vertex/core/spsc_queue.hpp"
+
+using vertex::core::SpscQueue;
+
+TEST(SpscQueueTest, PopsInPushOrderAndRejectsPushWhenFull)
+{
+    SpscQueue<int> queue{3};
+    ASSERT_EQ(queue.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.try_push(int{i}));
+    EXPECT_FALSE(queue.try_push(4));
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(queue.try_pop(), i);
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(SpscQueueTest, WrapsAroundAndReleasesMoveOnlyValues)
+{
+    SpscQueue<std::unique_ptr<int>> queue{2};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(queue.try_push(std::make_unique<int>(i)));
+        auto value = queue.try_pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(**value, i);
+    }
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(SpscQueueTest, ConsumerThreadSeesEveryValueInOrder)
+{
+    constexpr std::uint64_t kValues = 100'000;
+    SpscQueue<std::uint64_t> queue{64};
+
+    std::thread consumer([&]
+                         {
+                             std::uint64_t expected = 0;
+                             while (expected < kValues)
+                             {
+                                 auto value = queue.try_pop();
+                                 if (!value)
+                                 {
+                                     queue.wait_while_empty();
+                                     continue;
+                                 }
+                                 EXPECT_EQ(*value, expected);
+                                 ++expected;
+                             } });
+
+    for (std::uint64_t i = 0; i < kValues; ++i)
+    {
+        while (!queue.try_push(std::uint64_t{i}))
+            std::this_thread::yield();
+    }
+    consumer.join();
+}
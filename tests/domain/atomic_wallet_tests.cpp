@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vertex/domain/atomic_wallet.hpp"
+
+namespace
+{
+    using vertex::core::Asset;
+    using vertex::domain::AtomicWallet;
+    using vertex::domain::WalletError;
+
+    Asset btc()
+    {
+        return Asset{"btc"};
+    }
+
+    Asset usdt()
+    {
+        return Asset{"usdt"};
+    }
+}
+
+TEST(AtomicWalletTest, MatchesWalletSemanticsForSingleThread)
+{
+    AtomicWallet wallet;
+
+    EXPECT_EQ(wallet.free_balance(btc()), 0);
+    EXPECT_EQ(wallet.deposit(btc(), 0).error(), WalletError::InvalidAmount);
+    EXPECT_EQ(wallet.reserve(btc(), 1).error(), WalletError::InsufficientFunds);
+    EXPECT_EQ(wallet.release(btc(), 1).error(), WalletError::InsufficientReserved);
+
+    ASSERT_TRUE(wallet.deposit(btc(), 100).has_value());
+    ASSERT_TRUE(wallet.reserve(btc(), 40).has_value());
+    EXPECT_EQ(wallet.reserve(btc(), 61).error(), WalletError::InsufficientFunds);
+    ASSERT_TRUE(wallet.release(btc(), 10).has_value());
+    ASSERT_TRUE(wallet.consume_reserved(btc(), 20).has_value());
+    EXPECT_EQ(wallet.consume_reserved(btc(), 11).error(), WalletError::InsufficientReserved);
+    ASSERT_TRUE(wallet.withdraw(btc(), 70).has_value());
+    EXPECT_EQ(wallet.withdraw(btc(), 1).error(), WalletError::InsufficientFunds);
+
+    EXPECT_EQ(wallet.free_balance(btc()), 0);
+    EXPECT_EQ(wallet.reserved_balance(btc()), 10);
+    EXPECT_EQ(wallet.free_balance(usdt()), 0);
+}
+
+TEST(AtomicWalletTest, AssetsPastInlineRangeSpillAndKeepIndependentBalances)
+{
+    AtomicWallet wallet;
+    std::vector<Asset> assets;
+    for (std::size_t i = 0; i < AtomicWallet::kInlineAssets + 8; ++i)
+    {
+        assets.emplace_back("atomic-spill-probe-" + std::to_string(i));
+    }
+
+    for (std::size_t i = 0; i < assets.size(); ++i)
+    {
+        ASSERT_TRUE(wallet.deposit(assets[i], static_cast<vertex::core::Quantity>(i + 1)).has_value());
+    }
+    ASSERT_TRUE(wallet.reserve(assets.back(), 1).has_value());
+
+    for (std::size_t i = 0; i + 1 < assets.size(); ++i)
+    {
+        EXPECT_EQ(wallet.free_balance(assets[i]), static_cast<vertex::core::Quantity>(i + 1));
+    }
+    EXPECT_EQ(wallet.free_balance(assets.back()), static_cast<vertex::core::Quantity>(assets.size() - 1));
+    EXPECT_EQ(wallet.reserved_balance(assets.back()), 1);
+    EXPECT_EQ(wallet.reserve(Asset{"atomic-spill-missing"}, 1).error(), WalletError::InsufficientFunds);
+}
+
+TEST(AtomicWalletTest, ConcurrentReservesNeverOverdrawAndConserveTotal)
+{
+    constexpr int kThreads = 8;
+    constexpr int kAttempts = 20'000;
+    constexpr vertex::core::Quantity kFunded = 50'000;
+
+    AtomicWallet wallet;
+    ASSERT_TRUE(wallet.deposit(usdt(), kFunded).has_value());
+
+    std::atomic<vertex::core::Quantity> reserved_ok{0};
+    std::atomic<vertex::core::Quantity> consumed{0};
+    std::atomic<int> negative_seen{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < kAttempts; ++i)
+            {
+                if (!wallet.reserve(usdt(), 1))
+                    continue;
+                reserved_ok.fetch_add(1);
+
+                // Alternate between handing it back and spending it.
+                if ((i + t) % 2 == 0)
+                {
+                    EXPECT_TRUE(wallet.release(usdt(), 1).has_value());
+                }
+                else
+                {
+                    EXPECT_TRUE(wallet.consume_reserved(usdt(), 1).has_value());
+                    consumed.fetch_add(1);
+                }
+
+                if (wallet.free_balance(usdt()) < 0 || wallet.reserved_balance(usdt()) < 0)
+                    negative_seen.fetch_add(1);
+            } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(negative_seen.load(), 0);
+    EXPECT_GT(reserved_ok.load(), 0);
+    EXPECT_EQ(wallet.reserved_balance(usdt()), 0);
+    EXPECT_EQ(wallet.free_balance(usdt()), kFunded - consumed.load());
+}
+
+TEST(AtomicWalletTest, ReservationHandleSplitsConsumesAndReleasesItsOwnShare)
+{
+    AtomicWallet wallet;
+    ASSERT_TRUE(wallet.deposit(usdt(), 1000).has_value());
+
+    auto reservation = wallet.reserve(usdt(), 600);
+    ASSERT_TRUE(reservation.has_value());
+
+    auto fill = reservation->split(220);
+    ASSERT_TRUE(wallet.consume_reserved(fill, 200).has_value());
+    ASSERT_TRUE(wallet.release(fill, 20).has_value());
+    EXPECT_EQ(wallet.consume_reserved(fill, 1).error(), WalletError::InsufficientReserved);
+
+    // Draining the slot by asset leaves the handle unable to take it twice.
+    ASSERT_TRUE(wallet.release(usdt(), 300).has_value());
+    EXPECT_EQ(wallet.release(*reservation, 380).error(), WalletError::InsufficientReserved);
+    ASSERT_TRUE(wallet.release(*reservation, 80).has_value());
+
+    EXPECT_EQ(wallet.free_balance(usdt()), 800);
+    EXPECT_EQ(wallet.reserved_balance(usdt()), 0);
+}
+
+TEST(AtomicWalletTest, DepositPastQuantityRangeReturnsBalanceOverflow)
+{
+    AtomicWallet wallet;
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+
+    ASSERT_TRUE(wallet.deposit(btc(), kMax - 10).has_value());
+    ASSERT_TRUE(wallet.reserve(btc(), 5).has_value());
+
+    EXPECT_EQ(wallet.deposit(btc(), 11).error(), WalletError::BalanceOverflow);
+    EXPECT_EQ(wallet.free_balance(btc()), kMax - 15);
+}
+
+TEST(AtomicWalletTest, WithdrawAndConsumeFreeHeadroomForLaterDeposits)
+{
+    AtomicWallet wallet;
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+
+    ASSERT_TRUE(wallet.deposit(btc(), kMax).has_value());
+    ASSERT_TRUE(wallet.reserve(btc(), 10).has_value());
+    EXPECT_EQ(wallet.deposit(btc(), 1).error(), WalletError::BalanceOverflow);
+
+    ASSERT_TRUE(wallet.withdraw(btc(), 3).has_value());
+    ASSERT_TRUE(wallet.consume_reserved(btc(), 4).has_value());
+    ASSERT_TRUE(wallet.deposit(btc(), 7).has_value());
+    EXPECT_EQ(wallet.deposit(btc(), 1).error(), WalletError::BalanceOverflow);
+    EXPECT_EQ(wallet.free_balance(btc()), kMax - 10 - 3 + 7);
+    EXPECT_EQ(wallet.reserved_balance(btc()), 6);
+}
+
+TEST(AtomicWalletTest, ConcurrentDepositsAtTheCapNeverOverflowDuringReleases)
+{
+    constexpr int kChurnThreads = 4;
+    constexpr int kRounds = 20'000;
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+    constexpr vertex::core::Quantity kChunk = 1'000;
+
+    AtomicWallet wallet;
+    ASSERT_TRUE(wallet.deposit(usdt(), kMax - 64).has_value());
+    ASSERT_TRUE(wallet.reserve(usdt(), kChunk * kChurnThreads).has_value());
+
+    // Churn moves chunks reserved -> free -> reserved, which is exactly the
+    // window where a deposit reading the two counters separately under-counts.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kChurnThreads; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int i = 0; i < kRounds; ++i)
+            {
+                if (wallet.release(usdt(), kChunk))
+                {
+                    while (!wallet.reserve(usdt(), kChunk))
+                    {
+                    }
+                }
+            } });
+    }
+    std::atomic<vertex::core::Quantity> deposited{0};
+    threads.emplace_back([&]()
+                         {
+        for (int i = 0; i < kRounds; ++i)
+        {
+            if (wallet.deposit(usdt(), 1))
+                deposited.fetch_add(1);
+        } });
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(deposited.load(), 64);
+    EXPECT_EQ(wallet.reserved_balance(usdt()), kChunk * kChurnThreads);
+    EXPECT_EQ(wallet.free_balance(usdt()), kMax - kChunk * kChurnThreads);
+}
+
+TEST(AtomicWalletTest, ConcurrentFirstDepositsClaimDistinctSlots)
+{
+    constexpr int kRounds = 2'000;
+    std::vector<Asset> assets;
+    for (std::size_t i = 0; i < AtomicWallet::kInlineAssets + 4; ++i)
+    {
+        assets.emplace_back("atomic-claim-probe-" + std::to_string(i));
+    }
+
+    AtomicWallet wallet;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < assets.size(); ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < kRounds; ++i)
+            {
+                EXPECT_TRUE(wallet.deposit(assets[t], static_cast<vertex::core::Quantity>(t + 1)).has_value());
+            } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (std::size_t t = 0; t < assets.size(); ++t)
+    {
+        EXPECT_EQ(wallet.free_balance(assets[t]), static_cast<vertex::core::Quantity>(t + 1) * kRounds);
+    }
+}
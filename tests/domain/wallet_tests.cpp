@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <string>
+#include <vector>
+
 #include "vertex/domain/wallet.hpp"
 
 namespace
@@ -152,3 +156,104 @@ TEST(WalletTest, DoubleConsumeReservedSecondCallFails)
     EXPECT_EQ(wallet.free_balance(usdt()), 60);
     EXPECT_EQ(wallet.reserved_balance(usdt()), 0);
 }
+
+TEST(WalletTest, AssetsPastInlineRangeSpillAndKeepIndependentBalances)
+{
+    Wallet wallet;
+    std::vector<Asset> assets;
+    for (std::size_t i = 0; i < Wallet::kInlineAssets + 8; ++i)
+    {
+        assets.emplace_back("spill-probe-" + std::to_string(i));
+    }
+
+    for (std::size_t i = 0; i < assets.size(); ++i)
+    {
+        const auto amount = static_cast<vertex::core::Quantity>(i + 1);
+        ASSERT_TRUE(wallet.deposit(assets[i], 10 * amount).has_value());
+        ASSERT_TRUE(wallet.reserve(assets[i], amount).has_value());
+    }
+
+    for (std::size_t i = 0; i < assets.size(); ++i)
+    {
+        const auto amount = static_cast<vertex::core::Quantity>(i + 1);
+        EXPECT_EQ(wallet.free_balance(assets[i]), 9 * amount);
+        EXPECT_EQ(wallet.reserved_balance(assets[i]), amount);
+        ASSERT_TRUE(wallet.consume_reserved(assets[i], amount).has_value());
+        EXPECT_EQ(wallet.reserved_balance(assets[i]), 0);
+    }
+
+    const Asset never_deposited{"spill-probe-missing"};
+    EXPECT_EQ(wallet.free_balance(never_deposited), 0);
+    EXPECT_EQ(wallet.release(never_deposited, 1).error(), WalletError::InsufficientReserved);
+    EXPECT_EQ(wallet.withdraw(never_deposited, 1).error(), WalletError::InsufficientFunds);
+}
+
+TEST(WalletTest, AssetsSharingAProbeStartKeepIndependentBalancesAndStableHandles)
+{
+    // Ids congruent mod kInlineAssets all start probing at the same slot.
+    std::vector<Asset> colliding;
+    for (std::size_t i = 0; colliding.size() < Wallet::kInlineAssets + 2; ++i)
+    {
+        Asset asset{"probe-collision-" + std::to_string(i)};
+        if (colliding.empty() || asset.id().get_value() % Wallet::kInlineAssets == colliding.front().id().get_value() % Wallet::kInlineAssets)
+            colliding.push_back(asset);
+    }
+
+    Wallet wallet;
+    ASSERT_TRUE(wallet.deposit(colliding.front(), 100).has_value());
+    auto reservation = wallet.reserve(colliding.front(), 40);
+    ASSERT_TRUE(reservation.has_value());
+
+    // Fill the remaining inline slots and spill; the first slot must not move.
+    for (std::size_t i = 1; i < colliding.size(); ++i)
+    {
+        ASSERT_TRUE(wallet.deposit(colliding[i], static_cast<vertex::core::Quantity>(i)).has_value());
+    }
+    ASSERT_TRUE(wallet.release(*reservation, 15).has_value());
+
+    EXPECT_EQ(wallet.free_balance(colliding.front()), 75);
+    EXPECT_EQ(wallet.reserved_balance(colliding.front()), 25);
+    for (std::size_t i = 1; i < colliding.size(); ++i)
+    {
+        EXPECT_EQ(wallet.free_balance(colliding[i]), static_cast<vertex::core::Quantity>(i));
+        EXPECT_EQ(wallet.reserved_balance(colliding[i]), 0);
+    }
+}
+
+TEST(WalletTest, ReservationHandleSplitsConsumesAndReleasesItsOwnShare)
+{
+    Wallet wallet;
+    ASSERT_TRUE(wallet.deposit(usdt(), 1000).has_value());
+
+    auto reservation = wallet.reserve(usdt(), 600);
+    ASSERT_TRUE(reservation.has_value());
+    EXPECT_EQ(reservation->remaining, 600);
+
+    auto fill = reservation->split(220);
+    EXPECT_EQ(reservation->remaining, 380);
+    ASSERT_TRUE(wallet.consume_reserved(fill, 200).has_value());
+    ASSERT_TRUE(wallet.release(fill, 20).has_value());
+    EXPECT_EQ(fill.remaining, 0);
+    EXPECT_EQ(wallet.consume_reserved(fill, 1).error(), WalletError::InsufficientReserved);
+
+    EXPECT_EQ(wallet.release(*reservation, 381).error(), WalletError::InsufficientReserved);
+    EXPECT_EQ(wallet.release(*reservation, 0).error(), WalletError::InvalidAmount);
+    ASSERT_TRUE(wallet.release(*reservation, 380).has_value());
+
+    EXPECT_EQ(wallet.free_balance(usdt()), 800);
+    EXPECT_EQ(wallet.reserved_balance(usdt()), 0);
+}
+
+TEST(WalletTest, DepositPastQuantityRangeReturnsBalanceOverflow)
+{
+    Wallet wallet;
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+
+    ASSERT_TRUE(wallet.deposit(usdt(), kMax - 10).has_value());
+    ASSERT_TRUE(wallet.reserve(usdt(), 5).has_value());
+
+    EXPECT_EQ(wallet.deposit(usdt(), 11).error(), WalletError::BalanceOverflow);
+    EXPECT_EQ(wallet.free_balance(usdt()), kMax - 15);
+    ASSERT_TRUE(wallet.deposit(usdt(), 10).has_value());
+    EXPECT_EQ(wallet.free_balance(usdt()) + wallet.reserved_balance(usdt()), kMax);
+}
@@ -1,3 +1,5 @@
+#include <future>
+
 #include <gtest/gtest.h>
 
 #include "vertex/engine/market_dispatcher.hpp"
@@ -6,12 +8,16 @@ namespace
 {
     using vertex::core::Asset;
     using vertex::core::Market;
+    using vertex::core::MarketId;
+    using vertex::core::MarketSpec;
     using vertex::core::OrderId;
     using vertex::core::Side;
     using vertex::core::UserId;
     using vertex::engine::EngineAsyncError;
     using vertex::engine::MarketDispatcher;
+    using vertex::engine::CancelResultEx;
     using vertex::engine::OrderRequest;
+    using vertex::engine::SubmitResult;
 
     Market btc_usdt()
     {
@@ -24,7 +30,7 @@ namespace
     }
 
     OrderRequest make_limit_order(
-        const Market &market,
+        MarketId market,
         OrderId order_id,
         UserId user_id,
         Side side,
@@ -68,7 +74,7 @@ TEST(MarketDispatcherTest, SubmitUnknownMarketReturnsMarketNotFound)
     MarketDispatcher dispatcher;
 
     auto result = dispatcher.submit(
-        make_limit_order(btc_usdt(), OrderId{100}, UserId{1}, Side::Buy, 1, 100))
+        make_limit_order(MarketId{1}, OrderId{100}, UserId{1}, Side::Buy, 1, 100))
                       .get();
 
     ASSERT_FALSE(result.has_value());
@@ -91,20 +97,23 @@ TEST(MarketDispatcherTest, CancelAndBestBidUnknownMarketReturnMarketNotFound)
 TEST(MarketDispatcherTest, SubmitRoutesToCorrectMarketWorker)
 {
     MarketDispatcher dispatcher;
-    ASSERT_TRUE(dispatcher.register_market(btc_usdt()).has_value());
-    ASSERT_TRUE(dispatcher.register_market(eth_usdt()).has_value());
+    const auto btc = dispatcher.register_market(btc_usdt());
+    const auto eth = dispatcher.register_market(eth_usdt());
+    ASSERT_TRUE(btc.has_value());
+    ASSERT_TRUE(eth.has_value());
+    EXPECT_NE(*btc, *eth);
 
     ASSERT_TRUE(dispatcher.submit(
-                             make_limit_order(btc_usdt(), OrderId{10}, UserId{1}, Side::Sell, 2, 100))
+                             make_limit_order(*btc, OrderId{10}, UserId{1}, Side::Sell, 2, 100))
                     .get()
                     .has_value());
     ASSERT_TRUE(dispatcher.submit(
-                             make_limit_order(eth_usdt(), OrderId{20}, UserId{2}, Side::Sell, 2, 1000))
+                             make_limit_order(*eth, OrderId{20}, UserId{2}, Side::Sell, 2, 1000))
                     .get()
                     .has_value());
 
     auto btc_match = dispatcher.submit(
-                               make_limit_order(btc_usdt(), OrderId{11}, UserId{3}, Side::Buy, 2, 100))
+                               make_limit_order(*btc, OrderId{11}, UserId{3}, Side::Buy, 2, 100))
                              .get();
 
     ASSERT_TRUE(btc_match.has_value());
@@ -117,7 +126,8 @@ TEST(MarketDispatcherTest, SubmitRoutesToCorrectMarketWorker)
 TEST(MarketDispatcherTest, StopAllBlocksNewRegistrationsAndWorkerCalls)
 {
     MarketDispatcher dispatcher;
-    ASSERT_TRUE(dispatcher.register_market(btc_usdt()).has_value());
+    const auto btc = dispatcher.register_market(btc_usdt());
+    ASSERT_TRUE(btc.has_value());
 
     dispatcher.stop_all();
 
@@ -128,7 +138,7 @@ TEST(MarketDispatcherTest, StopAllBlocksNewRegistrationsAndWorkerCalls)
     try
     {
         auto submit_future = dispatcher.submit(
-            make_limit_order(btc_usdt(), OrderId{100}, UserId{1}, Side::Buy, 1, 100));
+            make_limit_order(*btc, OrderId{100}, UserId{1}, Side::Buy, 1, 100));
         ASSERT_TRUE(submit_future.valid());
         auto submit_after_stop = submit_future.get();
         ASSERT_FALSE(submit_after_stop.has_value());
@@ -152,3 +162,112 @@ TEST(MarketDispatcherTest, StopAllBlocksNewRegistrationsAndWorkerCalls)
         FAIL() << "best_ask after stop threw: " << e.what();
     }
 }
+
+TEST(MarketDispatcherTest, CallbackSubmitUnknownMarketCompletesInline)
+{
+    MarketDispatcher dispatcher;
+
+    bool called = false;
+    dispatcher.submit(
+        make_limit_order(MarketId{1}, OrderId{1}, UserId{1}, Side::Buy, 1, 100),
+        [&](SubmitResult result)
+        {
+            called = true;
+            ASSERT_FALSE(result.has_value());
+            EXPECT_EQ(result.error(), EngineAsyncError::MarketNotFound);
+        });
+
+    EXPECT_TRUE(called);
+}
+
+TEST(MarketDispatcherTest, CallbackSubmitAndCancelRouteToMarketWorker)
+{
+    MarketDispatcher dispatcher;
+    const auto btc = dispatcher.register_market(btc_usdt());
+    ASSERT_TRUE(btc.has_value());
+
+    std::promise<SubmitResult> submitted;
+    dispatcher.submit(
+        make_limit_order(*btc, OrderId{7}, UserId{1}, Side::Sell, 3, 100),
+        [&](SubmitResult result)
+        { submitted.set_value(std::move(result)); });
+
+    std::promise<CancelResultEx> canceled;
+    dispatcher.cancel(btc_usdt(), OrderId{7}, [&](CancelResultEx result)
+                      { canceled.set_value(std::move(result)); });
+
+    auto submit_result = submitted.get_future().get();
+    ASSERT_TRUE(submit_result.has_value());
+    EXPECT_TRUE(submit_result->empty());
+
+    auto cancel_result = canceled.get_future().get();
+    ASSERT_TRUE(cancel_result.has_value());
+    ASSERT_TRUE(cancel_result->has_value());
+    EXPECT_EQ((*cancel_result)->remaining_quantity, 3);
+}
+
+TEST(MarketDispatcherTest, RegisterMarketIssuesDenseIdsResolvableBothWays)
+{
+    MarketDispatcher dispatcher;
+
+    const auto btc = dispatcher.register_market(btc_usdt());
+    const auto eth = dispatcher.register_market(eth_usdt());
+    ASSERT_TRUE(btc.has_value());
+    ASSERT_TRUE(eth.has_value());
+    EXPECT_EQ(btc->get_value(), 1u);
+    EXPECT_EQ(eth->get_value(), 2u);
+
+    EXPECT_EQ(dispatcher.find_market_id(eth_usdt()), *eth);
+    ASSERT_NE(dispatcher.find_market(*btc), nullptr);
+    EXPECT_EQ(*dispatcher.find_market(*btc), btc_usdt());
+    EXPECT_TRUE(dispatcher.has_market(*eth));
+
+    EXPECT_EQ(dispatcher.find_market(MarketId{}), nullptr);
+    EXPECT_EQ(dispatcher.find_market(MarketId{3}), nullptr);
+    EXPECT_FALSE(dispatcher.has_market(MarketId{3}));
+
+    auto cancel_result = dispatcher.cancel(MarketId{3}, OrderId{1}).get();
+    ASSERT_FALSE(cancel_result.has_value());
+    EXPECT_EQ(cancel_result.error(), EngineAsyncError::MarketNotFound);
+}
+
+TEST(MarketDispatcherTest, RegisterMarketRejectsInvalidSpecAndKeepsValidOne)
+{
+    MarketDispatcher dispatcher;
+
+    const auto invalid = dispatcher.register_market(btc_usdt(), MarketSpec{.lot_size = 0});
+    ASSERT_FALSE(invalid.has_value());
+    EXPECT_EQ(invalid.error(), EngineAsyncError::InvalidMarketSpec);
+    EXPECT_FALSE(dispatcher.has_market(btc_usdt()));
+
+    const MarketSpec spec{.tick_size = 5, .lot_size = 10};
+    const auto registered = dispatcher.register_market(btc_usdt(), spec);
+    ASSERT_TRUE(registered.has_value());
+    const MarketSpec *stored = dispatcher.find_market_spec(*registered);
+    ASSERT_NE(stored, nullptr);
+    EXPECT_EQ(stored->tick_size, 5);
+    EXPECT_EQ(stored->lot_size, 10);
+    EXPECT_EQ(dispatcher.find_market_spec(MarketId{}), nullptr);
+}
+
+TEST(MarketDispatcherTest, TradeIdsAreUniqueAcrossMarkets)
+{
+    MarketDispatcher dispatcher;
+    const auto btc = dispatcher.register_market(btc_usdt());
+    const auto eth = dispatcher.register_market(eth_usdt());
+    ASSERT_TRUE(btc.has_value());
+    ASSERT_TRUE(eth.has_value());
+
+    ASSERT_TRUE(dispatcher.submit(make_limit_order(*btc, OrderId{1}, UserId{1}, Side::Sell, 1, 100)).get().has_value());
+    ASSERT_TRUE(dispatcher.submit(make_limit_order(*eth, OrderId{2}, UserId{1}, Side::Sell, 1, 100)).get().has_value());
+    auto btc_fill = dispatcher.submit(make_limit_order(*btc, OrderId{3}, UserId{2}, Side::Buy, 1, 100)).get();
+    auto eth_fill = dispatcher.submit(make_limit_order(*eth, OrderId{4}, UserId{2}, Side::Buy, 1, 100)).get();
+
+    ASSERT_TRUE(btc_fill.has_value());
+    ASSERT_TRUE(eth_fill.has_value());
+    ASSERT_EQ(btc_fill->size(), 1u);
+    ASSERT_EQ(eth_fill->size(), 1u);
+    EXPECT_TRUE((*btc_fill)[0].trade_id.is_valid());
+    EXPECT_TRUE((*eth_fill)[0].trade_id.is_valid());
+    EXPECT_NE((*btc_fill)[0].trade_id, (*eth_fill)[0].trade_id);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "vertex/engine/market_ledger.hpp"
+
+namespace
+{
+    using vertex::core::OrderId;
+    using vertex::core::UserId;
+    using vertex::engine::EngineAsyncError;
+    using vertex::engine::Execution;
+    using vertex::engine::LedgerAsset;
+    using vertex::engine::LedgerTransfer;
+    using vertex::engine::MarketLedger;
+}
+
+TEST(MarketLedgerTest, TransferMovesFreeBalanceAndRejectsOverdraw)
+{
+    MarketLedger ledger;
+    const UserId user{1};
+
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Quote, 500, LedgerTransfer::Credit).has_value());
+    ASSERT_TRUE(ledger.reserve(user, LedgerAsset::Quote, 200));
+    EXPECT_FALSE(ledger.reserve(user, LedgerAsset::Quote, 301));
+    EXPECT_FALSE(ledger.reserve(UserId{2}, LedgerAsset::Base, 1));
+
+    // Reserved funds cannot leave the sub-ledger.
+    const auto overdraw = ledger.transfer(user, LedgerAsset::Quote, 301, LedgerTransfer::Debit);
+    ASSERT_FALSE(overdraw.has_value());
+    EXPECT_EQ(overdraw.error(), EngineAsyncError::InsufficientFunds);
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Quote, 300, LedgerTransfer::Debit).has_value());
+
+    ledger.release(user, LedgerAsset::Quote, 200);
+    const auto balance = ledger.balance(user);
+    EXPECT_EQ(balance.quote_free, 200);
+    EXPECT_EQ(balance.quote_reserved, 0);
+    EXPECT_EQ(balance.base_free, 0);
+}
+
+TEST(MarketLedgerTest, SettleMovesFundsAndReleasesBuyerPriceImprovement)
+{
+    MarketLedger ledger;
+    const UserId buyer{1};
+    const UserId seller{2};
+    ASSERT_TRUE(ledger.transfer(buyer, LedgerAsset::Quote, 1000, LedgerTransfer::Credit).has_value());
+    ASSERT_TRUE(ledger.transfer(seller, LedgerAsset::Base, 5, LedgerTransfer::Credit).has_value());
+    ASSERT_TRUE(ledger.reserve(buyer, LedgerAsset::Quote, 3 * 110));
+    ASSERT_TRUE(ledger.reserve(seller, LedgerAsset::Base, 3));
+
+    EXPECT_TRUE(ledger.settle(Execution{
+        .buy_order_id = OrderId{1},
+        .sell_order_id = OrderId{2},
+        .buy_owner = buyer,
+        .sell_owner = seller,
+        .quantity = 3,
+        .execution_price = 100,
+        .buy_order_limit_price = 110,
+        .buy_fully_filled = true,
+        .sell_fully_filled = true,
+    }));
+
+    const auto buyer_balance = ledger.balance(buyer);
+    EXPECT_EQ(buyer_balance.quote_free, 700);
+    EXPECT_EQ(buyer_balance.quote_reserved, 0);
+    EXPECT_EQ(buyer_balance.base_free, 3);
+
+    const auto seller_balance = ledger.balance(seller);
+    EXPECT_EQ(seller_balance.base_free, 2);
+    EXPECT_EQ(seller_balance.base_reserved, 0);
+    EXPECT_EQ(seller_balance.quote_free, 300);
+}
+
+TEST(MarketLedgerTest, CreditCountsReservedFundsAgainstTheLimit)
+{
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+    MarketLedger ledger;
+    const UserId user{1};
+
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Quote, kMax - 10, LedgerTransfer::Credit).has_value());
+    ASSERT_TRUE(ledger.reserve(user, LedgerAsset::Quote, kMax - 20));
+
+    // Free is only 10, but free + reserved would pass the maximum.
+    const auto overflow = ledger.transfer(user, LedgerAsset::Quote, 11, LedgerTransfer::Credit);
+    ASSERT_FALSE(overflow.has_value());
+    EXPECT_EQ(overflow.error(), EngineAsyncError::BalanceOverflow);
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Quote, 10, LedgerTransfer::Credit).has_value());
+
+    ledger.release(user, LedgerAsset::Quote, kMax - 20);
+    const auto balance = ledger.balance(user);
+    EXPECT_EQ(balance.quote_free, kMax);
+    EXPECT_EQ(balance.quote_reserved, 0);
+}
+
+TEST(MarketLedgerTest, CreditIsBoundedByTheLedgerTotalSoSettleCannotOverflow)
+{
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+    MarketLedger ledger;
+    const UserId buyer{1};
+    const UserId seller{2};
+    ASSERT_TRUE(ledger.transfer(buyer, LedgerAsset::Quote, 100, LedgerTransfer::Credit).has_value());
+    ASSERT_TRUE(ledger.transfer(seller, LedgerAsset::Base, 1, LedgerTransfer::Credit).has_value());
+
+    // The seller's own quote is empty, but the ledger already holds the buyer's 100.
+    const auto overflow = ledger.transfer(seller, LedgerAsset::Quote, kMax, LedgerTransfer::Credit);
+    ASSERT_FALSE(overflow.has_value());
+    EXPECT_EQ(overflow.error(), EngineAsyncError::BalanceOverflow);
+    ASSERT_TRUE(ledger.transfer(seller, LedgerAsset::Quote, kMax - 100, LedgerTransfer::Credit).has_value());
+
+    ASSERT_TRUE(ledger.reserve(buyer, LedgerAsset::Quote, 100));
+    ASSERT_TRUE(ledger.reserve(seller, LedgerAsset::Base, 1));
+    EXPECT_TRUE(ledger.settle(Execution{
+        .buy_order_id = OrderId{1},
+        .sell_order_id = OrderId{2},
+        .buy_owner = buyer,
+        .sell_owner = seller,
+        .quantity = 1,
+        .execution_price = 100,
+        .buy_order_limit_price = 100,
+        .buy_fully_filled = true,
+        .sell_fully_filled = true,
+    }));
+
+    const auto buyer_balance = ledger.balance(buyer);
+    EXPECT_EQ(buyer_balance.quote_reserved, 0);
+    EXPECT_EQ(buyer_balance.base_free, 1);
+    const auto seller_balance = ledger.balance(seller);
+    EXPECT_EQ(seller_balance.base_reserved, 0);
+    EXPECT_EQ(seller_balance.quote_free, kMax);
+
+    // A debit frees room in the total again.
+    ASSERT_TRUE(ledger.transfer(seller, LedgerAsset::Quote, 50, LedgerTransfer::Debit).has_value());
+    EXPECT_TRUE(ledger.transfer(buyer, LedgerAsset::Quote, 50, LedgerTransfer::Credit).has_value());
+    EXPECT_FALSE(ledger.transfer(buyer, LedgerAsset::Quote, 1, LedgerTransfer::Credit).has_value());
+}
+
+TEST(MarketLedgerTest, HeldDebitIsTakenOrPutBack)
+{
+    MarketLedger ledger;
+    const UserId user{1};
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Base, 10, LedgerTransfer::Credit).has_value());
+
+    EXPECT_EQ(ledger.transfer(user, LedgerAsset::Base, 11, LedgerTransfer::Hold).error(), EngineAsyncError::InsufficientFunds);
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Base, 6, LedgerTransfer::Hold).has_value());
+    EXPECT_EQ(ledger.balance(user).base_free, 4);
+    EXPECT_EQ(ledger.balance(user).base_reserved, 6);
+
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Base, 2, LedgerTransfer::ReleaseHold).has_value());
+    ASSERT_TRUE(ledger.transfer(user, LedgerAsset::Base, 4, LedgerTransfer::DebitHeld).has_value());
+    EXPECT_EQ(ledger.balance(user).base_free, 6);
+    EXPECT_EQ(ledger.balance(user).base_reserved, 0);
+
+    // The debited 4 left the ledger's total as well.
+    constexpr vertex::core::Quantity kMax = std::numeric_limits<vertex::core::Quantity>::max();
+    EXPECT_TRUE(ledger.transfer(UserId{2}, LedgerAsset::Base, kMax - 6, LedgerTransfer::Credit).has_value());
+}
@@ -0,0 +1,100 @@
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "vertex/engine/market_routing_table.hpp"
+
+namespace
+{
+    using vertex::core::Asset;
+    using vertex::core::Market;
+    using vertex::core::MarketId;
+    using vertex::engine::MarketRoutingTable;
+
+    Market market_for(int index)
+    {
+        return Market{Asset{"base" + std::to_string(index)}, Asset{"usdt"}};
+    }
+
+    MarketId id_for(int index)
+    {
+        return MarketId{static_cast<std::uint64_t>(index + 1)};
+    }
+} // namespace
+
+TEST(MarketRoutingTableTest, InsertFindAndRejectDuplicate)
+{
+    MarketRoutingTable table;
+
+    EXPECT_EQ(table.find(market_for(0)), MarketId{});
+    EXPECT_TRUE(table.insert(market_for(0), id_for(0)));
+    EXPECT_FALSE(table.insert(market_for(0), id_for(1)));
+
+    EXPECT_EQ(table.find(market_for(0)), id_for(0));
+    EXPECT_EQ(table.find(market_for(1)), MarketId{});
+    EXPECT_EQ(table.size(), 1u);
+}
+
+TEST(MarketRoutingTableTest, GrowingKeepsEveryMarketReachable)
+{
+    constexpr int kMarkets = 5000;
+    MarketRoutingTable table;
+
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        ASSERT_TRUE(table.insert(market_for(i), id_for(i)));
+    }
+
+    EXPECT_EQ(table.size(), static_cast<std::size_t>(kMarkets));
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        EXPECT_EQ(table.find(market_for(i)), id_for(i));
+    }
+    EXPECT_EQ(table.find(market_for(kMarkets)), MarketId{});
+}
+
+TEST(MarketRoutingTableTest, ReadersNeverSeeWrongIdWhileTableGrows)
+{
+    constexpr int kPreloaded = 32;
+    constexpr int kInserted = 4000;
+    constexpr int kReaders = 4;
+    MarketRoutingTable table;
+
+    for (int i = 0; i < kPreloaded; ++i)
+    {
+        ASSERT_TRUE(table.insert(market_for(i), id_for(i)));
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; ++r)
+    {
+        readers.emplace_back([&, r]()
+                             {
+            int probe = r;
+            while (!done.load(std::memory_order_acquire))
+            {
+                const int index = probe % (kPreloaded + kInserted);
+                MarketId found = table.find(market_for(index));
+                // Preloaded markets must always be found; later ones may be missing but never wrong.
+                if ((index < kPreloaded && found != id_for(index)) || (found != MarketId{} && found != id_for(index)))
+                    wrong.fetch_add(1);
+                probe += 7;
+            } });
+    }
+
+    for (int i = kPreloaded; i < kPreloaded + kInserted; ++i)
+    {
+        ASSERT_TRUE(table.insert(market_for(i), id_for(i)));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(wrong.load(), 0);
+}
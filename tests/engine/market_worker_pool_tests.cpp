@@ -0,0 +1,311 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "vertex/engine/market_dispatcher.hpp"
+#include "vertex/engine/market_worker.hpp"
+#include "vertex/engine/market_worker_pool.hpp"
+
+namespace
+{
+    using vertex::core::Asset;
+    using vertex::core::Market;
+    using vertex::core::MarketId;
+    using vertex::core::OrderId;
+    using vertex::core::Side;
+    using vertex::core::UserId;
+    using vertex::engine::CancelResultEx;
+    using vertex::engine::MarketDispatcher;
+    using vertex::engine::MarketDispatcherConfig;
+    using vertex::engine::MarketWorker;
+    using vertex::engine::MarketWorkerPool;
+    using vertex::engine::MarketWorkerPoolStats;
+    using vertex::engine::OrderRequest;
+    using vertex::engine::PriceResult;
+    using vertex::engine::SubmitResult;
+
+    Market market_for(int index)
+    {
+        return Market{Asset{"base" + std::to_string(index)}, Asset{"usdt"}};
+    }
+
+    // Workers used directly ignore the request's market; only the dispatcher routes on it.
+    MarketId id_for(int index)
+    {
+        return MarketId{static_cast<std::uint64_t>(index + 1)};
+    }
+
+    OrderRequest make_limit_order(
+        MarketId market,
+        OrderId order_id,
+        UserId user_id,
+        Side side,
+        vertex::core::Quantity quantity,
+        vertex::core::Price price)
+    {
+        return vertex::engine::LimitOrderRequest{
+            .id = order_id,
+            .user_id = user_id,
+            .market = market,
+            .side = side,
+            .limit_price = price,
+            .base_quantity = quantity,
+        };
+    }
+
+    // Per-thread counters are bumped after a batch returns, i.e. after its
+    // completions already ran, so wait for them to catch up.
+    MarketWorkerPoolStats wait_for_tasks_run(const MarketWorkerPool &pool, std::uint64_t expected)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (true)
+        {
+            MarketWorkerPoolStats stats = pool.stats();
+            std::uint64_t total = 0;
+            for (const auto &thread : stats.threads)
+                total += thread.tasks_run;
+            if (total >= expected || std::chrono::steady_clock::now() > deadline)
+                return stats;
+            std::this_thread::yield();
+        }
+    }
+} // namespace
+
+TEST(MarketWorkerPoolTest, ManyMarketsRunOnFixedThreadsAndMatch)
+{
+    constexpr int kMarkets = 500;
+    MarketWorkerPool pool{2};
+
+    std::vector<std::unique_ptr<MarketWorker>> workers;
+    workers.reserve(kMarkets);
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        workers.push_back(std::make_unique<MarketWorker>(market_for(i), vertex::engine::MarketWorkerConfig{}, pool));
+    }
+
+    std::mutex threads_mu;
+    std::set<std::thread::id> threads_seen;
+    std::atomic<int> executions{0};
+    std::latch done(kMarkets * 2);
+
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        const MarketId market = id_for(i);
+        auto record = [&](SubmitResult result)
+        {
+            {
+                std::lock_guard lock(threads_mu);
+                threads_seen.insert(std::this_thread::get_id());
+            }
+            if (result)
+                executions.fetch_add(static_cast<int>(result->size()));
+            done.count_down();
+        };
+        workers[i]->submit(make_limit_order(market, OrderId{1}, UserId{1}, Side::Sell, 1, 100), record);
+        workers[i]->submit(make_limit_order(market, OrderId{2}, UserId{2}, Side::Buy, 1, 100), record);
+    }
+
+    done.wait();
+    EXPECT_EQ(executions.load(), kMarkets);
+    EXPECT_LE(threads_seen.size(), pool.thread_count());
+    EXPECT_EQ(threads_seen.count(std::this_thread::get_id()), 0u);
+}
+
+TEST(MarketWorkerPoolTest, PooledWorkerKeepsPerMarketFifoAcrossBatches)
+{
+    constexpr int kOrders = 1000;
+    // Batch of 8 forces the market to be rescheduled many times.
+    MarketWorkerPool pool{3, 8};
+    MarketWorker worker{market_for(0), {}, pool};
+
+    std::vector<int> order;
+    std::latch done(kOrders);
+    for (int i = 0; i < kOrders; ++i)
+    {
+        worker.submit(make_limit_order(id_for(0), OrderId{static_cast<std::uint64_t>(i + 1)}, UserId{1}, Side::Buy, 1, 90), [&, i](SubmitResult)
+                      {
+            order.push_back(i);
+            done.count_down(); });
+    }
+
+    done.wait();
+    ASSERT_EQ(order.size(), static_cast<std::size_t>(kOrders));
+    for (int i = 0; i < kOrders; ++i)
+        EXPECT_EQ(order[i], i);
+}
+
+TEST(MarketWorkerPoolTest, PooledSettlementStagesAreSharedPerPoolThreadAndKeepMarketOrder)
+{
+    constexpr int kMarkets = 200;
+    constexpr int kOrders = 20;
+    // Small batches keep markets rescheduling, and stealing, while they run.
+    MarketWorkerPool pool{2, 4};
+
+    std::vector<std::unique_ptr<MarketWorker>> workers;
+    workers.reserve(kMarkets);
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        workers.push_back(std::make_unique<MarketWorker>(
+            market_for(i), vertex::engine::MarketWorkerConfig{.settlement_stage = true}, pool));
+        EXPECT_TRUE(workers.back()->has_settlement_stage());
+    }
+
+    std::mutex mu;
+    std::set<std::thread::id> stage_threads;
+    std::vector<std::vector<int>> completed(kMarkets);
+
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        for (int k = 0; k < kOrders; ++k)
+        {
+            workers[i]->submit(
+                make_limit_order(id_for(i), OrderId{static_cast<std::uint64_t>(k + 1)}, UserId{1}, Side::Buy, 1, 90),
+                [&, i, k](SubmitResult)
+                {
+                    std::lock_guard lock(mu);
+                    stage_threads.insert(std::this_thread::get_id());
+                    completed[i].push_back(k);
+                });
+        }
+    }
+
+    // Destroying a worker waits for its completions on the shared stage.
+    workers.clear();
+
+    std::lock_guard lock(mu);
+    EXPECT_LE(stage_threads.size(), pool.thread_count());
+    EXPECT_EQ(stage_threads.count(std::this_thread::get_id()), 0u);
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        ASSERT_EQ(completed[i].size(), static_cast<std::size_t>(kOrders));
+        for (int k = 0; k < kOrders; ++k)
+            EXPECT_EQ(completed[i][k], k);
+    }
+}
+
+TEST(MarketWorkerPoolTest, DestroyingPooledWorkerDrainsQueuedTasks)
+{
+    constexpr int kOrders = 200;
+    MarketWorkerPool pool{1, 4};
+    std::atomic<int> completed{0};
+
+    {
+        MarketWorker worker{market_for(0), {}, pool};
+        for (int i = 0; i < kOrders; ++i)
+        {
+            worker.cancel(OrderId{static_cast<std::uint64_t>(i + 1)}, [&](CancelResultEx result)
+                          {
+                if (result)
+                    completed.fetch_add(1); });
+        }
+    }
+
+    EXPECT_EQ(completed.load(), kOrders);
+}
+
+TEST(MarketWorkerPoolTest, PooledDispatcherRoutesToManyMarkets)
+{
+    constexpr int kMarkets = 2000;
+    MarketDispatcher dispatcher{MarketDispatcherConfig{.pool_threads = 2}};
+
+    std::vector<MarketId> ids;
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        const auto id = dispatcher.register_market(market_for(i));
+        ASSERT_TRUE(id.has_value());
+        ids.push_back(*id);
+    }
+
+    std::atomic<int> executions{0};
+    std::latch done(kMarkets * 2);
+    for (int i = 0; i < kMarkets; ++i)
+    {
+        auto record = [&](SubmitResult result)
+        {
+            if (result)
+                executions.fetch_add(static_cast<int>(result->size()));
+            done.count_down();
+        };
+        dispatcher.submit(make_limit_order(ids[i], OrderId{1}, UserId{1}, Side::Sell, 1, 100), record);
+        dispatcher.submit(make_limit_order(ids[i], OrderId{2}, UserId{2}, Side::Buy, 1, 100), record);
+    }
+
+    done.wait();
+    EXPECT_EQ(executions.load(), kMarkets);
+
+    auto best_ask = dispatcher.best_ask(market_for(7)).get();
+    ASSERT_TRUE(best_ask.has_value());
+    EXPECT_FALSE(best_ask->has_value());
+}
+
+TEST(MarketWorkerPoolTest, IdleThreadStealsMarketQueuedBehindBusyThread)
+{
+    MarketWorkerPool pool{2};
+    // Round-robin homes: hot and stuck share thread 0, other is on thread 1.
+    MarketWorker hot{market_for(0), {}, pool};
+    MarketWorker other{market_for(1), {}, pool};
+    MarketWorker stuck{market_for(2), {}, pool};
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::latch hot_running(1);
+    hot.best_bid([&, released](PriceResult)
+                 {
+        hot_running.count_down();
+        released.wait(); });
+    hot_running.wait();
+
+    // Thread 0 is blocked inside hot's batch; only a steal can run this.
+    auto stuck_done = stuck.best_bid();
+    const auto status = stuck_done.wait_for(std::chrono::seconds(5));
+    release.set_value();
+
+    ASSERT_EQ(status, std::future_status::ready);
+    EXPECT_TRUE(stuck_done.get().has_value());
+
+    const auto stats = wait_for_tasks_run(pool, 2);
+    EXPECT_GE(stats.migrations, 1u);
+    ASSERT_EQ(stats.threads.size(), 2u);
+    EXPECT_GE(stats.threads[1].tasks_run, 1u);
+    EXPECT_GT(stats.elapsed_ns, 0u);
+}
+
+TEST(MarketWorkerPoolTest, StatsCountTasksAndBusyTimePerThread)
+{
+    constexpr int kOrders = 400;
+    MarketWorkerPool pool{2, 16, 0};
+    MarketWorker first{market_for(0), {}, pool};
+    MarketWorker second{market_for(1), {}, pool};
+
+    std::latch done(kOrders * 2);
+    for (int i = 0; i < kOrders; ++i)
+    {
+        const OrderId id{static_cast<std::uint64_t>(i + 1)};
+        first.submit(make_limit_order(id_for(0), id, UserId{1}, Side::Buy, 1, 90), [&](SubmitResult)
+                     { done.count_down(); });
+        second.submit(make_limit_order(id_for(1), id, UserId{1}, Side::Buy, 1, 90), [&](SubmitResult)
+                      { done.count_down(); });
+    }
+    done.wait();
+
+    const auto stats = wait_for_tasks_run(pool, kOrders * 2);
+    EXPECT_EQ(stats.migrations, 0u);
+    ASSERT_EQ(stats.threads.size(), 2u);
+    // Stealing disabled: each market stays on its home thread.
+    EXPECT_EQ(stats.threads[0].tasks_run, static_cast<std::uint64_t>(kOrders));
+    EXPECT_EQ(stats.threads[1].tasks_run, static_cast<std::uint64_t>(kOrders));
+    EXPECT_GE(stats.threads[0].batches_run, static_cast<std::uint64_t>(kOrders / 16));
+    EXPECT_GT(stats.threads[0].busy_ns, 0u);
+    EXPECT_EQ(stats.threads[0].arena_upstream_allocations, 0u);
+    EXPECT_EQ(stats.threads[1].arena_upstream_allocations, 0u);
+    EXPECT_LE(stats.threads[0].busy_ns, stats.elapsed_ns);
+}
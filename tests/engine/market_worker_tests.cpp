@@ -1,7 +1,62 @@
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <latch>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "vertex/engine/market_worker.hpp"
 
+namespace
+{
+    std::atomic<std::uint64_t> global_new_calls{0};
+} // namespace
+
+// Counts every global operator new in the test binary; the array and
+// nothrow forms forward to these two. pmr's new_delete_resource uses the
+// aligned one. Only the steady-state window tests read the count.
+void *operator new(std::size_t size)
+{
+    global_new_calls.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    global_new_calls.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
 namespace
 {
     using vertex::core::Asset;
@@ -11,7 +66,14 @@ namespace
     using vertex::core::UserId;
     using vertex::engine::EngineAsyncError;
     using vertex::engine::MarketWorker;
+    using vertex::engine::CancelResultEx;
+    using vertex::engine::MarketWorkerConfig;
     using vertex::engine::OrderRequest;
+    using vertex::engine::PriceResult;
+    using vertex::engine::SubmitResult;
+    using vertex::engine::ExecutionBuffer;
+    using vertex::engine::MarketWorkerPool;
+    using vertex::engine::SubmitIntoResult;
 
     Market btc_usdt()
     {
@@ -28,12 +90,72 @@ namespace
         return vertex::engine::LimitOrderRequest{
             .id = order_id,
             .user_id = user_id,
-            .market = btc_usdt(),
+            .market = vertex::core::MarketId{1},
             .side = side,
             .limit_price = price,
             .base_quantity = quantity,
         };
     }
+
+    // Rests one deep ask, warms up, then counts global operator new calls over
+    // rounds of a taker that partially fills it through submit_into with one
+    // reused buffer. The book keeps its shape, so every round is the same.
+    std::uint64_t global_news_in_steady_state_window(MarketWorker &worker, int rounds)
+    {
+        constexpr int kWarmupRounds = 256;
+        EXPECT_TRUE(worker.submit(make_limit_order(OrderId{1}, UserId{1}, Side::Sell, 1'000'000'000, 100)).get().has_value());
+
+        ExecutionBuffer out;
+        std::atomic<int> completed{0};
+        std::atomic<int> failed{0};
+        std::uint64_t next_id = 2;
+        auto run_rounds = [&](int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const int target = completed.load() + 1;
+                worker.submit_into(make_limit_order(OrderId{next_id++}, UserId{2}, Side::Buy, 3, 100), out,
+                                   [&completed, &failed](SubmitIntoResult result)
+                                   {
+                                       failed.fetch_add(result.has_value() ? 0 : 1);
+                                       completed.fetch_add(1);
+                                       completed.notify_one();
+                                   });
+                for (int seen = completed.load(); seen < target; seen = completed.load())
+                    completed.wait(seen);
+            }
+        };
+
+        run_rounds(kWarmupRounds);
+        const std::uint64_t before = global_new_calls.load();
+        run_rounds(rounds);
+        const std::uint64_t news = global_new_calls.load() - before;
+
+        EXPECT_EQ(failed.load(), 0);
+        EXPECT_EQ(out.size(), 1u);
+        return news;
+    }
+
+    // Records the order in which completions run on the worker thread.
+    class CompletionLog
+    {
+    public:
+        void record(int tag)
+        {
+            std::lock_guard lock(mu_);
+            tags_.push_back(tag);
+        }
+
+        std::vector<int> tags() const
+        {
+            std::lock_guard lock(mu_);
+            return tags_;
+        }
+
+    private:
+        mutable std::mutex mu_;
+        std::vector<int> tags_;
+    };
 } // namespace
 
 TEST(MarketWorkerTest, ProcessesSubmitThenSubmitThenCancelInFIFOOrder)
@@ -104,3 +226,439 @@ TEST(MarketWorkerTest, StopMakesPublicApisReturnWorkerStopped)
     ASSERT_FALSE(best_ask_result.has_value());
     EXPECT_EQ(best_ask_result.error(), EngineAsyncError::WorkerStopped);
 }
+
+TEST(MarketWorkerTest, CallbackSubmitPipelinesManyOrdersFromOneThread)
+{
+    MarketWorker worker{btc_usdt()};
+
+    constexpr int kPairs = 1000;
+    std::latch done(2 * kPairs);
+    std::atomic<int> executions{0};
+    std::atomic<int> failures{0};
+
+    for (int i = 0; i < kPairs; ++i)
+    {
+        const auto sell_id = OrderId{static_cast<std::uint64_t>(2 * i + 1)};
+        const auto buy_id = OrderId{static_cast<std::uint64_t>(2 * i + 2)};
+
+        worker.submit(make_limit_order(sell_id, UserId{1}, Side::Sell, 1, 100), [&](SubmitResult result)
+                      {
+            if (!result)
+                failures.fetch_add(1);
+            done.count_down(); });
+        worker.submit(make_limit_order(buy_id, UserId{2}, Side::Buy, 1, 100), [&](SubmitResult result)
+                      {
+            if (!result)
+                failures.fetch_add(1);
+            else
+                executions.fetch_add(static_cast<int>(result->size()));
+            done.count_down(); });
+    }
+
+    done.wait();
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(executions.load(), kPairs);
+}
+
+TEST(MarketWorkerTest, CallbackRunsOnWorkerThreadInSubmissionOrder)
+{
+    MarketWorker worker{btc_usdt()};
+
+    std::latch done(2);
+    std::thread::id submit_thread{};
+    std::thread::id best_bid_thread{};
+    std::optional<vertex::core::Price> observed_bid;
+
+    worker.submit(make_limit_order(OrderId{1}, UserId{1}, Side::Buy, 1, 99), [&](SubmitResult)
+                  {
+        submit_thread = std::this_thread::get_id();
+        done.count_down(); });
+    worker.best_bid([&](PriceResult result)
+                    {
+        best_bid_thread = std::this_thread::get_id();
+        if (result)
+            observed_bid = *result;
+        done.count_down(); });
+
+    done.wait();
+    EXPECT_NE(submit_thread, std::this_thread::get_id());
+    EXPECT_EQ(submit_thread, best_bid_thread);
+    ASSERT_TRUE(observed_bid.has_value());
+    EXPECT_EQ(*observed_bid, 99);
+}
+
+TEST(MarketWorkerTest, CallbackAfterStopIsInvokedInlineWithWorkerStopped)
+{
+    MarketWorker worker{btc_usdt()};
+    worker.stop();
+
+    bool called = false;
+    worker.submit(make_limit_order(OrderId{1}, UserId{1}, Side::Buy, 1, 100), [&](SubmitResult result)
+                  {
+        called = true;
+        ASSERT_FALSE(result.has_value());
+        EXPECT_EQ(result.error(), EngineAsyncError::WorkerStopped); });
+
+    EXPECT_TRUE(called);
+}
+
+TEST(MarketWorkerTest, BoundedQueueRejectsSubmitWithOverloadedButAcceptsCancel)
+{
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.queue_capacity = 2}};
+
+    // Park the worker thread inside the first completion so queued tasks stay queued.
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::latch worker_parked(1);
+    worker.submit(make_limit_order(OrderId{1}, UserId{1}, Side::Sell, 1, 100), [&, released](SubmitResult)
+                  {
+        worker_parked.count_down();
+        released.wait(); });
+    worker_parked.wait();
+
+    auto second = worker.submit(make_limit_order(OrderId{2}, UserId{1}, Side::Sell, 1, 101));
+    auto third = worker.submit(make_limit_order(OrderId{3}, UserId{1}, Side::Sell, 1, 102));
+
+    bool rejected_inline = false;
+    worker.submit(make_limit_order(OrderId{4}, UserId{1}, Side::Sell, 1, 103), [&](SubmitResult result)
+                  {
+        rejected_inline = true;
+        ASSERT_FALSE(result.has_value());
+        EXPECT_EQ(result.error(), EngineAsyncError::Overloaded); });
+    EXPECT_TRUE(rejected_inline);
+
+    auto cancel = worker.cancel(OrderId{2});
+
+    release.set_value();
+
+    EXPECT_TRUE(second.get().has_value());
+    EXPECT_TRUE(third.get().has_value());
+    auto cancel_result = cancel.get();
+    ASSERT_TRUE(cancel_result.has_value());
+    EXPECT_TRUE(cancel_result->has_value());
+
+    auto best_ask = worker.best_ask().get();
+    ASSERT_TRUE(best_ask.has_value());
+    ASSERT_TRUE(best_ask->has_value());
+    EXPECT_EQ(**best_ask, 100);
+}
+
+TEST(MarketWorkerTest, PriorityLaneRunsCancelAheadOfQueuedSubmits)
+{
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.priority_lane = true}};
+    ASSERT_TRUE(worker.submit(make_limit_order(OrderId{1}, UserId{1}, Side::Sell, 1, 100)).get().has_value());
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::latch worker_parked(1);
+    worker.best_ask([&, released](PriceResult)
+                    {
+        worker_parked.count_down();
+        released.wait(); });
+    worker_parked.wait();
+
+    CompletionLog log;
+    std::latch done(3);
+    // Would hit the resting ask at 100 if it ran before the cancel.
+    worker.submit(make_limit_order(OrderId{2}, UserId{2}, Side::Buy, 1, 100), [&](SubmitResult result)
+                  {
+        EXPECT_TRUE(result.has_value() && result->empty());
+        log.record(2);
+        done.count_down(); });
+    worker.submit(make_limit_order(OrderId{3}, UserId{2}, Side::Buy, 1, 100), [&](SubmitResult)
+                  {
+        log.record(3);
+        done.count_down(); });
+    worker.cancel(OrderId{1}, [&](CancelResultEx result)
+                  {
+        EXPECT_TRUE(result.has_value() && result->has_value());
+        log.record(1);
+        done.count_down(); });
+
+    release.set_value();
+    done.wait();
+
+    EXPECT_EQ(log.tags(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MarketWorkerTest, PriorityLaneBurstLimitLetsNormalLaneProgress)
+{
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.priority_lane = true, .max_priority_burst = 1}};
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::latch worker_parked(1);
+    worker.best_bid([&, released](PriceResult)
+                    {
+        worker_parked.count_down();
+        released.wait(); });
+    worker_parked.wait();
+
+    CompletionLog log;
+    std::latch done(5);
+    for (int i = 0; i < 2; ++i)
+    {
+        worker.submit(make_limit_order(OrderId{static_cast<std::uint64_t>(10 + i)}, UserId{1}, Side::Buy, 1, 90), [&, i](SubmitResult)
+                      {
+            log.record(10 + i);
+            done.count_down(); });
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        worker.cancel(OrderId{static_cast<std::uint64_t>(20 + i)}, [&, i](CancelResultEx)
+                      {
+            log.record(20 + i);
+            done.count_down(); });
+    }
+
+    release.set_value();
+    done.wait();
+
+    EXPECT_EQ(log.tags(), (std::vector<int>{20, 10, 21, 11, 22}));
+}
+
+TEST(MarketWorkerTest, SteadyStateMatchingDoesNotAllocateFromUpstreamArena)
+{
+    constexpr int kPairs = 500;
+    MarketWorker worker{btc_usdt()};
+
+    int executions = 0;
+    for (int i = 0; i < kPairs; ++i)
+    {
+        const auto sell_id = OrderId{static_cast<std::uint64_t>(2 * i + 1)};
+        const auto buy_id = OrderId{static_cast<std::uint64_t>(2 * i + 2)};
+        ASSERT_TRUE(worker.submit(make_limit_order(sell_id, UserId{1}, Side::Sell, 3, 100)).get().has_value());
+        auto matched = worker.submit(make_limit_order(buy_id, UserId{2}, Side::Buy, 3, 100)).get();
+        ASSERT_TRUE(matched.has_value());
+        ASSERT_EQ(matched->size(), 1u);
+        EXPECT_EQ(matched->capacity(), matched->size());
+        executions += static_cast<int>(matched->size());
+    }
+
+    EXPECT_EQ(executions, kPairs);
+    EXPECT_EQ(worker.arena_upstream_allocations(), 0u);
+}
+
+TEST(MarketWorkerTest, SteadyStateSubmitIntoMakesNoGlobalAllocations)
+{
+    // The counter sees allocations at all.
+    const std::uint64_t before = global_new_calls.load();
+    int *volatile probe = new int{0};
+    delete probe;
+    ASSERT_EQ(global_new_calls.load() - before, 1u);
+
+    MarketWorker worker{btc_usdt()};
+
+    EXPECT_EQ(global_news_in_steady_state_window(worker, 2'000), 0u);
+}
+
+TEST(MarketWorkerTest, SteadyStateSubmitIntoOnPoolMakesNoGlobalAllocations)
+{
+    MarketWorkerPool pool{1, MarketWorkerPool::kDefaultBatchSize, 0};
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{}, pool};
+
+    EXPECT_EQ(global_news_in_steady_state_window(worker, 2'000), 0u);
+}
+
+TEST(MarketWorkerTest, SubmitIntoClearsTheBufferAndReportsRejection)
+{
+    MarketWorker worker{btc_usdt()};
+    ASSERT_TRUE(worker.submit(make_limit_order(OrderId{1}, UserId{1}, Side::Sell, 5, 100)).get().has_value());
+
+    ExecutionBuffer out;
+    std::promise<SubmitIntoResult> matched;
+    auto matched_future = matched.get_future();
+    worker.submit_into(make_limit_order(OrderId{2}, UserId{2}, Side::Buy, 2, 100), out,
+                       vertex::engine::complete_promise(std::move(matched)));
+    ASSERT_TRUE(matched_future.get().has_value());
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out.front().quantity, 2);
+    EXPECT_TRUE(out.front().trade_id.is_valid());
+
+    worker.stop();
+    std::promise<SubmitIntoResult> rejected;
+    auto rejected_future = rejected.get_future();
+    worker.submit_into(make_limit_order(OrderId{3}, UserId{2}, Side::Buy, 1, 100), out,
+                       vertex::engine::complete_promise(std::move(rejected)));
+    ASSERT_FALSE(rejected_future.get().has_value());
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(MarketWorkerTest, SweepLargerThanArenaSpillsUpstreamAndStaysCorrect)
+{
+    constexpr int kRestingOrders = 2000;
+    MarketWorker worker{btc_usdt()};
+
+    for (int i = 0; i < kRestingOrders; ++i)
+    {
+        ASSERT_TRUE(worker.submit(make_limit_order(OrderId{static_cast<std::uint64_t>(i + 1)}, UserId{1}, Side::Sell, 1, 100)).get().has_value());
+    }
+
+    auto sweep = worker.submit(make_limit_order(OrderId{100000}, UserId{2}, Side::Buy, kRestingOrders, 100)).get();
+    ASSERT_TRUE(sweep.has_value());
+    ASSERT_EQ(sweep->size(), static_cast<std::size_t>(kRestingOrders));
+    EXPECT_TRUE(sweep->back().buy_fully_filled);
+    EXPECT_GT(worker.arena_upstream_allocations(), 0u);
+}
+
+TEST(MarketWorkerTest, ExecutionsCarryIncreasingTradeIds)
+{
+    MarketWorker worker{btc_usdt()};
+    for (std::uint64_t i = 1; i <= 3; ++i)
+    {
+        ASSERT_TRUE(worker.submit(make_limit_order(OrderId{i}, UserId{1}, Side::Sell, 1, 100)).get().has_value());
+    }
+
+    auto first_sweep = worker.submit(make_limit_order(OrderId{10}, UserId{2}, Side::Buy, 2, 100)).get();
+    auto second_sweep = worker.submit(make_limit_order(OrderId{11}, UserId{2}, Side::Buy, 1, 100)).get();
+
+    ASSERT_TRUE(first_sweep.has_value());
+    ASSERT_TRUE(second_sweep.has_value());
+    ASSERT_EQ(first_sweep->size(), 2u);
+    ASSERT_EQ(second_sweep->size(), 1u);
+    EXPECT_TRUE((*first_sweep)[0].trade_id.is_valid());
+    EXPECT_LT((*first_sweep)[0].trade_id, (*first_sweep)[1].trade_id);
+    EXPECT_LT((*first_sweep)[1].trade_id, (*second_sweep)[0].trade_id);
+}
+
+TEST(MarketWorkerTest, SettlementStageRunsCompletionsInOrderOffTheWorkerThread)
+{
+    constexpr int kOrders = 200;
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.settlement_stage = true}};
+
+    std::mutex mutex;
+    std::vector<int> completed;
+    std::vector<std::thread::id> threads;
+    std::latch done(kOrders);
+
+    for (int i = 0; i < kOrders; ++i)
+    {
+        worker.submit(
+            make_limit_order(OrderId{static_cast<std::uint64_t>(i + 1)}, UserId{1}, Side::Buy, 1, 100),
+            [&, i](SubmitResult result)
+            {
+                EXPECT_TRUE(result.has_value());
+                {
+                    std::lock_guard lock(mutex);
+                    completed.push_back(i);
+                    threads.push_back(std::this_thread::get_id());
+                }
+                done.count_down();
+            });
+    }
+    done.wait();
+
+    ASSERT_EQ(completed.size(), static_cast<std::size_t>(kOrders));
+    for (int i = 0; i < kOrders; ++i)
+        EXPECT_EQ(completed[i], i);
+    for (const auto &thread : threads)
+    {
+        EXPECT_EQ(thread, threads.front());
+        EXPECT_NE(thread, std::this_thread::get_id());
+    }
+    EXPECT_TRUE(worker.has_settlement_stage());
+}
+
+TEST(MarketWorkerTest, SubLedgerReservesAndSettlesOnTheWorker)
+{
+    using vertex::engine::LedgerAsset;
+    using vertex::engine::LedgerTransfer;
+
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.sub_ledger = true}};
+    const UserId buyer{1};
+    const UserId seller{2};
+    ASSERT_TRUE(worker.transfer(buyer, LedgerAsset::Quote, 315, LedgerTransfer::Credit).get().has_value());
+    ASSERT_TRUE(worker.transfer(seller, LedgerAsset::Base, 2, LedgerTransfer::Credit).get().has_value());
+
+    ASSERT_TRUE(worker.submit(make_limit_order(OrderId{1}, seller, Side::Sell, 2, 100)).get().has_value());
+    // 2 fill at 100 and 1 rests at 105; the 5-per-unit improvement is freed.
+    const auto fills = worker.submit(make_limit_order(OrderId{2}, buyer, Side::Buy, 3, 105)).get();
+    ASSERT_TRUE(fills.has_value());
+    ASSERT_EQ(fills->size(), 1u);
+
+    auto buyer_balance = worker.ledger_balance(buyer).get().value();
+    EXPECT_EQ(buyer_balance.quote_free, 10);
+    EXPECT_EQ(buyer_balance.quote_reserved, 105);
+    EXPECT_EQ(buyer_balance.base_free, 2);
+    EXPECT_EQ(worker.ledger_balance(seller).get().value().quote_free, 200);
+
+    const auto underfunded = worker.submit(make_limit_order(OrderId{3}, buyer, Side::Buy, 1, 100)).get();
+    ASSERT_FALSE(underfunded.has_value());
+    EXPECT_EQ(underfunded.error(), EngineAsyncError::InsufficientFunds);
+
+    ASSERT_TRUE(worker.cancel(OrderId{2}).get().value().has_value());
+    buyer_balance = worker.ledger_balance(buyer).get().value();
+    EXPECT_EQ(buyer_balance.quote_free, 115);
+    EXPECT_EQ(buyer_balance.quote_reserved, 0);
+    EXPECT_TRUE(worker.has_sub_ledger());
+
+    MarketWorker plain{btc_usdt()};
+    const auto no_ledger = plain.transfer(buyer, LedgerAsset::Quote, 1, LedgerTransfer::Credit).get();
+    ASSERT_FALSE(no_ledger.has_value());
+    EXPECT_EQ(no_ledger.error(), EngineAsyncError::NoSubLedger);
+}
+
+TEST(MarketWorkerTest, SubmitBatchRunsRequestsInOrderWithPerRequestResults)
+{
+    using vertex::engine::LedgerAsset;
+    using vertex::engine::LedgerTransfer;
+
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.sub_ledger = true}};
+    const UserId buyer{1};
+    const UserId seller{2};
+    ASSERT_TRUE(worker.transfer(buyer, LedgerAsset::Quote, 200, LedgerTransfer::Credit).get().has_value());
+    ASSERT_TRUE(worker.transfer(seller, LedgerAsset::Base, 2, LedgerTransfer::Credit).get().has_value());
+
+    std::vector<OrderRequest> batch;
+    batch.push_back(make_limit_order(OrderId{1}, seller, Side::Sell, 2, 100));
+    batch.push_back(make_limit_order(OrderId{2}, buyer, Side::Buy, 1, 100));
+    // Needs 500 of the 100 quote left; rejected on its own.
+    batch.push_back(make_limit_order(OrderId{3}, buyer, Side::Buy, 5, 100));
+    batch.push_back(make_limit_order(OrderId{4}, buyer, Side::Buy, 1, 100));
+
+    const auto results = worker.submit_batch(std::move(batch)).get();
+    ASSERT_EQ(results.size(), 4u);
+    ASSERT_TRUE(results[0].has_value());
+    EXPECT_TRUE(results[0]->empty());
+    ASSERT_TRUE(results[1].has_value());
+    ASSERT_EQ(results[1]->size(), 1u);
+    EXPECT_EQ((*results[1])[0].sell_order_id, OrderId{1});
+    ASSERT_FALSE(results[2].has_value());
+    EXPECT_EQ(results[2].error(), EngineAsyncError::InsufficientFunds);
+    ASSERT_TRUE(results[3].has_value());
+    ASSERT_EQ(results[3]->size(), 1u);
+    EXPECT_GT((*results[3])[0].trade_id, (*results[1])[0].trade_id);
+
+    EXPECT_EQ(worker.ledger_balance(buyer).get().value().base_free, 2);
+
+    worker.stop();
+    std::vector<OrderRequest> late;
+    late.push_back(make_limit_order(OrderId{5}, seller, Side::Sell, 1, 100));
+    late.push_back(make_limit_order(OrderId{6}, seller, Side::Sell, 1, 101));
+    const auto rejected = worker.submit_batch(std::move(late)).get();
+    ASSERT_EQ(rejected.size(), 2u);
+    for (const SubmitResult &result : rejected)
+    {
+        ASSERT_FALSE(result.has_value());
+        EXPECT_EQ(result.error(), EngineAsyncError::WorkerStopped);
+    }
+}
+
+TEST(MarketWorkerTest, SubLedgerRejectsUnrepresentableNotionalWithoutReserving)
+{
+    using vertex::engine::LedgerAsset;
+    using vertex::engine::LedgerTransfer;
+
+    MarketWorker worker{btc_usdt(), MarketWorkerConfig{.sub_ledger = true}};
+    const UserId buyer{1};
+    ASSERT_TRUE(worker.transfer(buyer, LedgerAsset::Quote, 1000, LedgerTransfer::Credit).get().has_value());
+
+    const vertex::core::Price huge_price = std::numeric_limits<vertex::core::Price>::max() / 2;
+    const auto overflow = worker.submit(make_limit_order(OrderId{1}, buyer, Side::Buy, 4, huge_price)).get();
+    ASSERT_FALSE(overflow.has_value());
+    EXPECT_EQ(overflow.error(), EngineAsyncError::InsufficientFunds);
+
+    const auto balance = worker.ledger_balance(buyer).get().value();
+    EXPECT_EQ(balance.quote_free, 1000);
+    EXPECT_EQ(balance.quote_reserved, 0);
+}
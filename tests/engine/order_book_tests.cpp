@@ -8,13 +8,16 @@ namespace
 {
     using vertex::core::Asset;
     using vertex::core::Market;
+    using vertex::core::MarketSpec;
     using vertex::core::OrderId;
     using vertex::core::Price;
     using vertex::core::Quantity;
     using vertex::core::Side;
     using vertex::engine::Execution;
     using vertex::engine::OrderBook;
-    using vertex::engine::RestingOrder;
+    using vertex::core::MarketId;
+    using vertex::core::UserId;
+    using vertex::engine::LimitOrderRequest;
 
     Market btc_usdt()
     {
@@ -25,18 +28,20 @@ namespace
     {
         Quantity remaining = quantity;
         std::vector<Execution> executions = side == Side::Buy
-                                                ? book.match_limit_buy_against_asks(order_id, price, remaining)
-                                                : book.match_limit_sell_against_bids(order_id, price, remaining);
+                                                ? book.match_limit_buy_against_asks(order_id, UserId{1}, price, remaining)
+                                                : book.match_limit_sell_against_bids(order_id, UserId{1}, price, remaining);
 
         if (remaining > 0)
         {
-            RestingOrder resting{
+            const LimitOrderRequest request{
                 .id = order_id,
+                .user_id = UserId{1},
+                .market = MarketId{1},
+                .side = side,
                 .limit_price = price,
-                .initial_base_quantity = quantity,
-                .remaining_base_quantity = remaining,
+                .base_quantity = quantity,
             };
-            book.insert_resting(side, std::move(resting));
+            book.insert_resting(request, remaining);
         }
 
         return executions;
@@ -44,12 +49,12 @@ namespace
 
     std::vector<Execution> submit_market_buy_by_quote(OrderBook &book, OrderId order_id, Quantity quote_budget)
     {
-        return book.match_market_buy_by_quote_against_asks(order_id, quote_budget);
+        return book.match_market_buy_by_quote_against_asks(order_id, UserId{2}, quote_budget);
     }
 
     std::vector<Execution> submit_market_sell_by_base(OrderBook &book, OrderId order_id, Quantity base_quantity)
     {
-        return book.match_market_sell_by_base_against_bids(order_id, base_quantity);
+        return book.match_market_sell_by_base_against_bids(order_id, UserId{2}, base_quantity);
     }
 }
 
@@ -321,3 +326,94 @@ TEST(OrderBookTest, ExecuteMarketSellConsumesBidsAndUnfilledRemainderIsDropped)
     EXPECT_FALSE(book.best_ask().has_value());
     EXPECT_FALSE(book.cancel(OrderId{96}).has_value());
 }
+
+TEST(OrderBookTest, SpecScaledBookMatchesWholeLotsAndReportsMinimalUnits)
+{
+    OrderBook book{btc_usdt(), MarketSpec{.tick_size = 5, .lot_size = 10}};
+    EXPECT_TRUE(submit_limit_order(book, OrderId{97}, Side::Sell, 30, 105).empty());
+    EXPECT_TRUE(submit_limit_order(book, OrderId{98}, Side::Sell, 20, 110).empty());
+
+    const auto executions = submit_limit_order(book, OrderId{99}, Side::Buy, 40, 110);
+
+    ASSERT_EQ(executions.size(), 2u);
+    EXPECT_EQ(executions[0].execution_price, 105);
+    EXPECT_EQ(executions[0].quantity, 30);
+    EXPECT_EQ(executions[0].buy_order_limit_price, 110);
+    EXPECT_EQ(executions[1].execution_price, 110);
+    EXPECT_EQ(executions[1].quantity, 10);
+    EXPECT_TRUE(executions[1].buy_fully_filled);
+    ASSERT_TRUE(book.best_ask().has_value());
+    EXPECT_EQ(*book.best_ask(), 110);
+
+    // One lot costs 1100; the 50 left over cannot buy a whole lot.
+    const auto market_buy = submit_market_buy_by_quote(book, OrderId{100}, 1'150);
+    ASSERT_EQ(market_buy.size(), 1u);
+    EXPECT_EQ(market_buy[0].quantity, 10);
+    EXPECT_FALSE(market_buy[0].buy_fully_filled);
+    EXPECT_TRUE(market_buy[0].sell_fully_filled);
+    EXPECT_FALSE(book.best_ask().has_value());
+}
+
+TEST(OrderBookTest, CancelInsideLevelKeepsFifoAndReusedSlotStartsFresh)
+{
+    OrderBook book{btc_usdt()};
+    EXPECT_TRUE(submit_limit_order(book, OrderId{101}, Side::Sell, 2, 100).empty());
+    EXPECT_TRUE(submit_limit_order(book, OrderId{102}, Side::Sell, 3, 100).empty());
+    EXPECT_TRUE(submit_limit_order(book, OrderId{103}, Side::Sell, 4, 100).empty());
+
+    ASSERT_TRUE(book.cancel(OrderId{102}).has_value());
+    EXPECT_FALSE(book.find_resting(OrderId{102}).has_value());
+
+    // Takes the slot freed by 102 but queues behind 103.
+    EXPECT_TRUE(submit_limit_order(book, OrderId{104}, Side::Sell, 5, 100).empty());
+    const auto reused = book.find_resting(OrderId{104});
+    ASSERT_TRUE(reused.has_value());
+    EXPECT_EQ(reused->initial_quantity, 5);
+    EXPECT_EQ(reused->remaining_quantity, 5);
+    EXPECT_EQ(reused->sequence, 3u);
+
+    const auto executions = submit_limit_order(book, OrderId{105}, Side::Buy, 11, 100);
+
+    ASSERT_EQ(executions.size(), 3u);
+    EXPECT_EQ(executions[0].sell_order_id, OrderId{101});
+    EXPECT_EQ(executions[1].sell_order_id, OrderId{103});
+    EXPECT_EQ(executions[2].sell_order_id, OrderId{104});
+    EXPECT_EQ(executions[2].quantity, 5);
+    EXPECT_EQ(book.resting_count(), 0u);
+    EXPECT_FALSE(book.best_ask().has_value());
+}
+
+TEST(OrderBookTest, FindRestingReportsColdFieldsAfterPartialFill)
+{
+    OrderBook book{btc_usdt()};
+    EXPECT_TRUE(submit_limit_order(book, OrderId{106}, Side::Buy, 10, 99).empty());
+    EXPECT_EQ(submit_limit_order(book, OrderId{107}, Side::Sell, 4, 99).size(), 1u);
+
+    const auto info = book.find_resting(OrderId{106});
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->owner, UserId{1});
+    EXPECT_EQ(info->side, Side::Buy);
+    EXPECT_EQ(info->limit_price, 99);
+    EXPECT_EQ(info->initial_quantity, 10);
+    EXPECT_EQ(info->remaining_quantity, 6);
+    EXPECT_EQ(info->sequence, 0u);
+    EXPECT_EQ(book.resting_count(), 1u);
+}
+
+TEST(OrderBookTest, ExecutionsCarryBothOwners)
+{
+    OrderBook book{btc_usdt()};
+    book.insert_resting(LimitOrderRequest{.id = OrderId{108}, .user_id = UserId{7}, .market = MarketId{1}, .side = Side::Sell, .limit_price = 100, .base_quantity = 5}, 5);
+    book.insert_resting(LimitOrderRequest{.id = OrderId{109}, .user_id = UserId{8}, .market = MarketId{1}, .side = Side::Buy, .limit_price = 90, .base_quantity = 5}, 5);
+
+    Quantity remaining = 2;
+    const auto limit_buy = book.match_limit_buy_against_asks(OrderId{110}, UserId{9}, 100, remaining);
+    const auto market_sell = book.match_market_sell_by_base_against_bids(OrderId{111}, UserId{10}, 2);
+
+    ASSERT_EQ(limit_buy.size(), 1u);
+    EXPECT_EQ(limit_buy[0].buy_owner, UserId{9});
+    EXPECT_EQ(limit_buy[0].sell_owner, UserId{7});
+    ASSERT_EQ(market_sell.size(), 1u);
+    EXPECT_EQ(market_sell[0].buy_owner, UserId{8});
+    EXPECT_EQ(market_sell[0].sell_owner, UserId{10});
+}